@@ -94,6 +94,7 @@ TARGETS            += $(CONFIG)/bin/libgo.a
 TARGETS            += $(CONFIG)/bin/goahead
 TARGETS            += $(CONFIG)/bin/goahead-test
 TARGETS            += $(CONFIG)/bin/gopass
+TARGETS            += $(CONFIG)/bin/goahead-stat
 
 unexport CDPATH
 
@@ -134,23 +135,30 @@ clean:
 	rm -f "$(CONFIG)/bin/goahead"
 	rm -f "$(CONFIG)/bin/goahead-test"
 	rm -f "$(CONFIG)/bin/gopass"
+	rm -f "$(CONFIG)/bin/goahead-stat"
 	rm -f "$(CONFIG)/obj/estLib.o"
 	rm -f "$(CONFIG)/obj/action.o"
+	rm -f "$(CONFIG)/obj/aio.o"
 	rm -f "$(CONFIG)/obj/alloc.o"
 	rm -f "$(CONFIG)/obj/auth.o"
+	rm -f "$(CONFIG)/obj/cache.o"
 	rm -f "$(CONFIG)/obj/cgi.o"
 	rm -f "$(CONFIG)/obj/crypt.o"
+	rm -f "$(CONFIG)/obj/fiber.o"
 	rm -f "$(CONFIG)/obj/file.o"
 	rm -f "$(CONFIG)/obj/fs.o"
 	rm -f "$(CONFIG)/obj/http.o"
 	rm -f "$(CONFIG)/obj/js.o"
+	rm -f "$(CONFIG)/obj/json.o"
 	rm -f "$(CONFIG)/obj/jst.o"
 	rm -f "$(CONFIG)/obj/options.o"
 	rm -f "$(CONFIG)/obj/osdep.o"
+	rm -f "$(CONFIG)/obj/proxy.o"
 	rm -f "$(CONFIG)/obj/rom-documents.o"
 	rm -f "$(CONFIG)/obj/route.o"
 	rm -f "$(CONFIG)/obj/runtime.o"
 	rm -f "$(CONFIG)/obj/socket.o"
+	rm -f "$(CONFIG)/obj/stats.o"
 	rm -f "$(CONFIG)/obj/upload.o"
 	rm -f "$(CONFIG)/obj/est.o"
 	rm -f "$(CONFIG)/obj/matrixssl.o"
@@ -159,6 +167,7 @@ clean:
 	rm -f "$(CONFIG)/obj/goahead.o"
 	rm -f "$(CONFIG)/obj/test.o"
 	rm -f "$(CONFIG)/obj/gopass.o"
+	rm -f "$(CONFIG)/obj/goahead-stat.o"
 
 clobber: clean
 	rm -fr ./$(CONFIG)
@@ -260,495 +269,665 @@ $(CONFIG)/obj/action.o: \
 	$(CC) -c -o $(CONFIG)/obj/action.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/action.c
 
 #
-#   alloc.o
+#   aio.o
 #
 DEPS_11 += $(CONFIG)/inc/bit.h
 DEPS_11 += $(CONFIG)/inc/goahead.h
+DEPS_11 += $(CONFIG)/inc/bitos.h
+
+$(CONFIG)/obj/aio.o: \
+    src/aio.c $(DEPS_11)
+	@echo '   [Compile] $(CONFIG)/obj/aio.o'
+	$(CC) -c -o $(CONFIG)/obj/aio.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/aio.c
+
+#
+#   alloc.o
+#
+DEPS_12 += $(CONFIG)/inc/bit.h
+DEPS_12 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/alloc.o: \
-    src/alloc.c $(DEPS_11)
+    src/alloc.c $(DEPS_12)
 	@echo '   [Compile] $(CONFIG)/obj/alloc.o'
 	$(CC) -c -o $(CONFIG)/obj/alloc.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/alloc.c
 
 #
 #   auth.o
 #
-DEPS_12 += $(CONFIG)/inc/bit.h
-DEPS_12 += $(CONFIG)/inc/goahead.h
+DEPS_13 += $(CONFIG)/inc/bit.h
+DEPS_13 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/auth.o: \
-    src/auth.c $(DEPS_12)
+    src/auth.c $(DEPS_13)
 	@echo '   [Compile] $(CONFIG)/obj/auth.o'
 	$(CC) -c -o $(CONFIG)/obj/auth.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/auth.c
 
+#
+#   cache.o
+#
+DEPS_14 += $(CONFIG)/inc/bit.h
+DEPS_14 += $(CONFIG)/inc/goahead.h
+
+$(CONFIG)/obj/cache.o: \
+    src/cache.c $(DEPS_14)
+	@echo '   [Compile] $(CONFIG)/obj/cache.o'
+	$(CC) -c -o $(CONFIG)/obj/cache.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/cache.c
+
 #
 #   cgi.o
 #
-DEPS_13 += $(CONFIG)/inc/bit.h
-DEPS_13 += $(CONFIG)/inc/goahead.h
+DEPS_15 += $(CONFIG)/inc/bit.h
+DEPS_15 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/cgi.o: \
-    src/cgi.c $(DEPS_13)
+    src/cgi.c $(DEPS_15)
 	@echo '   [Compile] $(CONFIG)/obj/cgi.o'
 	$(CC) -c -o $(CONFIG)/obj/cgi.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/cgi.c
 
 #
 #   crypt.o
 #
-DEPS_14 += $(CONFIG)/inc/bit.h
-DEPS_14 += $(CONFIG)/inc/goahead.h
+DEPS_16 += $(CONFIG)/inc/bit.h
+DEPS_16 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/crypt.o: \
-    src/crypt.c $(DEPS_14)
+    src/crypt.c $(DEPS_16)
 	@echo '   [Compile] $(CONFIG)/obj/crypt.o'
 	$(CC) -c -o $(CONFIG)/obj/crypt.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/crypt.c
 
+#
+#   fiber.o
+#
+DEPS_17 += $(CONFIG)/inc/bit.h
+DEPS_17 += $(CONFIG)/inc/goahead.h
+
+$(CONFIG)/obj/fiber.o: \
+    src/fiber.c $(DEPS_17)
+	@echo '   [Compile] $(CONFIG)/obj/fiber.o'
+	$(CC) -c -o $(CONFIG)/obj/fiber.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/fiber.c
+
 #
 #   file.o
 #
-DEPS_15 += $(CONFIG)/inc/bit.h
-DEPS_15 += $(CONFIG)/inc/goahead.h
+DEPS_18 += $(CONFIG)/inc/bit.h
+DEPS_18 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/file.o: \
-    src/file.c $(DEPS_15)
+    src/file.c $(DEPS_18)
 	@echo '   [Compile] $(CONFIG)/obj/file.o'
 	$(CC) -c -o $(CONFIG)/obj/file.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/file.c
 
 #
 #   fs.o
 #
-DEPS_16 += $(CONFIG)/inc/bit.h
-DEPS_16 += $(CONFIG)/inc/goahead.h
+DEPS_19 += $(CONFIG)/inc/bit.h
+DEPS_19 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/fs.o: \
-    src/fs.c $(DEPS_16)
+    src/fs.c $(DEPS_19)
 	@echo '   [Compile] $(CONFIG)/obj/fs.o'
 	$(CC) -c -o $(CONFIG)/obj/fs.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/fs.c
 
 #
 #   http.o
 #
-DEPS_17 += $(CONFIG)/inc/bit.h
-DEPS_17 += $(CONFIG)/inc/goahead.h
+DEPS_20 += $(CONFIG)/inc/bit.h
+DEPS_20 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/http.o: \
-    src/http.c $(DEPS_17)
+    src/http.c $(DEPS_20)
 	@echo '   [Compile] $(CONFIG)/obj/http.o'
 	$(CC) -c -o $(CONFIG)/obj/http.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/http.c
 
 #
 #   js.o
 #
-DEPS_18 += $(CONFIG)/inc/bit.h
-DEPS_18 += $(CONFIG)/inc/js.h
-DEPS_18 += $(CONFIG)/inc/goahead.h
+DEPS_21 += $(CONFIG)/inc/bit.h
+DEPS_21 += $(CONFIG)/inc/js.h
+DEPS_21 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/js.o: \
-    src/js.c $(DEPS_18)
+    src/js.c $(DEPS_21)
 	@echo '   [Compile] $(CONFIG)/obj/js.o'
 	$(CC) -c -o $(CONFIG)/obj/js.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/js.c
 
+#
+#   json.o
+#
+DEPS_22 += $(CONFIG)/inc/bit.h
+DEPS_22 += $(CONFIG)/inc/goahead.h
+
+$(CONFIG)/obj/json.o: \
+    src/json.c $(DEPS_22)
+	@echo '   [Compile] $(CONFIG)/obj/json.o'
+	$(CC) -c -o $(CONFIG)/obj/json.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/json.c
+
 #
 #   jst.o
 #
-DEPS_19 += $(CONFIG)/inc/bit.h
-DEPS_19 += $(CONFIG)/inc/goahead.h
-DEPS_19 += $(CONFIG)/inc/js.h
+DEPS_23 += $(CONFIG)/inc/bit.h
+DEPS_23 += $(CONFIG)/inc/goahead.h
+DEPS_23 += $(CONFIG)/inc/js.h
 
 $(CONFIG)/obj/jst.o: \
-    src/jst.c $(DEPS_19)
+    src/jst.c $(DEPS_23)
 	@echo '   [Compile] $(CONFIG)/obj/jst.o'
 	$(CC) -c -o $(CONFIG)/obj/jst.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/jst.c
 
 #
 #   options.o
 #
-DEPS_20 += $(CONFIG)/inc/bit.h
-DEPS_20 += $(CONFIG)/inc/goahead.h
+DEPS_24 += $(CONFIG)/inc/bit.h
+DEPS_24 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/options.o: \
-    src/options.c $(DEPS_20)
+    src/options.c $(DEPS_24)
 	@echo '   [Compile] $(CONFIG)/obj/options.o'
 	$(CC) -c -o $(CONFIG)/obj/options.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/options.c
 
 #
 #   osdep.o
 #
-DEPS_21 += $(CONFIG)/inc/bit.h
-DEPS_21 += $(CONFIG)/inc/goahead.h
+DEPS_25 += $(CONFIG)/inc/bit.h
+DEPS_25 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/osdep.o: \
-    src/osdep.c $(DEPS_21)
+    src/osdep.c $(DEPS_25)
 	@echo '   [Compile] $(CONFIG)/obj/osdep.o'
 	$(CC) -c -o $(CONFIG)/obj/osdep.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/osdep.c
 
+#
+#   proxy.o
+#
+DEPS_26 += $(CONFIG)/inc/bit.h
+DEPS_26 += $(CONFIG)/inc/goahead.h
+
+$(CONFIG)/obj/proxy.o: \
+    src/proxy.c $(DEPS_26)
+	@echo '   [Compile] $(CONFIG)/obj/proxy.o'
+	$(CC) -c -o $(CONFIG)/obj/proxy.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/proxy.c
+
 #
 #   rom-documents.o
 #
-DEPS_22 += $(CONFIG)/inc/bit.h
-DEPS_22 += $(CONFIG)/inc/goahead.h
+DEPS_27 += $(CONFIG)/inc/bit.h
+DEPS_27 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/rom-documents.o: \
-    src/rom-documents.c $(DEPS_22)
+    src/rom-documents.c $(DEPS_27)
 	@echo '   [Compile] $(CONFIG)/obj/rom-documents.o'
 	$(CC) -c -o $(CONFIG)/obj/rom-documents.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/rom-documents.c
 
 #
 #   route.o
 #
-DEPS_23 += $(CONFIG)/inc/bit.h
-DEPS_23 += $(CONFIG)/inc/goahead.h
+DEPS_28 += $(CONFIG)/inc/bit.h
+DEPS_28 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/route.o: \
-    src/route.c $(DEPS_23)
+    src/route.c $(DEPS_28)
 	@echo '   [Compile] $(CONFIG)/obj/route.o'
 	$(CC) -c -o $(CONFIG)/obj/route.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/route.c
 
 #
 #   runtime.o
 #
-DEPS_24 += $(CONFIG)/inc/bit.h
-DEPS_24 += $(CONFIG)/inc/goahead.h
+DEPS_29 += $(CONFIG)/inc/bit.h
+DEPS_29 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/runtime.o: \
-    src/runtime.c $(DEPS_24)
+    src/runtime.c $(DEPS_29)
 	@echo '   [Compile] $(CONFIG)/obj/runtime.o'
 	$(CC) -c -o $(CONFIG)/obj/runtime.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/runtime.c
 
 #
 #   socket.o
 #
-DEPS_25 += $(CONFIG)/inc/bit.h
-DEPS_25 += $(CONFIG)/inc/goahead.h
+DEPS_30 += $(CONFIG)/inc/bit.h
+DEPS_30 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/socket.o: \
-    src/socket.c $(DEPS_25)
+    src/socket.c $(DEPS_30)
 	@echo '   [Compile] $(CONFIG)/obj/socket.o'
 	$(CC) -c -o $(CONFIG)/obj/socket.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/socket.c
 
+#
+#   stats.o
+#
+DEPS_31 += $(CONFIG)/inc/bit.h
+DEPS_31 += $(CONFIG)/inc/goahead.h
+
+$(CONFIG)/obj/stats.o: \
+    src/stats.c $(DEPS_31)
+	@echo '   [Compile] $(CONFIG)/obj/stats.o'
+	$(CC) -c -o $(CONFIG)/obj/stats.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/stats.c
+
 #
 #   upload.o
 #
-DEPS_26 += $(CONFIG)/inc/bit.h
-DEPS_26 += $(CONFIG)/inc/goahead.h
+DEPS_32 += $(CONFIG)/inc/bit.h
+DEPS_32 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/upload.o: \
-    src/upload.c $(DEPS_26)
+    src/upload.c $(DEPS_32)
 	@echo '   [Compile] $(CONFIG)/obj/upload.o'
 	$(CC) -c -o $(CONFIG)/obj/upload.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/upload.c
 
 #
 #   est.o
 #
-DEPS_27 += $(CONFIG)/inc/bit.h
-DEPS_27 += $(CONFIG)/inc/goahead.h
-DEPS_27 += $(CONFIG)/inc/est.h
+DEPS_33 += $(CONFIG)/inc/bit.h
+DEPS_33 += $(CONFIG)/inc/goahead.h
+DEPS_33 += $(CONFIG)/inc/est.h
 
 $(CONFIG)/obj/est.o: \
-    src/ssl/est.c $(DEPS_27)
+    src/ssl/est.c $(DEPS_33)
 	@echo '   [Compile] $(CONFIG)/obj/est.o'
 	$(CC) -c -o $(CONFIG)/obj/est.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/ssl/est.c
 
 #
 #   matrixssl.o
 #
-DEPS_28 += $(CONFIG)/inc/bit.h
-DEPS_28 += $(CONFIG)/inc/goahead.h
+DEPS_34 += $(CONFIG)/inc/bit.h
+DEPS_34 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/matrixssl.o: \
-    src/ssl/matrixssl.c $(DEPS_28)
+    src/ssl/matrixssl.c $(DEPS_34)
 	@echo '   [Compile] $(CONFIG)/obj/matrixssl.o'
 	$(CC) -c -o $(CONFIG)/obj/matrixssl.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/ssl/matrixssl.c
 
 #
 #   nanossl.o
 #
-DEPS_29 += $(CONFIG)/inc/bit.h
+DEPS_35 += $(CONFIG)/inc/bit.h
 
 $(CONFIG)/obj/nanossl.o: \
-    src/ssl/nanossl.c $(DEPS_29)
+    src/ssl/nanossl.c $(DEPS_35)
 	@echo '   [Compile] $(CONFIG)/obj/nanossl.o'
 	$(CC) -c -o $(CONFIG)/obj/nanossl.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/ssl/nanossl.c
 
 #
 #   openssl.o
 #
-DEPS_30 += $(CONFIG)/inc/bit.h
-DEPS_30 += $(CONFIG)/inc/bitos.h
-DEPS_30 += $(CONFIG)/inc/goahead.h
+DEPS_36 += $(CONFIG)/inc/bit.h
+DEPS_36 += $(CONFIG)/inc/bitos.h
+DEPS_36 += $(CONFIG)/inc/goahead.h
 
 $(CONFIG)/obj/openssl.o: \
-    src/ssl/openssl.c $(DEPS_30)
+    src/ssl/openssl.c $(DEPS_36)
 	@echo '   [Compile] $(CONFIG)/obj/openssl.o'
 	$(CC) -c -o $(CONFIG)/obj/openssl.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/ssl/openssl.c
 
 #
 #   libgo
 #
-DEPS_31 += $(CONFIG)/inc/est.h
-DEPS_31 += $(CONFIG)/inc/bit.h
-DEPS_31 += $(CONFIG)/inc/bitos.h
-DEPS_31 += $(CONFIG)/obj/estLib.o
+DEPS_37 += $(CONFIG)/inc/est.h
+DEPS_37 += $(CONFIG)/inc/bit.h
+DEPS_37 += $(CONFIG)/inc/bitos.h
+DEPS_37 += $(CONFIG)/obj/estLib.o
 ifeq ($(BIT_PACK_EST),1)
-    DEPS_31 += $(CONFIG)/bin/libest.a
+    DEPS_37 += $(CONFIG)/bin/libest.a
 endif
-DEPS_31 += $(CONFIG)/inc/goahead.h
-DEPS_31 += $(CONFIG)/inc/js.h
-DEPS_31 += $(CONFIG)/obj/action.o
-DEPS_31 += $(CONFIG)/obj/alloc.o
-DEPS_31 += $(CONFIG)/obj/auth.o
-DEPS_31 += $(CONFIG)/obj/cgi.o
-DEPS_31 += $(CONFIG)/obj/crypt.o
-DEPS_31 += $(CONFIG)/obj/file.o
-DEPS_31 += $(CONFIG)/obj/fs.o
-DEPS_31 += $(CONFIG)/obj/http.o
-DEPS_31 += $(CONFIG)/obj/js.o
-DEPS_31 += $(CONFIG)/obj/jst.o
-DEPS_31 += $(CONFIG)/obj/options.o
-DEPS_31 += $(CONFIG)/obj/osdep.o
-DEPS_31 += $(CONFIG)/obj/rom-documents.o
-DEPS_31 += $(CONFIG)/obj/route.o
-DEPS_31 += $(CONFIG)/obj/runtime.o
-DEPS_31 += $(CONFIG)/obj/socket.o
-DEPS_31 += $(CONFIG)/obj/upload.o
-DEPS_31 += $(CONFIG)/obj/est.o
-DEPS_31 += $(CONFIG)/obj/matrixssl.o
-DEPS_31 += $(CONFIG)/obj/nanossl.o
-DEPS_31 += $(CONFIG)/obj/openssl.o
-
-$(CONFIG)/bin/libgo.a: $(DEPS_31)
+DEPS_37 += $(CONFIG)/inc/goahead.h
+DEPS_37 += $(CONFIG)/inc/js.h
+DEPS_37 += $(CONFIG)/obj/action.o
+DEPS_37 += $(CONFIG)/obj/aio.o
+DEPS_37 += $(CONFIG)/obj/alloc.o
+DEPS_37 += $(CONFIG)/obj/auth.o
+DEPS_37 += $(CONFIG)/obj/cache.o
+DEPS_37 += $(CONFIG)/obj/cgi.o
+DEPS_37 += $(CONFIG)/obj/crypt.o
+DEPS_37 += $(CONFIG)/obj/fiber.o
+DEPS_37 += $(CONFIG)/obj/file.o
+DEPS_37 += $(CONFIG)/obj/fs.o
+DEPS_37 += $(CONFIG)/obj/http.o
+DEPS_37 += $(CONFIG)/obj/js.o
+DEPS_37 += $(CONFIG)/obj/json.o
+DEPS_37 += $(CONFIG)/obj/jst.o
+DEPS_37 += $(CONFIG)/obj/options.o
+DEPS_37 += $(CONFIG)/obj/osdep.o
+DEPS_37 += $(CONFIG)/obj/proxy.o
+DEPS_37 += $(CONFIG)/obj/rom-documents.o
+DEPS_37 += $(CONFIG)/obj/route.o
+DEPS_37 += $(CONFIG)/obj/runtime.o
+DEPS_37 += $(CONFIG)/obj/socket.o
+DEPS_37 += $(CONFIG)/obj/stats.o
+DEPS_37 += $(CONFIG)/obj/upload.o
+DEPS_37 += $(CONFIG)/obj/est.o
+DEPS_37 += $(CONFIG)/obj/matrixssl.o
+DEPS_37 += $(CONFIG)/obj/nanossl.o
+DEPS_37 += $(CONFIG)/obj/openssl.o
+
+$(CONFIG)/bin/libgo.a: $(DEPS_37)
 	@echo '      [Link] $(CONFIG)/bin/libgo.a'
-	ar -cr $(CONFIG)/bin/libgo.a "$(CONFIG)/obj/action.o" "$(CONFIG)/obj/alloc.o" "$(CONFIG)/obj/auth.o" "$(CONFIG)/obj/cgi.o" "$(CONFIG)/obj/crypt.o" "$(CONFIG)/obj/file.o" "$(CONFIG)/obj/fs.o" "$(CONFIG)/obj/http.o" "$(CONFIG)/obj/js.o" "$(CONFIG)/obj/jst.o" "$(CONFIG)/obj/options.o" "$(CONFIG)/obj/osdep.o" "$(CONFIG)/obj/rom-documents.o" "$(CONFIG)/obj/route.o" "$(CONFIG)/obj/runtime.o" "$(CONFIG)/obj/socket.o" "$(CONFIG)/obj/upload.o" "$(CONFIG)/obj/est.o" "$(CONFIG)/obj/matrixssl.o" "$(CONFIG)/obj/nanossl.o" "$(CONFIG)/obj/openssl.o"
+	ar -cr $(CONFIG)/bin/libgo.a "$(CONFIG)/obj/action.o" "$(CONFIG)/obj/aio.o" "$(CONFIG)/obj/alloc.o" "$(CONFIG)/obj/auth.o" "$(CONFIG)/obj/cache.o" "$(CONFIG)/obj/cgi.o" "$(CONFIG)/obj/crypt.o" "$(CONFIG)/obj/fiber.o" "$(CONFIG)/obj/file.o" "$(CONFIG)/obj/fs.o" "$(CONFIG)/obj/http.o" "$(CONFIG)/obj/js.o" "$(CONFIG)/obj/json.o" "$(CONFIG)/obj/jst.o" "$(CONFIG)/obj/options.o" "$(CONFIG)/obj/osdep.o" "$(CONFIG)/obj/proxy.o" "$(CONFIG)/obj/rom-documents.o" "$(CONFIG)/obj/route.o" "$(CONFIG)/obj/runtime.o" "$(CONFIG)/obj/socket.o" "$(CONFIG)/obj/stats.o" "$(CONFIG)/obj/upload.o" "$(CONFIG)/obj/est.o" "$(CONFIG)/obj/matrixssl.o" "$(CONFIG)/obj/nanossl.o" "$(CONFIG)/obj/openssl.o"
 
 #
 #   goahead.o
 #
-DEPS_32 += $(CONFIG)/inc/bit.h
-DEPS_32 += $(CONFIG)/inc/goahead.h
-DEPS_32 += $(CONFIG)/inc/bitos.h
+DEPS_38 += $(CONFIG)/inc/bit.h
+DEPS_38 += $(CONFIG)/inc/goahead.h
+DEPS_38 += $(CONFIG)/inc/bitos.h
 
 $(CONFIG)/obj/goahead.o: \
-    src/goahead.c $(DEPS_32)
+    src/goahead.c $(DEPS_38)
 	@echo '   [Compile] $(CONFIG)/obj/goahead.o'
 	$(CC) -c -o $(CONFIG)/obj/goahead.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/goahead.c
 
 #
 #   goahead
 #
-DEPS_33 += $(CONFIG)/inc/est.h
-DEPS_33 += $(CONFIG)/inc/bit.h
-DEPS_33 += $(CONFIG)/inc/bitos.h
-DEPS_33 += $(CONFIG)/obj/estLib.o
+DEPS_39 += $(CONFIG)/inc/est.h
+DEPS_39 += $(CONFIG)/inc/bit.h
+DEPS_39 += $(CONFIG)/inc/bitos.h
+DEPS_39 += $(CONFIG)/obj/estLib.o
 ifeq ($(BIT_PACK_EST),1)
-    DEPS_33 += $(CONFIG)/bin/libest.a
+    DEPS_39 += $(CONFIG)/bin/libest.a
 endif
-DEPS_33 += $(CONFIG)/inc/goahead.h
-DEPS_33 += $(CONFIG)/inc/js.h
-DEPS_33 += $(CONFIG)/obj/action.o
-DEPS_33 += $(CONFIG)/obj/alloc.o
-DEPS_33 += $(CONFIG)/obj/auth.o
-DEPS_33 += $(CONFIG)/obj/cgi.o
-DEPS_33 += $(CONFIG)/obj/crypt.o
-DEPS_33 += $(CONFIG)/obj/file.o
-DEPS_33 += $(CONFIG)/obj/fs.o
-DEPS_33 += $(CONFIG)/obj/http.o
-DEPS_33 += $(CONFIG)/obj/js.o
-DEPS_33 += $(CONFIG)/obj/jst.o
-DEPS_33 += $(CONFIG)/obj/options.o
-DEPS_33 += $(CONFIG)/obj/osdep.o
-DEPS_33 += $(CONFIG)/obj/rom-documents.o
-DEPS_33 += $(CONFIG)/obj/route.o
-DEPS_33 += $(CONFIG)/obj/runtime.o
-DEPS_33 += $(CONFIG)/obj/socket.o
-DEPS_33 += $(CONFIG)/obj/upload.o
-DEPS_33 += $(CONFIG)/obj/est.o
-DEPS_33 += $(CONFIG)/obj/matrixssl.o
-DEPS_33 += $(CONFIG)/obj/nanossl.o
-DEPS_33 += $(CONFIG)/obj/openssl.o
-DEPS_33 += $(CONFIG)/bin/libgo.a
-DEPS_33 += $(CONFIG)/obj/goahead.o
-
-LIBS_33 += -lgo
+DEPS_39 += $(CONFIG)/inc/goahead.h
+DEPS_39 += $(CONFIG)/inc/js.h
+DEPS_39 += $(CONFIG)/obj/action.o
+DEPS_39 += $(CONFIG)/obj/aio.o
+DEPS_39 += $(CONFIG)/obj/alloc.o
+DEPS_39 += $(CONFIG)/obj/auth.o
+DEPS_39 += $(CONFIG)/obj/cache.o
+DEPS_39 += $(CONFIG)/obj/cgi.o
+DEPS_39 += $(CONFIG)/obj/crypt.o
+DEPS_39 += $(CONFIG)/obj/fiber.o
+DEPS_39 += $(CONFIG)/obj/file.o
+DEPS_39 += $(CONFIG)/obj/fs.o
+DEPS_39 += $(CONFIG)/obj/http.o
+DEPS_39 += $(CONFIG)/obj/js.o
+DEPS_39 += $(CONFIG)/obj/json.o
+DEPS_39 += $(CONFIG)/obj/jst.o
+DEPS_39 += $(CONFIG)/obj/options.o
+DEPS_39 += $(CONFIG)/obj/osdep.o
+DEPS_39 += $(CONFIG)/obj/proxy.o
+DEPS_39 += $(CONFIG)/obj/rom-documents.o
+DEPS_39 += $(CONFIG)/obj/route.o
+DEPS_39 += $(CONFIG)/obj/runtime.o
+DEPS_39 += $(CONFIG)/obj/socket.o
+DEPS_39 += $(CONFIG)/obj/stats.o
+DEPS_39 += $(CONFIG)/obj/upload.o
+DEPS_39 += $(CONFIG)/obj/est.o
+DEPS_39 += $(CONFIG)/obj/matrixssl.o
+DEPS_39 += $(CONFIG)/obj/nanossl.o
+DEPS_39 += $(CONFIG)/obj/openssl.o
+DEPS_39 += $(CONFIG)/bin/libgo.a
+DEPS_39 += $(CONFIG)/obj/goahead.o
+
+LIBS_39 += -lgo
 ifeq ($(BIT_PACK_EST),1)
-    LIBS_33 += -lest
+    LIBS_39 += -lest
 endif
 ifeq ($(BIT_PACK_MATRIXSSL),1)
-    LIBS_33 += -lmatrixssl
-    LIBPATHS_33 += -L$(BIT_PACK_MATRIXSSL_PATH)
+    LIBS_39 += -lmatrixssl
+    LIBPATHS_39 += -L$(BIT_PACK_MATRIXSSL_PATH)
 endif
 ifeq ($(BIT_PACK_NANOSSL),1)
-    LIBS_33 += -lssls
-    LIBPATHS_33 += -L$(BIT_PACK_NANOSSL_PATH)/bin
+    LIBS_39 += -lssls
+    LIBPATHS_39 += -L$(BIT_PACK_NANOSSL_PATH)/bin
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_33 += -lssl
-    LIBPATHS_33 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_39 += -lssl
+    LIBPATHS_39 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_33 += -lcrypto
-    LIBPATHS_33 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_39 += -lcrypto
+    LIBPATHS_39 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 
-$(CONFIG)/bin/goahead: $(DEPS_33)
+$(CONFIG)/bin/goahead: $(DEPS_39)
 	@echo '      [Link] $(CONFIG)/bin/goahead'
-	$(CC) -o $(CONFIG)/bin/goahead $(LIBPATHS)    "$(CONFIG)/obj/goahead.o" $(LIBPATHS_33) $(LIBS_33) $(LIBS_33) $(LIBS) $(LIBS) 
+	$(CC) -o $(CONFIG)/bin/goahead $(LIBPATHS)    "$(CONFIG)/obj/goahead.o" $(LIBPATHS_39) $(LIBS_39) $(LIBS_39) $(LIBS) $(LIBS) 
 
 #
 #   test.o
 #
-DEPS_34 += $(CONFIG)/inc/bit.h
-DEPS_34 += $(CONFIG)/inc/goahead.h
-DEPS_34 += $(CONFIG)/inc/js.h
-DEPS_34 += $(CONFIG)/inc/bitos.h
+DEPS_40 += $(CONFIG)/inc/bit.h
+DEPS_40 += $(CONFIG)/inc/goahead.h
+DEPS_40 += $(CONFIG)/inc/js.h
+DEPS_40 += $(CONFIG)/inc/bitos.h
 
 $(CONFIG)/obj/test.o: \
-    test/test.c $(DEPS_34)
+    test/test.c $(DEPS_40)
 	@echo '   [Compile] $(CONFIG)/obj/test.o'
 	$(CC) -c -o $(CONFIG)/obj/test.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" test/test.c
 
 #
 #   goahead-test
 #
-DEPS_35 += $(CONFIG)/inc/est.h
-DEPS_35 += $(CONFIG)/inc/bit.h
-DEPS_35 += $(CONFIG)/inc/bitos.h
-DEPS_35 += $(CONFIG)/obj/estLib.o
+DEPS_41 += $(CONFIG)/inc/est.h
+DEPS_41 += $(CONFIG)/inc/bit.h
+DEPS_41 += $(CONFIG)/inc/bitos.h
+DEPS_41 += $(CONFIG)/obj/estLib.o
 ifeq ($(BIT_PACK_EST),1)
-    DEPS_35 += $(CONFIG)/bin/libest.a
-endif
-DEPS_35 += $(CONFIG)/inc/goahead.h
-DEPS_35 += $(CONFIG)/inc/js.h
-DEPS_35 += $(CONFIG)/obj/action.o
-DEPS_35 += $(CONFIG)/obj/alloc.o
-DEPS_35 += $(CONFIG)/obj/auth.o
-DEPS_35 += $(CONFIG)/obj/cgi.o
-DEPS_35 += $(CONFIG)/obj/crypt.o
-DEPS_35 += $(CONFIG)/obj/file.o
-DEPS_35 += $(CONFIG)/obj/fs.o
-DEPS_35 += $(CONFIG)/obj/http.o
-DEPS_35 += $(CONFIG)/obj/js.o
-DEPS_35 += $(CONFIG)/obj/jst.o
-DEPS_35 += $(CONFIG)/obj/options.o
-DEPS_35 += $(CONFIG)/obj/osdep.o
-DEPS_35 += $(CONFIG)/obj/rom-documents.o
-DEPS_35 += $(CONFIG)/obj/route.o
-DEPS_35 += $(CONFIG)/obj/runtime.o
-DEPS_35 += $(CONFIG)/obj/socket.o
-DEPS_35 += $(CONFIG)/obj/upload.o
-DEPS_35 += $(CONFIG)/obj/est.o
-DEPS_35 += $(CONFIG)/obj/matrixssl.o
-DEPS_35 += $(CONFIG)/obj/nanossl.o
-DEPS_35 += $(CONFIG)/obj/openssl.o
-DEPS_35 += $(CONFIG)/bin/libgo.a
-DEPS_35 += $(CONFIG)/obj/test.o
-
-LIBS_35 += -lgo
+    DEPS_41 += $(CONFIG)/bin/libest.a
+endif
+DEPS_41 += $(CONFIG)/inc/goahead.h
+DEPS_41 += $(CONFIG)/inc/js.h
+DEPS_41 += $(CONFIG)/obj/action.o
+DEPS_41 += $(CONFIG)/obj/aio.o
+DEPS_41 += $(CONFIG)/obj/alloc.o
+DEPS_41 += $(CONFIG)/obj/auth.o
+DEPS_41 += $(CONFIG)/obj/cache.o
+DEPS_41 += $(CONFIG)/obj/cgi.o
+DEPS_41 += $(CONFIG)/obj/crypt.o
+DEPS_41 += $(CONFIG)/obj/fiber.o
+DEPS_41 += $(CONFIG)/obj/file.o
+DEPS_41 += $(CONFIG)/obj/fs.o
+DEPS_41 += $(CONFIG)/obj/http.o
+DEPS_41 += $(CONFIG)/obj/js.o
+DEPS_41 += $(CONFIG)/obj/json.o
+DEPS_41 += $(CONFIG)/obj/jst.o
+DEPS_41 += $(CONFIG)/obj/options.o
+DEPS_41 += $(CONFIG)/obj/osdep.o
+DEPS_41 += $(CONFIG)/obj/proxy.o
+DEPS_41 += $(CONFIG)/obj/rom-documents.o
+DEPS_41 += $(CONFIG)/obj/route.o
+DEPS_41 += $(CONFIG)/obj/runtime.o
+DEPS_41 += $(CONFIG)/obj/socket.o
+DEPS_41 += $(CONFIG)/obj/stats.o
+DEPS_41 += $(CONFIG)/obj/upload.o
+DEPS_41 += $(CONFIG)/obj/est.o
+DEPS_41 += $(CONFIG)/obj/matrixssl.o
+DEPS_41 += $(CONFIG)/obj/nanossl.o
+DEPS_41 += $(CONFIG)/obj/openssl.o
+DEPS_41 += $(CONFIG)/bin/libgo.a
+DEPS_41 += $(CONFIG)/obj/test.o
+
+LIBS_41 += -lgo
 ifeq ($(BIT_PACK_EST),1)
-    LIBS_35 += -lest
+    LIBS_41 += -lest
 endif
 ifeq ($(BIT_PACK_MATRIXSSL),1)
-    LIBS_35 += -lmatrixssl
-    LIBPATHS_35 += -L$(BIT_PACK_MATRIXSSL_PATH)
+    LIBS_41 += -lmatrixssl
+    LIBPATHS_41 += -L$(BIT_PACK_MATRIXSSL_PATH)
 endif
 ifeq ($(BIT_PACK_NANOSSL),1)
-    LIBS_35 += -lssls
-    LIBPATHS_35 += -L$(BIT_PACK_NANOSSL_PATH)/bin
+    LIBS_41 += -lssls
+    LIBPATHS_41 += -L$(BIT_PACK_NANOSSL_PATH)/bin
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_35 += -lssl
-    LIBPATHS_35 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_41 += -lssl
+    LIBPATHS_41 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_35 += -lcrypto
-    LIBPATHS_35 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_41 += -lcrypto
+    LIBPATHS_41 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 
-$(CONFIG)/bin/goahead-test: $(DEPS_35)
+$(CONFIG)/bin/goahead-test: $(DEPS_41)
 	@echo '      [Link] $(CONFIG)/bin/goahead-test'
-	$(CC) -o $(CONFIG)/bin/goahead-test $(LIBPATHS)    "$(CONFIG)/obj/test.o" $(LIBPATHS_35) $(LIBS_35) $(LIBS_35) $(LIBS) $(LIBS) 
+	$(CC) -o $(CONFIG)/bin/goahead-test $(LIBPATHS)    "$(CONFIG)/obj/test.o" $(LIBPATHS_41) $(LIBS_41) $(LIBS_41) $(LIBS) $(LIBS) 
 
 #
 #   gopass.o
 #
-DEPS_36 += $(CONFIG)/inc/bit.h
-DEPS_36 += $(CONFIG)/inc/goahead.h
-DEPS_36 += $(CONFIG)/inc/bitos.h
+DEPS_42 += $(CONFIG)/inc/bit.h
+DEPS_42 += $(CONFIG)/inc/goahead.h
+DEPS_42 += $(CONFIG)/inc/bitos.h
 
 $(CONFIG)/obj/gopass.o: \
-    src/utils/gopass.c $(DEPS_36)
+    src/utils/gopass.c $(DEPS_42)
 	@echo '   [Compile] $(CONFIG)/obj/gopass.o'
 	$(CC) -c -o $(CONFIG)/obj/gopass.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/utils/gopass.c
 
 #
 #   gopass
 #
-DEPS_37 += $(CONFIG)/inc/est.h
-DEPS_37 += $(CONFIG)/inc/bit.h
-DEPS_37 += $(CONFIG)/inc/bitos.h
-DEPS_37 += $(CONFIG)/obj/estLib.o
+DEPS_43 += $(CONFIG)/inc/est.h
+DEPS_43 += $(CONFIG)/inc/bit.h
+DEPS_43 += $(CONFIG)/inc/bitos.h
+DEPS_43 += $(CONFIG)/obj/estLib.o
 ifeq ($(BIT_PACK_EST),1)
-    DEPS_37 += $(CONFIG)/bin/libest.a
+    DEPS_43 += $(CONFIG)/bin/libest.a
 endif
-DEPS_37 += $(CONFIG)/inc/goahead.h
-DEPS_37 += $(CONFIG)/inc/js.h
-DEPS_37 += $(CONFIG)/obj/action.o
-DEPS_37 += $(CONFIG)/obj/alloc.o
-DEPS_37 += $(CONFIG)/obj/auth.o
-DEPS_37 += $(CONFIG)/obj/cgi.o
-DEPS_37 += $(CONFIG)/obj/crypt.o
-DEPS_37 += $(CONFIG)/obj/file.o
-DEPS_37 += $(CONFIG)/obj/fs.o
-DEPS_37 += $(CONFIG)/obj/http.o
-DEPS_37 += $(CONFIG)/obj/js.o
-DEPS_37 += $(CONFIG)/obj/jst.o
-DEPS_37 += $(CONFIG)/obj/options.o
-DEPS_37 += $(CONFIG)/obj/osdep.o
-DEPS_37 += $(CONFIG)/obj/rom-documents.o
-DEPS_37 += $(CONFIG)/obj/route.o
-DEPS_37 += $(CONFIG)/obj/runtime.o
-DEPS_37 += $(CONFIG)/obj/socket.o
-DEPS_37 += $(CONFIG)/obj/upload.o
-DEPS_37 += $(CONFIG)/obj/est.o
-DEPS_37 += $(CONFIG)/obj/matrixssl.o
-DEPS_37 += $(CONFIG)/obj/nanossl.o
-DEPS_37 += $(CONFIG)/obj/openssl.o
-DEPS_37 += $(CONFIG)/bin/libgo.a
-DEPS_37 += $(CONFIG)/obj/gopass.o
-
-LIBS_37 += -lgo
+DEPS_43 += $(CONFIG)/inc/goahead.h
+DEPS_43 += $(CONFIG)/inc/js.h
+DEPS_43 += $(CONFIG)/obj/action.o
+DEPS_43 += $(CONFIG)/obj/aio.o
+DEPS_43 += $(CONFIG)/obj/alloc.o
+DEPS_43 += $(CONFIG)/obj/auth.o
+DEPS_43 += $(CONFIG)/obj/cache.o
+DEPS_43 += $(CONFIG)/obj/cgi.o
+DEPS_43 += $(CONFIG)/obj/crypt.o
+DEPS_43 += $(CONFIG)/obj/fiber.o
+DEPS_43 += $(CONFIG)/obj/file.o
+DEPS_43 += $(CONFIG)/obj/fs.o
+DEPS_43 += $(CONFIG)/obj/http.o
+DEPS_43 += $(CONFIG)/obj/js.o
+DEPS_43 += $(CONFIG)/obj/json.o
+DEPS_43 += $(CONFIG)/obj/jst.o
+DEPS_43 += $(CONFIG)/obj/options.o
+DEPS_43 += $(CONFIG)/obj/osdep.o
+DEPS_43 += $(CONFIG)/obj/proxy.o
+DEPS_43 += $(CONFIG)/obj/rom-documents.o
+DEPS_43 += $(CONFIG)/obj/route.o
+DEPS_43 += $(CONFIG)/obj/runtime.o
+DEPS_43 += $(CONFIG)/obj/socket.o
+DEPS_43 += $(CONFIG)/obj/stats.o
+DEPS_43 += $(CONFIG)/obj/upload.o
+DEPS_43 += $(CONFIG)/obj/est.o
+DEPS_43 += $(CONFIG)/obj/matrixssl.o
+DEPS_43 += $(CONFIG)/obj/nanossl.o
+DEPS_43 += $(CONFIG)/obj/openssl.o
+DEPS_43 += $(CONFIG)/bin/libgo.a
+DEPS_43 += $(CONFIG)/obj/gopass.o
+
+LIBS_43 += -lgo
 ifeq ($(BIT_PACK_EST),1)
-    LIBS_37 += -lest
+    LIBS_43 += -lest
 endif
 ifeq ($(BIT_PACK_MATRIXSSL),1)
-    LIBS_37 += -lmatrixssl
-    LIBPATHS_37 += -L$(BIT_PACK_MATRIXSSL_PATH)
+    LIBS_43 += -lmatrixssl
+    LIBPATHS_43 += -L$(BIT_PACK_MATRIXSSL_PATH)
 endif
 ifeq ($(BIT_PACK_NANOSSL),1)
-    LIBS_37 += -lssls
-    LIBPATHS_37 += -L$(BIT_PACK_NANOSSL_PATH)/bin
+    LIBS_43 += -lssls
+    LIBPATHS_43 += -L$(BIT_PACK_NANOSSL_PATH)/bin
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_37 += -lssl
-    LIBPATHS_37 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_43 += -lssl
+    LIBPATHS_43 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 ifeq ($(BIT_PACK_OPENSSL),1)
-    LIBS_37 += -lcrypto
-    LIBPATHS_37 += -L$(BIT_PACK_OPENSSL_PATH)
+    LIBS_43 += -lcrypto
+    LIBPATHS_43 += -L$(BIT_PACK_OPENSSL_PATH)
 endif
 
-$(CONFIG)/bin/gopass: $(DEPS_37)
+$(CONFIG)/bin/gopass: $(DEPS_43)
 	@echo '      [Link] $(CONFIG)/bin/gopass'
-	$(CC) -o $(CONFIG)/bin/gopass $(LIBPATHS)    "$(CONFIG)/obj/gopass.o" $(LIBPATHS_37) $(LIBS_37) $(LIBS_37) $(LIBS) $(LIBS) 
+	$(CC) -o $(CONFIG)/bin/gopass $(LIBPATHS)    "$(CONFIG)/obj/gopass.o" $(LIBPATHS_43) $(LIBS_43) $(LIBS_43) $(LIBS) $(LIBS) 
+
+#
+#   goahead-stat.o
+#
+DEPS_44 += $(CONFIG)/inc/bit.h
+DEPS_44 += $(CONFIG)/inc/goahead.h
+DEPS_44 += $(CONFIG)/inc/bitos.h
+
+$(CONFIG)/obj/goahead-stat.o: \
+    src/utils/goahead-stat.c $(DEPS_44)
+	@echo '   [Compile] $(CONFIG)/obj/goahead-stat.o'
+	$(CC) -c -o $(CONFIG)/obj/goahead-stat.o $(CFLAGS) $(DFLAGS) $(IFLAGS) "-I$(BIT_PACK_MATRIXSSL_PATH)" "-I$(BIT_PACK_MATRIXSSL_PATH)/matrixssl" "-I$(BIT_PACK_NANOSSL_PATH)/src" "-I$(BIT_PACK_OPENSSL_PATH)/include" src/utils/goahead-stat.c
+
+#
+#   goahead-stat
+#
+DEPS_45 += $(CONFIG)/inc/est.h
+DEPS_45 += $(CONFIG)/inc/bit.h
+DEPS_45 += $(CONFIG)/inc/bitos.h
+DEPS_45 += $(CONFIG)/obj/estLib.o
+ifeq ($(BIT_PACK_EST),1)
+    DEPS_45 += $(CONFIG)/bin/libest.a
+endif
+DEPS_45 += $(CONFIG)/inc/goahead.h
+DEPS_45 += $(CONFIG)/inc/js.h
+DEPS_45 += $(CONFIG)/obj/action.o
+DEPS_45 += $(CONFIG)/obj/aio.o
+DEPS_45 += $(CONFIG)/obj/alloc.o
+DEPS_45 += $(CONFIG)/obj/auth.o
+DEPS_45 += $(CONFIG)/obj/cache.o
+DEPS_45 += $(CONFIG)/obj/cgi.o
+DEPS_45 += $(CONFIG)/obj/crypt.o
+DEPS_45 += $(CONFIG)/obj/fiber.o
+DEPS_45 += $(CONFIG)/obj/file.o
+DEPS_45 += $(CONFIG)/obj/fs.o
+DEPS_45 += $(CONFIG)/obj/http.o
+DEPS_45 += $(CONFIG)/obj/js.o
+DEPS_45 += $(CONFIG)/obj/json.o
+DEPS_45 += $(CONFIG)/obj/jst.o
+DEPS_45 += $(CONFIG)/obj/options.o
+DEPS_45 += $(CONFIG)/obj/osdep.o
+DEPS_45 += $(CONFIG)/obj/proxy.o
+DEPS_45 += $(CONFIG)/obj/rom-documents.o
+DEPS_45 += $(CONFIG)/obj/route.o
+DEPS_45 += $(CONFIG)/obj/runtime.o
+DEPS_45 += $(CONFIG)/obj/socket.o
+DEPS_45 += $(CONFIG)/obj/stats.o
+DEPS_45 += $(CONFIG)/obj/upload.o
+DEPS_45 += $(CONFIG)/obj/est.o
+DEPS_45 += $(CONFIG)/obj/matrixssl.o
+DEPS_45 += $(CONFIG)/obj/nanossl.o
+DEPS_45 += $(CONFIG)/obj/openssl.o
+DEPS_45 += $(CONFIG)/bin/libgo.a
+DEPS_45 += $(CONFIG)/obj/goahead-stat.o
+
+LIBS_45 += -lgo
+ifeq ($(BIT_PACK_EST),1)
+    LIBS_45 += -lest
+endif
+ifeq ($(BIT_PACK_MATRIXSSL),1)
+    LIBS_45 += -lmatrixssl
+    LIBPATHS_45 += -L$(BIT_PACK_MATRIXSSL_PATH)
+endif
+ifeq ($(BIT_PACK_NANOSSL),1)
+    LIBS_45 += -lssls
+    LIBPATHS_45 += -L$(BIT_PACK_NANOSSL_PATH)/bin
+endif
+ifeq ($(BIT_PACK_OPENSSL),1)
+    LIBS_45 += -lssl
+    LIBPATHS_45 += -L$(BIT_PACK_OPENSSL_PATH)
+endif
+ifeq ($(BIT_PACK_OPENSSL),1)
+    LIBS_45 += -lcrypto
+    LIBPATHS_45 += -L$(BIT_PACK_OPENSSL_PATH)
+endif
+
+$(CONFIG)/bin/goahead-stat: $(DEPS_45)
+	@echo '      [Link] $(CONFIG)/bin/goahead-stat'
+	$(CC) -o $(CONFIG)/bin/goahead-stat $(LIBPATHS)    "$(CONFIG)/obj/goahead-stat.o" $(LIBPATHS_45) $(LIBS_45) $(LIBS_45) $(LIBS) $(LIBS) 
 
 #
 #   stop
 #
-stop: $(DEPS_38)
+stop: $(DEPS_46)
 
 #
 #   installBinary
 #
-installBinary: $(DEPS_39)
+installBinary: $(DEPS_47)
 	mkdir -p "$(BIT_APP_PREFIX)"
 	rm -f "$(BIT_APP_PREFIX)/latest"
 	ln -s "3.1.3" "$(BIT_APP_PREFIX)/latest"
@@ -781,24 +960,24 @@ installBinary: $(DEPS_39)
 #
 #   start
 #
-start: $(DEPS_40)
+start: $(DEPS_48)
 
 #
 #   install
 #
-DEPS_41 += stop
-DEPS_41 += installBinary
-DEPS_41 += start
+DEPS_49 += stop
+DEPS_49 += installBinary
+DEPS_49 += start
 
-install: $(DEPS_41)
+install: $(DEPS_49)
 	
 
 #
 #   uninstall
 #
-DEPS_42 += stop
+DEPS_50 += stop
 
-uninstall: $(DEPS_42)
+uninstall: $(DEPS_50)
 	rm -fr "$(BIT_WEB_PREFIX)"
 	rm -fr "$(BIT_VAPP_PREFIX)"
 	rmdir -p "$(BIT_ETC_PREFIX)" 2>/dev/null ; true
@@ -809,5 +988,5 @@ uninstall: $(DEPS_42)
 #
 #   run
 #
-run: $(DEPS_43)
+run: $(DEPS_51)
 	cd src; goahead -v ; cd ..
@@ -28,6 +28,15 @@
 #ifndef BIT_GOAHEAD_ACCESS_LOG
     #define BIT_GOAHEAD_ACCESS_LOG 0
 #endif
+#ifndef BIT_GOAHEAD_AIO
+    #define BIT_GOAHEAD_AIO 1
+#endif
+#ifndef BIT_GOAHEAD_AIO_THREADS
+    #define BIT_GOAHEAD_AIO_THREADS 2
+#endif
+#ifndef BIT_GOAHEAD_AIO_THRESHOLD
+    #define BIT_GOAHEAD_AIO_THRESHOLD 0
+#endif
 #ifndef BIT_GOAHEAD_AUTH
     #define BIT_GOAHEAD_AUTH 1
 #endif
@@ -40,6 +49,9 @@
 #ifndef BIT_GOAHEAD_CA
     #define BIT_GOAHEAD_CA ""
 #endif
+#ifndef BIT_GOAHEAD_CACHE
+    #define BIT_GOAHEAD_CACHE 1
+#endif
 #ifndef BIT_GOAHEAD_CERTIFICATE
     #define BIT_GOAHEAD_CERTIFICATE "self.crt"
 #endif
@@ -61,9 +73,27 @@
 #ifndef BIT_GOAHEAD_DOCUMENTS
     #define BIT_GOAHEAD_DOCUMENTS "web"
 #endif
+#ifndef BIT_GOAHEAD_FIBER
+    #define BIT_GOAHEAD_FIBER 1
+#endif
+#ifndef BIT_GOAHEAD_FIBER_POOL
+    #define BIT_GOAHEAD_FIBER_POOL 16
+#endif
+#ifndef BIT_GOAHEAD_FIBER_STACK
+    #define BIT_GOAHEAD_FIBER_STACK 65536
+#endif
+#ifndef BIT_GOAHEAD_INDEX_REWRITE
+    #define BIT_GOAHEAD_INDEX_REWRITE 1
+#endif
+#ifndef BIT_GOAHEAD_IO_URING
+    #define BIT_GOAHEAD_IO_URING 0
+#endif
 #ifndef BIT_GOAHEAD_JAVASCRIPT
     #define BIT_GOAHEAD_JAVASCRIPT 1
 #endif
+#ifndef BIT_GOAHEAD_JSON
+    #define BIT_GOAHEAD_JSON 1
+#endif
 #ifndef BIT_GOAHEAD_KEY
     #define BIT_GOAHEAD_KEY "self.key"
 #endif
@@ -73,6 +103,15 @@
 #ifndef BIT_GOAHEAD_LIMIT_BUFFER
     #define BIT_GOAHEAD_LIMIT_BUFFER 8192
 #endif
+#ifndef BIT_GOAHEAD_LIMIT_CACHE
+    #define BIT_GOAHEAD_LIMIT_CACHE 1048576
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_CACHE_ITEM
+    #define BIT_GOAHEAD_LIMIT_CACHE_ITEM 65536
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_CACHE_VALUES
+    #define BIT_GOAHEAD_LIMIT_CACHE_VALUES 262144
+#endif
 #ifndef BIT_GOAHEAD_LIMIT_FILENAME
     #define BIT_GOAHEAD_LIMIT_FILENAME 256
 #endif
@@ -85,6 +124,21 @@
 #ifndef BIT_GOAHEAD_LIMIT_HEADERS
     #define BIT_GOAHEAD_LIMIT_HEADERS 4096
 #endif
+#ifndef BIT_GOAHEAD_LIMIT_IDLE
+    #define BIT_GOAHEAD_LIMIT_IDLE 100
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_JSON
+    #define BIT_GOAHEAD_LIMIT_JSON 1048576
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_JSON_DEPTH
+    #define BIT_GOAHEAD_LIMIT_JSON_DEPTH 32
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_KEEP_ALIVE
+    #define BIT_GOAHEAD_LIMIT_KEEP_ALIVE 100
+#endif
+#ifndef BIT_GOAHEAD_LIMIT_MISSING
+    #define BIT_GOAHEAD_LIMIT_MISSING 512
+#endif
 #ifndef BIT_GOAHEAD_LIMIT_NUM_HEADERS
     #define BIT_GOAHEAD_LIMIT_NUM_HEADERS 64
 #endif
@@ -127,6 +181,18 @@
 #ifndef BIT_GOAHEAD_LOGGING
     #define BIT_GOAHEAD_LOGGING 1
 #endif
+#ifndef BIT_GOAHEAD_MISSING_LIFESPAN
+    #define BIT_GOAHEAD_MISSING_LIFESPAN 10
+#endif
+#ifndef BIT_GOAHEAD_MMAP
+    #define BIT_GOAHEAD_MMAP 1
+#endif
+#ifndef BIT_GOAHEAD_OPENAT
+    #define BIT_GOAHEAD_OPENAT 1
+#endif
+#ifndef BIT_GOAHEAD_PROXY
+    #define BIT_GOAHEAD_PROXY 1
+#endif
 #ifndef BIT_GOAHEAD_PUT_DIR
     #define BIT_GOAHEAD_PUT_DIR "/tmp"
 #endif
@@ -136,6 +202,9 @@
 #ifndef BIT_GOAHEAD_REPLACE_MALLOC
     #define BIT_GOAHEAD_REPLACE_MALLOC 0
 #endif
+#ifndef BIT_GOAHEAD_STATS
+    #define BIT_GOAHEAD_STATS 1
+#endif
 #ifndef BIT_GOAHEAD_STEALTH
     #define BIT_GOAHEAD_STEALTH 1
 #endif
@@ -15,8 +15,32 @@
 /************************************ Locals **********************************/
 
 static WebsHash actionTable = -1;            /* Symbol table for actions */
+#if BIT_GOAHEAD_JSON
+static WebsHash jsonTable = -1;              /* Symbol table for action JSON body event callbacks */
+#endif
+
+#define ACTION_FIBER    0x1                     /* Key argument for actions that run in a fiber */
 
 /************************************* Code ***********************************/
+/*
+    Extract the action name from the request path into the supplied buffer
+ */
+static char *getActionName(Webs *wp, char *buf, ssize bufsize)
+{
+    char    *cp, *actionName;
+
+    scopy(buf, bufsize, wp->path);
+    if ((actionName = strchr(&buf[1], '/')) == NULL) {
+        return 0;
+    }
+    actionName++;
+    if ((cp = strchr(actionName, '/')) != NULL) {
+        *cp = '\0';
+    }
+    return actionName;
+}
+
+
 /*
     Process an action request. Returns 1 always to indicate it handled the URL
  */
@@ -24,24 +48,16 @@ static bool actionHandler(Webs *wp)
 {
     WebsKey     *sp;
     char        actionBuf[BIT_GOAHEAD_LIMIT_URI + 1];
-    char        *cp, *actionName;
+    char        *actionName;
     WebsAction  fn;
 
     assert(websValid(wp));
     assert(actionTable >= 0);
 
-    /*
-        Extract the action name
-     */
-    scopy(actionBuf, sizeof(actionBuf), wp->path);
-    if ((actionName = strchr(&actionBuf[1], '/')) == NULL) {
+    if ((actionName = getActionName(wp, actionBuf, sizeof(actionBuf))) == NULL) {
         websError(wp, HTTP_CODE_NOT_FOUND, "Missing action name");
         return 1;
     }
-    actionName++;
-    if ((cp = strchr(actionName, '/')) != NULL) {
-        *cp = '\0';
-    }
     /*
         Lookup the C action function first and then try tcl (no javascript support yet).
      */
@@ -51,6 +67,14 @@ static bool actionHandler(Webs *wp)
     } else {
         fn = (WebsAction) sp->content.value.symbol;
         assert(fn);
+#if BIT_GOAHEAD_FIBER
+        if (sp->arg == ACTION_FIBER) {
+            if (websStartFiber(wp, fn) < 0) {
+                websError(wp, HTTP_CODE_SERVICE_UNAVAILABLE, "Can't start fiber for action %s", actionName);
+            }
+            return 1;
+        }
+#endif
         if (fn) {
 #if BIT_GOAHEAD_LEGACY
             (*((WebsProc) fn))((void*) wp, actionName, wp->query);
@@ -79,18 +103,86 @@ PUBLIC int websDefineAction(char *name, void *fn)
 }
 
 
+#if BIT_GOAHEAD_FIBER
+/*
+    Define a function in the "action" map space that runs in a fiber
+ */
+PUBLIC int websDefineFiberAction(char *name, void *fn)
+{
+    assert(name && *name);
+    assert(fn);
+
+    if (fn == NULL) {
+        return -1;
+    }
+    hashEnter(actionTable, name, valueSymbol(fn), ACTION_FIBER);
+    return 0;
+}
+#endif
+
+
+#if BIT_GOAHEAD_JSON
+/*
+    Define an action that receives the events of a JSON request body as it is parsed rather than a parsed document
+ */
+PUBLIC int websDefineJsonAction(char *name, void *fn, WebsJsonEvent event)
+{
+    assert(name && *name);
+    assert(fn);
+    assert(event);
+
+    if (fn == NULL || event == NULL) {
+        return -1;
+    }
+    hashEnter(actionTable, name, valueSymbol(fn), 0);
+    hashEnter(jsonTable, name, valueSymbol(event), 0);
+    return 0;
+}
+
+
+/*
+    Return the JSON body event callback for the request action, if one is defined
+ */
+PUBLIC WebsJsonEvent websGetActionJsonEvent(Webs *wp)
+{
+    WebsKey     *sp;
+    char        actionBuf[BIT_GOAHEAD_LIMIT_URI + 1];
+    char        *actionName;
+
+    assert(websValid(wp));
+
+    if (jsonTable < 0 || (actionName = getActionName(wp, actionBuf, sizeof(actionBuf))) == NULL) {
+        return 0;
+    }
+    if ((sp = hashLookup(jsonTable, actionName)) == NULL) {
+        return 0;
+    }
+    return (WebsJsonEvent) sp->content.value.symbol;
+}
+#endif
+
+
 static void closeAction()
 {
     if (actionTable != -1) {
         hashFree(actionTable);
         actionTable = -1;
     }
+#if BIT_GOAHEAD_JSON
+    if (jsonTable != -1) {
+        hashFree(jsonTable);
+        jsonTable = -1;
+    }
+#endif
 }
 
 
 PUBLIC void websActionOpen()
 {
     actionTable = hashCreate(WEBS_HASH_INIT);
+#if BIT_GOAHEAD_JSON
+    jsonTable = hashCreate(WEBS_HASH_INIT);
+#endif
     websDefineHandler("action", actionHandler, closeAction, 0);
 }
 
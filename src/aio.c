@@ -0,0 +1,496 @@
+/*
+    aio.c -- Disk I/O thread pool
+
+    Opening and reading documents on network file systems, SD cards and other slow storage can block for tens of
+    milliseconds. The file and JST handlers use this pool of I/O threads to open, stat and read such documents
+    without blocking the event loop. Completed operations are returned to the event loop via an eventfd (a pipe
+    on systems without eventfd) which is serviced like a socket.
+
+    The I/O threads only perform system calls. All memory allocation and request processing happens on the
+    event loop.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#include    "goahead.h"
+
+#if BIT_GOAHEAD_AIO
+#if LINUX
+    #include    <sys/eventfd.h>
+    #include    <sys/vfs.h>
+#elif MACOSX || FREEBSD
+    #include    <sys/param.h>
+    #include    <sys/mount.h>
+#endif
+
+/*********************************** Locals ***********************************/
+
+static pthread_mutex_t  aioLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   aioCond = PTHREAD_COND_INITIALIZER;
+static pthread_t        aioThreads[BIT_GOAHEAD_AIO_THREADS];
+static int              aioThreadCount;     /* Number of I/O threads started */
+static int              aioStopping;        /* Set to stop the I/O threads */
+
+static WebsAio          *pendingFirst;      /* Operations waiting for an I/O thread */
+static WebsAio          *pendingLast;
+static WebsAio          *doneFirst;         /* Completed operations waiting for the event loop */
+static WebsAio          *doneLast;
+
+static int              aioSid = -1;        /* Socket wrapping the completion notification descriptor */
+static int              aioWakeFd = -1;     /* Descriptor written by the I/O threads. Same as the socket for eventfd. */
+static WebsHash         mounts = -1;        /* Cache of document directories and whether they are on slow mounts */
+
+/**************************** Forward Declarations ****************************/
+
+static void aioEvent(int sid, int mask, void *data);
+static void *aioMain(void *arg);
+static void freeAio(WebsAio *aio);
+static bool isSlowMount(char *dir);
+static void perform(WebsAio *aio);
+static int startAio(WebsAio *aio);
+static int startThreads();
+
+/************************************* Code ***********************************/
+
+PUBLIC void websAioOpen()
+{
+    mounts = hashCreate(-1);
+}
+
+
+PUBLIC void websAioClose()
+{
+    WebsAio     *aio, *next;
+    int         i;
+
+    pthread_mutex_lock(&aioLock);
+    aioStopping = 1;
+    pthread_cond_broadcast(&aioCond);
+    pthread_mutex_unlock(&aioLock);
+    for (i = 0; i < aioThreadCount; i++) {
+        pthread_join(aioThreads[i], NULL);
+    }
+    aioThreadCount = 0;
+
+    /*
+        All requests have been freed so any remaining operations are orphaned
+     */
+    for (aio = pendingFirst; aio; aio = next) {
+        next = aio->next;
+        freeAio(aio);
+    }
+    for (aio = doneFirst; aio; aio = next) {
+        next = aio->next;
+        freeAio(aio);
+    }
+    pendingFirst = pendingLast = doneFirst = doneLast = 0;
+    aioStopping = 0;
+
+    if (aioSid >= 0) {
+        if (aioWakeFd != socketPtr(aioSid)->sock) {
+            close(aioWakeFd);
+        }
+        socketFree(aioSid);
+        aioSid = -1;
+        aioWakeFd = -1;
+    }
+    if (mounts >= 0) {
+        hashFree(mounts);
+        mounts = -1;
+    }
+}
+
+
+PUBLIC bool websAioWanted(Webs *wp, Offset size)
+{
+    if (wp->route && wp->route->aio) {
+        return 1;
+    }
+    if (BIT_GOAHEAD_AIO_THRESHOLD > 0 && size >= BIT_GOAHEAD_AIO_THRESHOLD) {
+        return 1;
+    }
+    return isSlowMount(websGetDir(wp));
+}
+
+
+PUBLIC int websAioOpenFile(Webs *wp, WebsAioProc proc)
+{
+    WebsAio     *aio;
+
+    assert(websValid(wp));
+    assert(wp->filename);
+
+    if ((aio = wp->aio) == 0) {
+        if ((aio = walloc(sizeof(WebsAio))) == 0) {
+            return -1;
+        }
+        memset(aio, 0, sizeof(WebsAio));
+        aio->wp = wp;
+        aio->fd = -1;
+        wp->aio = aio;
+    }
+    assert(!aio->busy);
+    wfree(aio->path);
+#if BIT_GOAHEAD_OPENAT
+    aio->dirfd = wp->docdir;
+#else
+    aio->dirfd = -1;
+#endif
+    aio->path = sclone(aio->dirfd >= 0 ? wp->path : wp->filename);
+    aio->op = WEBS_AIO_OPEN;
+    aio->proc = proc;
+    aio->fd = -1;
+    return startAio(aio);
+}
+
+
+PUBLIC int websAioRead(Webs *wp, int fd, Offset offset, ssize size, WebsAioProc proc)
+{
+    WebsAio     *aio;
+    char        *buf;
+
+    assert(websValid(wp));
+    assert(fd >= 0);
+    assert(size > 0);
+
+    if ((aio = wp->aio) == 0) {
+        if ((aio = walloc(sizeof(WebsAio))) == 0) {
+            return -1;
+        }
+        memset(aio, 0, sizeof(WebsAio));
+        aio->wp = wp;
+        wp->aio = aio;
+    }
+    assert(!aio->busy);
+    if (size > aio->size || !aio->buf) {
+        if ((buf = wrealloc(aio->buf, size + 1)) == 0) {
+            return -1;
+        }
+        aio->buf = buf;
+        aio->size = size;
+    }
+    aio->op = WEBS_AIO_READ;
+    aio->proc = proc;
+    aio->fd = fd;
+    aio->offset = offset;
+    aio->nbytes = 0;
+    return startAio(aio);
+}
+
+
+PUBLIC void websAioCancel(Webs *wp)
+{
+    WebsAio     *aio;
+
+    if ((aio = wp->aio) == 0) {
+        return;
+    }
+    wp->aio = 0;
+    if (aio->busy) {
+        /*
+            The I/O thread may still be using the file. Take ownership of it so it is closed on completion.
+         */
+        if (aio->op == WEBS_AIO_READ && aio->fd == wp->docfd) {
+            wp->docfd = -1;
+        }
+        aio->wp = 0;
+    } else {
+        aio->fd = -1;
+        freeAio(aio);
+    }
+}
+
+
+static int startAio(WebsAio *aio)
+{
+    if (aioThreadCount == 0 && startThreads() < 0) {
+        return -1;
+    }
+    aio->error = 0;
+    aio->busy = 1;
+    aio->next = 0;
+    pthread_mutex_lock(&aioLock);
+    if (pendingLast) {
+        pendingLast->next = aio;
+    } else {
+        pendingFirst = aio;
+    }
+    pendingLast = aio;
+    pthread_cond_signal(&aioCond);
+    pthread_mutex_unlock(&aioLock);
+    return 0;
+}
+
+
+static int startThreads()
+{
+    WebsSocket  *sp;
+    int         fds[2];
+
+#if LINUX
+    if ((fds[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        error("Can't create eventfd for I/O threads, errno %d", errno);
+        return -1;
+    }
+    fds[1] = fds[0];
+#else
+    if (pipe(fds) < 0) {
+        error("Can't create pipe for I/O threads, errno %d", errno);
+        return -1;
+    }
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    if ((aioSid = socketAlloc(0, 0, 0, 0)) < 0) {
+        close(fds[0]);
+        if (fds[1] != fds[0]) {
+            close(fds[1]);
+        }
+        return -1;
+    }
+    aioWakeFd = fds[1];
+    sp = socketPtr(aioSid);
+    sp->sock = fds[0];
+    socketHighestFd = max(socketHighestFd, sp->sock);
+    socketCreateHandler(aioSid, SOCKET_READABLE, aioEvent, 0);
+
+    for (aioThreadCount = 0; aioThreadCount < BIT_GOAHEAD_AIO_THREADS; aioThreadCount++) {
+        if (pthread_create(&aioThreads[aioThreadCount], NULL, aioMain, NULL) != 0) {
+            error("Can't create I/O thread, errno %d", errno);
+            break;
+        }
+    }
+    if (aioThreadCount == 0) {
+        if (aioWakeFd != sp->sock) {
+            close(aioWakeFd);
+        }
+        socketFree(aioSid);
+        aioSid = aioWakeFd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+
+/*
+    I/O thread. This must not allocate memory or call any event loop APIs.
+ */
+static void *aioMain(void *arg)
+{
+    WebsAio     *aio;
+    uint64      one;
+    bool        wake;
+
+    pthread_mutex_lock(&aioLock);
+    while (!aioStopping) {
+        if ((aio = pendingFirst) == 0) {
+            pthread_cond_wait(&aioCond, &aioLock);
+            continue;
+        }
+        if ((pendingFirst = aio->next) == 0) {
+            pendingLast = 0;
+        }
+        pthread_mutex_unlock(&aioLock);
+
+        perform(aio);
+
+        pthread_mutex_lock(&aioLock);
+        aio->next = 0;
+        wake = (doneFirst == 0);
+        if (doneLast) {
+            doneLast->next = aio;
+        } else {
+            doneFirst = aio;
+        }
+        doneLast = aio;
+        if (wake) {
+            /*
+                Only wake the event loop when the completed queue becomes non-empty. It drains the whole queue.
+             */
+            one = 1;
+            if (write(aioWakeFd, &one, sizeof(one)) < 0) {
+                /* Already signalled */;
+            }
+        }
+    }
+    pthread_mutex_unlock(&aioLock);
+    return NULL;
+}
+
+
+static void perform(WebsAio *aio)
+{
+    struct stat     sbuf;
+    ssize           nbytes;
+
+    if (aio->op == WEBS_AIO_OPEN) {
+#if BIT_GOAHEAD_OPENAT
+        if (aio->dirfd >= 0) {
+            aio->fd = websOpenFileAt(aio->dirfd, aio->path, O_RDONLY | O_BINARY | O_CLOEXEC, 0);
+        } else
+#endif
+        {
+            aio->fd = open(aio->path, O_RDONLY | O_BINARY | O_CLOEXEC, 0);
+        }
+        if (aio->fd < 0) {
+            aio->error = errno;
+        } else if (fstat(aio->fd, &sbuf) < 0) {
+            aio->error = errno;
+            close(aio->fd);
+            aio->fd = -1;
+        } else {
+            aio->info.size = (Offset) sbuf.st_size;
+            aio->info.mtime = (WebsTime) sbuf.st_mtime;
+            aio->info.isDir = (sbuf.st_mode & S_IFDIR) != 0;
+        }
+    } else {
+        while (aio->nbytes < aio->size) {
+            if ((nbytes = pread(aio->fd, &aio->buf[aio->nbytes], aio->size - aio->nbytes,
+                    (off_t) (aio->offset + aio->nbytes))) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                aio->error = errno;
+                break;
+            } else if (nbytes == 0) {
+                break;
+            }
+            aio->nbytes += nbytes;
+        }
+    }
+}
+
+
+/*
+    Run completion callbacks for finished operations. This is called on the event loop when the I/O threads signal.
+ */
+static void aioEvent(int sid, int mask, void *data)
+{
+    WebsAio     *aio, *next;
+    Webs        *wp;
+    uint64      count;
+
+    while (read(socketPtr(sid)->sock, &count, sizeof(count)) > 0) {}
+
+    pthread_mutex_lock(&aioLock);
+    aio = doneFirst;
+    doneFirst = doneLast = 0;
+    pthread_mutex_unlock(&aioLock);
+
+    for (; aio; aio = next) {
+        next = aio->next;
+        aio->next = 0;
+        aio->busy = 0;
+        if ((wp = aio->wp) == 0) {
+            /* Request was freed while the operation was busy */
+            freeAio(aio);
+            continue;
+        }
+        if (aio->op == WEBS_AIO_READ) {
+            /* The file belongs to the caller */
+            aio->fd = -1;
+            aio->buf[aio->nbytes] = '\0';
+        }
+        (aio->proc)(wp, aio);
+        /*
+            The callback may have started another operation using the same aio
+         */
+        if (!aio->busy && aio->fd >= 0) {
+            close(aio->fd);
+            aio->fd = -1;
+        }
+        websPump(wp);
+        if (wp->flags & WEBS_CLOSED) {
+            websFree(wp);
+        }
+    }
+}
+
+
+static void freeAio(WebsAio *aio)
+{
+    if (aio->fd >= 0) {
+        close(aio->fd);
+    }
+    wfree(aio->path);
+    wfree(aio->buf);
+    wfree(aio);
+}
+
+
+/*
+    Test if a directory is on a mount where file system calls may block for a long time. The result is cached.
+ */
+static bool isSlowMount(char *dir)
+{
+    WebsKey     *kp;
+    bool        slow;
+#if LINUX
+    struct statfs   sbuf;
+#elif MACOSX || FREEBSD
+    struct statfs   sbuf;
+    static char     *slowTypes[] = { "nfs", "smbfs", "msdos", "exfat", "webdav", "afpfs", 0 };
+    char            **tp;
+#endif
+
+    if (!dir || mounts < 0) {
+        return 0;
+    }
+    if ((kp = hashLookup(mounts, dir)) != 0) {
+        return (bool) kp->content.value.integer;
+    }
+    slow = 0;
+#if LINUX
+    if (statfs(dir, &sbuf) == 0) {
+        switch ((uint) sbuf.f_type) {
+        case 0x6969:                /* NFS */
+        case 0x517B:                /* SMB */
+        case 0xFF534D42:            /* CIFS */
+        case 0xFE534D42:            /* SMB2 */
+        case 0x4d44:                /* MSDOS, VFAT (SD cards) */
+        case 0x2011BAB0:            /* EXFAT */
+        case 0x65735546:            /* FUSE */
+        case 0x01021997:            /* V9FS */
+            slow = 1;
+            break;
+        }
+    }
+#elif MACOSX || FREEBSD
+    if (statfs(dir, &sbuf) == 0) {
+        for (tp = slowTypes; *tp; tp++) {
+            if (smatch(sbuf.f_fstypename, *tp)) {
+                slow = 1;
+                break;
+            }
+        }
+    }
+#endif
+    if (slow) {
+        trace(2, "Using I/O threads for documents in %s", dir);
+    }
+    hashEnter(mounts, dir, valueInteger(slow), 0);
+    return slow;
+}
+
+#endif /* BIT_GOAHEAD_AIO */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+ */
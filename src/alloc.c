@@ -25,6 +25,15 @@
  */
 #define ROUNDUP4(size) ((size) % 4) ? (size) + (4 - ((size) % 4)) : (size)
 
+/*
+    Count allocation failures in the server statistics
+ */
+#if BIT_GOAHEAD_STATS
+    #define ALLOC_FAILED() websStats.allocFailures++
+#else
+    #define ALLOC_FAILED()
+#endif
+
 /*
     qhead blocks are created as the original memory allocation is freed up. See wfree.
  */
@@ -119,10 +128,12 @@ PUBLIC void *walloc(ssize size)
             bp = (WebsAlloc*) malloc(memSize);
             if (bp == NULL) {
                 printf("B: malloc failed\n");
+                ALLOC_FAILED();
                 return NULL;
             }
         } else {
             printf("B: malloc failed\n");
+            ALLOC_FAILED();
             return NULL;
         }
         /*
@@ -157,6 +168,7 @@ PUBLIC void *walloc(ssize size)
             memSize = ROUNDUP4(memSize);
             if ((bp = (WebsAlloc*) malloc(memSize)) == NULL) {
                 printf("B: malloc failed\n");
+                ALLOC_FAILED();
                 return NULL;
             }
             bp->u.size = memSize - sizeof(WebsAlloc);
@@ -164,10 +176,15 @@ PUBLIC void *walloc(ssize size)
 
         } else {
             printf("B: malloc failed\n");
+            ALLOC_FAILED();
             return NULL;
         }
     }
     bp->flags |= WEBS_INTEGRITY;
+#if BIT_GOAHEAD_STATS
+    websStats.allocCount++;
+    websStats.allocMemory += bp->u.size;
+#endif
     return (void*) ((char*) bp + sizeof(WebsAlloc));
 }
 
@@ -190,6 +207,9 @@ PUBLIC void wfree(void *mp)
         return;
     }
     wallocGetSize(bp->u.size, &q);
+#if BIT_GOAHEAD_STATS
+    websStats.allocMemory -= bp->u.size;
+#endif
     if (bp->flags & WEBS_MALLOCED) {
         free(bp);
         return;
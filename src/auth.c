@@ -106,7 +106,7 @@ PUBLIC bool websAuthenticate(Webs *wp)
             websError(wp, HTTP_CODE_BAD_REQUEST, "Access denied. Wrong authentication protocol type.");
             return 0;
         }
-        if (wp->authDetails) {
+        if (wp->auth && wp->auth->authDetails) {
             if (!(route->parseAuth)(wp)) {
                 return 0;
             }
@@ -464,18 +464,20 @@ PUBLIC WebsHash websGetRoles()
 
 PUBLIC bool websLoginUser(Webs *wp, char *username, char *password)
 {
+    WebsAuthState   *auth;
+
     assert(wp);
     assert(wp->route);
     assert(username);
     assert(password);
 
-    if (!wp->route || !wp->route->verify) {
+    if (!wp->route || !wp->route->verify || (auth = websGetAuthState(wp)) == 0) {
         return 0;
     }
     wfree(wp->username);
     wp->username = sclone(username);
-    wfree(wp->password);
-    wp->password = sclone(password);
+    wfree(auth->password);
+    auth->password = sclone(password);
 
     if (!(wp->route->verify)(wp)) {
         trace(2, "Password does not match");
@@ -531,10 +533,15 @@ static void logoutServiceProc(Webs *wp)
 
 static void basicLogin(Webs *wp)
 {
+    WebsAuthState   *auth;
+
     assert(wp);
     assert(wp->route);
-    wfree(wp->authResponse);
-    wp->authResponse = sfmt("Basic realm=\"%s\"", BIT_GOAHEAD_REALM);
+    if ((auth = websGetAuthState(wp)) == 0) {
+        return;
+    }
+    wfree(auth->authResponse);
+    auth->authResponse = sfmt("Basic realm=\"%s\"", BIT_GOAHEAD_REALM);
 }
 
 
@@ -552,10 +559,14 @@ WebsVerify websGetPasswordStoreVerify()
 
 PUBLIC bool websVerifyPasswordFromFile(Webs *wp)
 {
-    char    passbuf[BIT_GOAHEAD_LIMIT_PASSWORD * 3 + 3];
-    bool    success;
+    WebsAuthState   *auth;
+    char            passbuf[BIT_GOAHEAD_LIMIT_PASSWORD * 3 + 3];
+    bool            success;
 
     assert(wp);
+    if ((auth = wp->auth) == 0 || auth->password == 0) {
+        return 0;
+    }
     if (!wp->user && (wp->user = websLookupUser(wp->username)) == 0) {
         trace(5, "verifyUser: Unknown user \"%s\"", wp->username);
         return 0;
@@ -564,16 +575,16 @@ PUBLIC bool websVerifyPasswordFromFile(Webs *wp)
         Verify the password. If using Digest auth, we compare the digest of the password.
         Otherwise we encode the plain-text password and compare that
      */
-    if (!wp->encoded) {
-        fmt(passbuf, sizeof(passbuf), "%s:%s:%s", wp->username, BIT_GOAHEAD_REALM, wp->password);
-        wfree(wp->password);
-        wp->password = websMD5(passbuf);
-        wp->encoded = 1;
+    if (!auth->encoded) {
+        fmt(passbuf, sizeof(passbuf), "%s:%s:%s", wp->username, BIT_GOAHEAD_REALM, auth->password);
+        wfree(auth->password);
+        auth->password = websMD5(passbuf);
+        auth->encoded = 1;
     }
-    if (wp->digest) {
-        success = smatch(wp->password, wp->digest);
+    if (auth->digest) {
+        success = smatch(auth->password, auth->digest);
     } else {
-        success = smatch(wp->password, wp->user->password);
+        success = smatch(auth->password, wp->user->password);
     }
     if (success) {
         trace(5, "User \"%s\" authenticated", wp->username);
@@ -595,15 +606,18 @@ PUBLIC bool websVerifyPasswordFromPam(Webs *wp)
     UserInfo            info;
     struct pam_conv     conv = { pamChat, &info };
     struct group        *gp;
+    WebsAuthState       *auth;
     int                 res, i;
    
     assert(wp);
+    assert(wp->auth);
+    auth = wp->auth;
     assert(wp->username && wp->username);
-    assert(wp->password);
-    assert(!wp->encoded);
+    assert(auth->password);
+    assert(!auth->encoded);
 
     info.name = (char*) wp->username;
-    info.password = (char*) wp->password;
+    info.password = (char*) auth->password;
     pamh = NULL;
     if ((res = pam_start("login", info.name, &conv, &pamh)) != PAM_SUCCESS) {
         return 0;
@@ -707,23 +721,25 @@ static int jsCan(int jsid, Webs *wp, int argc, char **argv)
 
 static bool parseBasicDetails(Webs *wp)
 {
-    char    *cp, *userAuth;
+    WebsAuthState   *auth;
+    char            *cp, *userAuth;
 
     assert(wp);
+    auth = wp->auth;
     /*
         Split userAuth into userid and password
      */
-    userAuth = websDecode64(wp->authDetails);
+    userAuth = websDecode64(auth->authDetails);
     if ((cp = strchr(userAuth, ':')) != NULL) {
         *cp++ = '\0';
     }
     if (cp) {
         wp->username = sclone(userAuth);
-        wp->password = sclone(cp);
-        wp->encoded = 0;
+        auth->password = sclone(cp);
+        auth->encoded = 0;
     } else {
         wp->username = sclone("");
-        wp->password = sclone("");
+        auth->password = sclone("");
     }
     wfree(userAuth);
     return 1;
@@ -733,15 +749,18 @@ static bool parseBasicDetails(Webs *wp)
 #if BIT_DIGEST
 static void digestLogin(Webs *wp)
 {
-    char  *nonce, *opaque;
+    WebsAuthState   *auth;
+    char            *nonce, *opaque;
 
     assert(wp);
     assert(wp->route);
-
+    if ((auth = websGetAuthState(wp)) == 0) {
+        return;
+    }
     nonce = createDigestNonce(wp);
     /* Opaque is unused. Set to anything */
     opaque = "5ccc069c403ebaf9f0171e9517f40e41";
-    wp->authResponse = sfmt(
+    auth->authResponse = sfmt(
         "Digest realm=\"%s\", domain=\"%s\", qop=\"%s\", nonce=\"%s\", opaque=\"%s\", algorithm=\"%s\", stale=\"%s\"",
         BIT_GOAHEAD_REALM, websGetServerUrl(), "auth", nonce, opaque, "MD5", "FALSE");
     wfree(nonce);
@@ -750,12 +769,14 @@ static void digestLogin(Webs *wp)
 
 static bool parseDigestDetails(Webs *wp)
 {
-    WebsTime    when;
-    char        *value, *tok, *key, *dp, *sp, *secret, *realm;
-    int         seenComma;
+    WebsAuthState   *auth;
+    WebsTime        when;
+    char            *value, *tok, *key, *dp, *sp, *secret, *realm;
+    int             seenComma;
 
     assert(wp);
-    key = sclone(wp->authDetails);
+    auth = wp->auth;
+    key = sclone(auth->authDetails);
 
     while (*key) {
         while (*key && isspace((uchar) *key)) {
@@ -812,7 +833,7 @@ static bool parseDigestDetails(Webs *wp)
 
         case 'c':
             if (scaselesscmp(key, "cnonce") == 0) {
-                wp->cnonce = sclone(value);
+                auth->cnonce = sclone(value);
             }
             break;
 
@@ -824,31 +845,31 @@ static bool parseDigestDetails(Webs *wp)
 
         case 'n':
             if (scaselesscmp(key, "nc") == 0) {
-                wp->nc = sclone(value);
+                auth->nc = sclone(value);
             } else if (scaselesscmp(key, "nonce") == 0) {
-                wp->nonce = sclone(value);
+                auth->nonce = sclone(value);
             }
             break;
 
         case 'o':
             if (scaselesscmp(key, "opaque") == 0) {
-                wp->opaque = sclone(value);
+                auth->opaque = sclone(value);
             }
             break;
 
         case 'q':
             if (scaselesscmp(key, "qop") == 0) {
-                wp->qop = sclone(value);
+                auth->qop = sclone(value);
             }
             break;
 
         case 'r':
             if (scaselesscmp(key, "realm") == 0) {
-                wp->realm = sclone(value);
+                auth->realm = sclone(value);
             } else if (scaselesscmp(key, "response") == 0) {
                 /* Store the response digest in the password field. This is MD5(user:realm:password) */
-                wp->password = sclone(value);
-                wp->encoded = 1;
+                auth->password = sclone(value);
+                auth->encoded = 1;
             }
             break;
 
@@ -859,7 +880,7 @@ static bool parseDigestDetails(Webs *wp)
         
         case 'u':
             if (scaselesscmp(key, "uri") == 0) {
-                wp->digestUri = sclone(value);
+                auth->digestUri = sclone(value);
             } else if (scaselesscmp(key, "username") == 0 || scaselesscmp(key, "user") == 0) {
                 wp->username = sclone(value);
             }
@@ -879,27 +900,27 @@ static bool parseDigestDetails(Webs *wp)
             }
         }
     }
-    if (wp->username == 0 || wp->realm == 0 || wp->nonce == 0 || wp->route == 0 || wp->password == 0) {
+    if (wp->username == 0 || auth->realm == 0 || auth->nonce == 0 || wp->route == 0 || auth->password == 0) {
         return 0;
     }
-    if (wp->qop && (wp->cnonce == 0 || wp->nc == 0)) {
+    if (auth->qop && (auth->cnonce == 0 || auth->nc == 0)) {
         return 0;
     }
-    if (wp->qop == 0) {
-        wp->qop = sclone("");
+    if (auth->qop == 0) {
+        auth->qop = sclone("");
     }
     /*
         Validate the nonce value - prevents replay attacks
      */
     when = 0; secret = 0; realm = 0;
-    parseDigestNonce(wp->nonce, &secret, &realm, &when);
+    parseDigestNonce(auth->nonce, &secret, &realm, &when);
     if (!smatch(secret, secret)) {
         trace(2, "Access denied: Nonce mismatch");
         return 0;
     } else if (!smatch(realm, BIT_GOAHEAD_REALM)) {
         trace(2, "Access denied: Realm mismatch");
         return 0;
-    } else if (!smatch(wp->qop, "auth")) {
+    } else if (!smatch(auth->qop, "auth")) {
         trace(2, "Access denied: Bad qop");
         return 0;
     } else if ((when + (5 * 60)) < time(0)) {
@@ -912,7 +933,7 @@ static bool parseDigestDetails(Webs *wp)
             return 0;
         }
     }
-    wp->digest = calcDigest(wp, 0, wp->user->password);
+    auth->digest = calcDigest(wp, 0, wp->user->password);
     return 1;
 }
 
@@ -957,10 +978,12 @@ static int parseDigestNonce(char *nonce, char **secret, char **realm, WebsTime *
 */
 static char *calcDigest(Webs *wp, char *username, char *password)
 {
-    char  a1Buf[256], a2Buf[256], digestBuf[256];
-    char  *ha1, *ha2, *method, *result;
+    WebsAuthState   *auth;
+    char            a1Buf[256], a2Buf[256], digestBuf[256];
+    char            *ha1, *ha2, *method, *result;
 
     assert(wp);
+    auth = wp->auth;
     assert(username && *username);
     assert(password);
 
@@ -971,7 +994,7 @@ static char *calcDigest(Webs *wp, char *username, char *password)
     if (username == 0) {
         ha1 = sclone(password);
     } else {
-        fmt(a1Buf, sizeof(a1Buf), "%s:%s:%s", username, wp->realm, password);
+        fmt(a1Buf, sizeof(a1Buf), "%s:%s:%s", username, auth->realm, password);
         ha1 = websMD5(a1Buf);
     }
 
@@ -979,20 +1002,22 @@ static char *calcDigest(Webs *wp, char *username, char *password)
         HA2
      */ 
     method = wp->method;
-    fmt(a2Buf, sizeof(a2Buf), "%s:%s", method, wp->digestUri);
+    fmt(a2Buf, sizeof(a2Buf), "%s:%s", method, auth->digestUri);
     ha2 = websMD5(a2Buf);
 
     /*
         H(HA1:nonce:HA2)
      */
-    if (scmp(wp->qop, "auth") == 0) {
-        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s:%s:%s:%s", ha1, wp->nonce, wp->nc, wp->cnonce, wp->qop, ha2);
+    if (scmp(auth->qop, "auth") == 0) {
+        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s:%s:%s:%s", ha1, auth->nonce, auth->nc, auth->cnonce, auth->qop,
+            ha2);
 
-    } else if (scmp(wp->qop, "auth-int") == 0) {
-        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s:%s:%s:%s", ha1, wp->nonce, wp->nc, wp->cnonce, wp->qop, ha2);
+    } else if (scmp(auth->qop, "auth-int") == 0) {
+        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s:%s:%s:%s", ha1, auth->nonce, auth->nc, auth->cnonce, auth->qop,
+            ha2);
 
     } else {
-        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s", ha1, wp->nonce, ha2);
+        fmt(digestBuf, sizeof(digestBuf), "%s:%s:%s", ha1, auth->nonce, ha2);
     }
     result = websMD5(digestBuf);
     wfree(ha1);
@@ -0,0 +1,821 @@
+/*
+    cache.c -- Response micro-cache and value cache
+
+    Routes with a "cache" lifespan capture complete responses (status, headers and body) and serve them from memory
+    to subsequent GET and HEAD requests for the same URL. For example:
+
+        route uri=/status extensions=jst handler=jst cache=1s
+
+    Only one request generates a missing item. Concurrent requests for the same item wait for it to be filled.
+    Expired items may be served for one further lifespan while a single request refreshes the item.
+    Responses that are not "200 OK", that set cookies or that vary by request header are not cached. Instead, a
+    "pass" item is cached for one lifespan so that requests for the URL run the handler without waiting on a fill.
+
+    The value cache holds application values shared by all requests, such as expensive status computed by actions.
+    Values are set with a lifespan via websCacheSet and retrieved by websCacheGet. Expired values are pruned
+    periodically and the least recently used values are evicted to stay within the "limitCacheValues" memory limit.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#include    "goahead.h"
+
+#if BIT_GOAHEAD_CACHE
+/*********************************** Defines **********************************/
+
+#define CACHE_PRUNE     (5 * 1000)          /* Prune expired items every 5 seconds */
+
+/*
+    Cached response
+ */
+typedef struct CacheItem {
+    char        *key;                       /* URL and username */
+    char        *headers;                   /* Response headers to replay */
+    WebsBuf     capture;                    /* Response headers and body being captured */
+    ssize       headersLen;                 /* Length of the captured headers */
+    ssize       size;                       /* Memory charged to the cache */
+    WebsTime    expires;                    /* When the item becomes stale */
+    WebsTime    stale;                      /* When the item may no longer be served */
+    Webs        *filler;                    /* Request generating the item. Null once filled. */
+    Webs        **waiters;                  /* Requests waiting for the item to be filled */
+    int         waitMax;
+    int         lifespan;                   /* Route cache lifespan in seconds */
+    int         code;                       /* Response status */
+    int         discard;                    /* Response is not cacheable */
+    int         pass;                       /* Marker for an uncacheable URL. Requests bypass the cache. */
+    int         refs;                       /* References from the cache and requests being served */
+} CacheItem;
+
+/*
+    Cached value. The key and value are stored after the structure.
+ */
+typedef struct ValueItem {
+    struct ValueItem *prev;                 /* Less recently used */
+    struct ValueItem *next;                 /* More recently used */
+    char        *key;
+    char        *value;                     /* Null terminated value */
+    ssize       len;                        /* Length of the value */
+    ssize       size;                       /* Memory charged to the cache */
+    WebsTime    expires;                    /* When the value expires. Zero if the value does not expire. */
+} ValueItem;
+
+/************************************ Locals **********************************/
+
+static WebsHash         items = -1;         /* Cached responses */
+static WebsHash         fills = -1;         /* Items being filled */
+static WebsCacheStats   stats;
+static int              pruneId = -1;
+
+static WebsHash         values = -1;        /* Cached values */
+static ValueItem        *valueHead;         /* Least recently used value */
+static ValueItem        *valueTail;         /* Most recently used value */
+static ssize            valueMemory;        /* Memory used by cached values */
+static int              valuePruneId = -1;
+
+/*
+    Response headers that are regenerated for each request and not cached
+ */
+static char *volatileHeaders[] = {
+    "connection", "content-length", "date", "server", "transfer-encoding", 0
+};
+
+/********************************** Forwards **********************************/
+
+static int addWaiter(CacheItem *item, Webs *wp);
+static bool commitItem(CacheItem *item);
+static bool isVolatile(char *header);
+static void evictItems(ssize needed);
+static char *makeKey(Webs *wp);
+static void pruneItems(void *data, int id);
+static void passItem(CacheItem *item);
+static void pruneValues(void *data, int id);
+static void releaseItem(CacheItem *item);
+static void removeItem(CacheItem *item);
+static void removeValue(ValueItem *vp);
+static void serveItem(Webs *wp, CacheItem *item);
+static void valueAppend(ValueItem *vp);
+static void valueUnlink(ValueItem *vp);
+static void wakeWaiters(CacheItem *item, CacheItem *filled);
+static void writeCachedBody(Webs *wp);
+
+/************************************* Code ***********************************/
+
+PUBLIC int websOpenCache()
+{
+    if ((items = hashCreate(-1)) < 0) {
+        return -1;
+    }
+    if ((fills = hashCreate(-1)) < 0) {
+        return -1;
+    }
+    if ((values = hashCreate(-1)) < 0) {
+        return -1;
+    }
+    memset(&stats, 0, sizeof(stats));
+    return 0;
+}
+
+
+PUBLIC void websCloseCache()
+{
+    WebsKey     *sym, *next;
+
+    if (pruneId >= 0) {
+        websStopEvent(pruneId);
+        pruneId = -1;
+    }
+    if (items >= 0) {
+        for (sym = hashFirst(items); sym; sym = next) {
+            next = hashNext(items, sym);
+            removeItem(sym->content.value.symbol);
+        }
+        hashFree(items);
+        items = -1;
+    }
+    if (fills >= 0) {
+        /* Requests are freed before the cache is closed, so all fills have been cancelled */
+        hashFree(fills);
+        fills = -1;
+    }
+    if (valuePruneId >= 0) {
+        websStopEvent(valuePruneId);
+        valuePruneId = -1;
+    }
+    if (values >= 0) {
+        while (valueHead) {
+            removeValue(valueHead);
+        }
+        hashFree(values);
+        values = -1;
+    }
+}
+
+
+/*
+    Serve a request from the cache if possible. Returns true if the request was served or is waiting for another
+    request to fill the item. Otherwise the request becomes the filler for the item and the caller should run
+    the route handler to generate the response.
+ */
+PUBLIC bool websCacheRequest(Webs *wp)
+{
+    WebsKey     *sym;
+    CacheItem   *item, *fill;
+    WebsTime    now;
+    char        *key;
+
+    assert(websValid(wp));
+    assert(wp->route && wp->route->lifespan > 0);
+
+    if (items < 0 || wp->cache || !(smatch(wp->method, "GET") || smatch(wp->method, "HEAD"))) {
+        return 0;
+    }
+    key = makeKey(wp);
+    now = time(0);
+    item = (sym = hashLookup(items, key)) != 0 ? sym->content.value.symbol : 0;
+    fill = (sym = hashLookup(fills, key)) != 0 ? sym->content.value.symbol : 0;
+    if (item && item->pass) {
+        if (now < item->expires) {
+            stats.passes++;
+            wfree(key);
+            return 0;
+        }
+        item = 0;
+    }
+    if (smatch(wp->method, "HEAD") && !(item && now < item->stale)) {
+        /* Items are only filled by GET requests */
+        wfree(key);
+        return 0;
+    }
+    if (item && now < item->expires) {
+        stats.hits++;
+        wfree(key);
+        serveItem(wp, item);
+        return 1;
+    }
+    if (item && fill && now < item->stale) {
+        /* Another request is refreshing the item */
+        stats.stale++;
+        wfree(key);
+        serveItem(wp, item);
+        return 1;
+    }
+    if (fill) {
+        if (addWaiter(fill, wp) < 0) {
+            wfree(key);
+            return 0;
+        }
+        stats.waits++;
+        wfree(key);
+        return 1;
+    }
+    stats.misses++;
+    if ((item = walloc(sizeof(CacheItem))) == 0) {
+        wfree(key);
+        return 0;
+    }
+    memset(item, 0, sizeof(CacheItem));
+    item->key = key;
+    item->filler = wp;
+    item->lifespan = wp->route->lifespan;
+    item->refs = 1;
+    bufCreate(&item->capture, BIT_GOAHEAD_LIMIT_BUFFER, BIT_GOAHEAD_LIMIT_CACHE_ITEM);
+    hashEnter(fills, key, valueSymbol(item), 0);
+    wp->cache = item;
+    return 0;
+}
+
+
+/*
+    Capture response data written by the filling request. Called by websWriteBlock for buffered output and by
+    websWriteSocket for body data that handlers write directly to the socket.
+ */
+PUBLIC void websCacheWrite(Webs *wp, char *buf, ssize len)
+{
+    CacheItem   *item;
+
+    item = wp->cache;
+    if (!item || item->filler != wp || item->discard || len <= 0) {
+        return;
+    }
+    if (!(wp->flags & WEBS_HEADERS_CREATED)) {
+        item->headersLen += len;
+    }
+    if (bufPutBlk(&item->capture, buf, len) != len) {
+        /* Too big to cache */
+        item->discard = 1;
+        bufFree(&item->capture);
+    }
+}
+
+
+/*
+    The filling request has completed its response. Add the item to the cache and serve the waiting requests.
+    Called by websDone.
+ */
+PUBLIC void websCacheComplete(Webs *wp)
+{
+    CacheItem   *item;
+
+    item = wp->cache;
+    if (!item || item->filler != wp) {
+        return;
+    }
+    wp->cache = 0;
+    item->filler = 0;
+    hashDelete(fills, item->key);
+    item->code = wp->code;
+    item->expires = time(0) + item->lifespan;
+    item->stale = item->expires + item->lifespan;
+
+    if (commitItem(item)) {
+        wakeWaiters(item, item);
+    } else {
+        /* Waiting requests are rerouted and will find the pass item */
+        passItem(item);
+        wakeWaiters(item, 0);
+    }
+    releaseItem(item);
+}
+
+
+/*
+    Called when a request is freed to cancel any cache fill, wait or write for the request
+ */
+PUBLIC void websCacheCancel(Webs *wp)
+{
+    CacheItem   *item;
+    int         i;
+
+    if ((item = wp->cache) == 0) {
+        return;
+    }
+    wp->cache = 0;
+    if (item->filler == wp) {
+        /* The response was not completed */
+        item->filler = 0;
+        hashDelete(fills, item->key);
+        wakeWaiters(item, 0);
+        releaseItem(item);
+        return;
+    }
+    for (i = 0; i < item->waitMax; i++) {
+        if (item->waiters[i] == wp) {
+            item->waitMax = wfreeHandle(&item->waiters, i);
+            break;
+        }
+    }
+    releaseItem(item);
+}
+
+
+PUBLIC void websGetCacheStats(WebsCacheStats *sp)
+{
+    assert(sp);
+    *sp = stats;
+}
+
+
+/*
+    Set the response cache lifespan for a route in seconds. Zero disables caching.
+ */
+PUBLIC int websSetRouteCache(WebsRoute *route, int lifespan)
+{
+    assert(route);
+
+    if (lifespan < 0) {
+        error("Bad cache lifespan %d for route %s", lifespan, route->prefix);
+        return -1;
+    }
+    route->lifespan = lifespan;
+    return 0;
+}
+
+
+static char *makeKey(Webs *wp)
+{
+    /*
+        Responses may vary by user for authenticated routes
+     */
+    if (wp->username && *wp->username) {
+        return sfmt("%s %s", wp->url, wp->username);
+    }
+    return sclone(wp->url);
+}
+
+
+/*
+    Filter the captured headers and add a successful response to the cache. Returns false if the response is not
+    cacheable.
+ */
+static bool commitItem(CacheItem *item)
+{
+    WebsKey     *sym;
+    WebsBuf     headers;
+    char        *end, *line, *value, *tok, c;
+    bool        cacheable;
+
+    if (item->discard || item->code != HTTP_CODE_OK || bufLen(&item->capture) < item->headersLen) {
+        return 0;
+    }
+    bufCreate(&headers, BIT_GOAHEAD_LIMIT_BUFFER, BIT_GOAHEAD_LIMIT_HEADERS);
+    cacheable = 1;
+
+    /*
+        Tokenize the headers in-place. The first line is the status line.
+     */
+    end = &item->capture.servp[item->headersLen];
+    c = *end;
+    *end = '\0';
+    stok(item->capture.servp, "\r\n", &tok);
+    for (line = stok(NULL, "\r\n", &tok); line; line = stok(NULL, "\r\n", &tok)) {
+        if ((value = strchr(line, ':')) == 0) {
+            continue;
+        }
+        *value++ = '\0';
+        if (scaselessmatch(line, "set-cookie") || scaselessmatch(line, "www-authenticate") ||
+                scaselessmatch(line, "vary")) {
+            cacheable = 0;
+            break;
+        }
+        if (!isVolatile(line)) {
+            bufPutStr(&headers, line);
+            bufPutc(&headers, ':');
+            bufPutStr(&headers, value);
+            bufPutStr(&headers, "\r\n");
+        }
+    }
+    *end = c;
+    bufAddNull(&headers);
+    if (cacheable) {
+        item->headers = sclone(headers.servp);
+    }
+    bufFree(&headers);
+    if (!cacheable) {
+        return 0;
+    }
+    /* Keep only the body in the capture buffer */
+    bufAdjustStart(&item->capture, item->headersLen);
+    bufCompact(&item->capture);
+    item->headersLen = 0;
+    item->size = sizeof(CacheItem) + slen(item->key) + slen(item->headers) + item->capture.buflen;
+    if (item->size > BIT_GOAHEAD_LIMIT_CACHE) {
+        return 0;
+    }
+    evictItems(item->size);
+
+    if ((sym = hashLookup(items, item->key)) != 0) {
+        removeItem(sym->content.value.symbol);
+    }
+    item->refs++;
+    hashEnter(items, item->key, valueSymbol(item), 0);
+    stats.items++;
+    stats.memory += item->size;
+    if (pruneId < 0) {
+        pruneId = websStartEvent(CACHE_PRUNE, pruneItems, 0);
+    }
+    trace(5, "cache: add %s, %d bytes", item->key, (int) bufLen(&item->capture));
+    return 1;
+}
+
+
+/*
+    Cache a marker for a URL whose response could not be cached. Until it expires, requests for the URL run the
+    handler concurrently instead of queuing behind a single fill.
+ */
+static void passItem(CacheItem *item)
+{
+    WebsKey     *sym;
+    CacheItem   *pass;
+
+    if ((pass = walloc(sizeof(CacheItem))) == 0) {
+        return;
+    }
+    memset(pass, 0, sizeof(CacheItem));
+    pass->key = sclone(item->key);
+    pass->pass = 1;
+    pass->refs = 1;
+    pass->lifespan = item->lifespan;
+    pass->expires = pass->stale = time(0) + item->lifespan;
+    pass->size = sizeof(CacheItem) + slen(pass->key);
+    evictItems(pass->size);
+
+    if ((sym = hashLookup(items, pass->key)) != 0) {
+        removeItem(sym->content.value.symbol);
+    }
+    hashEnter(items, pass->key, valueSymbol(pass), 0);
+    stats.items++;
+    stats.memory += pass->size;
+    if (pruneId < 0) {
+        pruneId = websStartEvent(CACHE_PRUNE, pruneItems, 0);
+    }
+    trace(5, "cache: pass %s", pass->key);
+}
+
+
+static bool isVolatile(char *header)
+{
+    char    **hp;
+
+    for (hp = volatileHeaders; *hp; hp++) {
+        if (scaselessmatch(header, *hp)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Write a cached response. Large bodies are written in the background.
+ */
+static void serveItem(Webs *wp, CacheItem *item)
+{
+    wp->cache = item;
+    wp->cachePos = 0;
+    item->refs++;
+
+    /* The cached headers include the content type */
+    wfree(wp->ext);
+    wp->ext = 0;
+    websSetStatus(wp, item->code);
+    websWriteHeaders(wp, bufLen(&item->capture), 0);
+    websWriteBlock(wp, item->headers, slen(item->headers));
+    websWriteEndHeaders(wp);
+    if (smatch(wp->method, "HEAD") || bufLen(&item->capture) == 0) {
+        websDone(wp);
+    } else {
+        websSetBackgroundWriter(wp, writeCachedBody);
+    }
+}
+
+
+static void writeCachedBody(Webs *wp)
+{
+    CacheItem   *item;
+    ssize       len, written;
+
+    if ((item = wp->cache) == 0) {
+        return;
+    }
+    while ((len = bufLen(&item->capture) - wp->cachePos) > 0) {
+        if ((written = websWriteSocket(wp, &item->capture.servp[wp->cachePos], len)) <= 0) {
+            break;
+        }
+        wp->cachePos += written;
+    }
+    if (len <= 0) {
+        websDone(wp);
+    }
+}
+
+
+static int addWaiter(CacheItem *item, Webs *wp)
+{
+    int     wid;
+
+    if ((wid = wallocHandle(&item->waiters)) < 0) {
+        return -1;
+    }
+    item->waiters[wid] = wp;
+    item->waitMax = max(item->waitMax, wid + 1);
+    item->refs++;
+    wp->cache = item;
+    return 0;
+}
+
+
+/*
+    Resume requests waiting for an item. If the item was filled, serve it. Otherwise reroute the requests so one of
+    them can generate the response.
+ */
+static void wakeWaiters(CacheItem *item, CacheItem *filled)
+{
+    Webs    *wp;
+    int     i;
+
+    for (i = 0; i < item->waitMax; i++) {
+        if ((wp = item->waiters[i]) == 0) {
+            continue;
+        }
+        item->waitMax = wfreeHandle(&item->waiters, i);
+        wp->cache = 0;
+        item->refs--;
+        if (filled) {
+            serveItem(wp, filled);
+        } else {
+            wp->state = WEBS_READY;
+        }
+        websPump(wp);
+        if (wp->flags & WEBS_CLOSED) {
+            websFree(wp);
+        }
+    }
+}
+
+
+/*
+    Remove items to make room for "needed" bytes. Expired items are removed first, then the items expiring soonest.
+ */
+static void evictItems(ssize needed)
+{
+    WebsKey     *sym, *next;
+    CacheItem   *item, *oldest;
+    WebsTime    now;
+
+    now = time(0);
+    if (stats.memory + needed > BIT_GOAHEAD_LIMIT_CACHE) {
+        for (sym = hashFirst(items); sym; sym = next) {
+            next = hashNext(items, sym);
+            item = sym->content.value.symbol;
+            if (item->stale <= now) {
+                removeItem(item);
+            }
+        }
+    }
+    while (stats.memory + needed > BIT_GOAHEAD_LIMIT_CACHE) {
+        oldest = 0;
+        for (sym = hashFirst(items); sym; sym = hashNext(items, sym)) {
+            item = sym->content.value.symbol;
+            if (!oldest || item->expires < oldest->expires) {
+                oldest = item;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        removeItem(oldest);
+        stats.evictions++;
+    }
+}
+
+
+static void pruneItems(void *data, int id)
+{
+    WebsKey     *sym, *next;
+    CacheItem   *item;
+    WebsTime    now;
+
+    now = time(0);
+    for (sym = hashFirst(items); sym; sym = next) {
+        next = hashNext(items, sym);
+        item = sym->content.value.symbol;
+        if (item->stale <= now) {
+            removeItem(item);
+        }
+    }
+    if (stats.items > 0) {
+        websRestartEvent(id, CACHE_PRUNE);
+    } else {
+        websStopEvent(id);
+        pruneId = -1;
+    }
+}
+
+
+/*
+    Remove an item from the cache. The item is freed when requests writing the item have finished.
+ */
+static void removeItem(CacheItem *item)
+{
+    hashDelete(items, item->key);
+    stats.items--;
+    stats.memory -= item->size;
+    releaseItem(item);
+}
+
+
+static void releaseItem(CacheItem *item)
+{
+    if (--item->refs > 0) {
+        return;
+    }
+    assert(item->waitMax == 0);
+    bufFree(&item->capture);
+    wfree(item->headers);
+    wfree(item->key);
+    wfree(item);
+}
+
+/********************************* Value Cache ********************************/
+/*
+    Cache a value for all requests. A lifespan of zero keeps the value until it is evicted.
+    Setting a null value removes the key.
+ */
+PUBLIC int websCacheSet(char *key, char *value, ssize len, int lifespan)
+{
+    ValueItem   *vp;
+    ssize       klen, size;
+
+    assert(key && *key);
+
+    if (values < 0 || key == 0) {
+        return -1;
+    }
+    if (value == 0) {
+        websCacheRemove(key);
+        return 0;
+    }
+    if (len < 0) {
+        len = slen(value);
+    }
+    klen = slen(key);
+    size = sizeof(ValueItem) + klen + len + 2;
+    if (size > BIT_GOAHEAD_LIMIT_CACHE_VALUES) {
+        return -1;
+    }
+    /*
+        Copy before removing or evicting anything as the key and value may have come from websCacheGet
+     */
+    if ((vp = walloc(size)) == 0) {
+        return -1;
+    }
+    vp->key = (char*) &vp[1];
+    vp->value = &vp->key[klen + 1];
+    memcpy(vp->key, key, klen + 1);
+    memcpy(vp->value, value, len);
+    vp->value[len] = '\0';
+    websCacheRemove(vp->key);
+    while (valueMemory + size > BIT_GOAHEAD_LIMIT_CACHE_VALUES && valueHead) {
+        /* Evict the least recently used */
+        removeValue(valueHead);
+    }
+    vp->len = len;
+    vp->size = size;
+    vp->expires = (lifespan > 0) ? time(0) + lifespan : 0;
+    if (hashEnter(values, vp->key, valueSymbol(vp), 0) == 0) {
+        wfree(vp);
+        return -1;
+    }
+    valueAppend(vp);
+    valueMemory += size;
+    if (vp->expires && valuePruneId < 0) {
+        valuePruneId = websStartEvent(CACHE_PRUNE, pruneValues, 0);
+    }
+    return 0;
+}
+
+
+/*
+    Return a cached value or null if the key is missing or expired. The value remains valid until the cache is next
+    modified or the caller returns to the event loop.
+ */
+PUBLIC char *websCacheGet(char *key, ssize *len)
+{
+    WebsKey     *sym;
+    ValueItem   *vp;
+
+    if (values < 0 || key == 0 || (sym = hashLookup(values, key)) == 0) {
+        return 0;
+    }
+    vp = sym->content.value.symbol;
+    if (vp->expires && vp->expires <= time(0)) {
+        removeValue(vp);
+        return 0;
+    }
+    if (vp != valueTail) {
+        /* Most recently used */
+        valueUnlink(vp);
+        valueAppend(vp);
+    }
+    if (len) {
+        *len = vp->len;
+    }
+    return vp->value;
+}
+
+
+PUBLIC void websCacheRemove(char *key)
+{
+    WebsKey     *sym;
+
+    if (values >= 0 && key && (sym = hashLookup(values, key)) != 0) {
+        removeValue(sym->content.value.symbol);
+    }
+}
+
+
+static void pruneValues(void *data, int id)
+{
+    ValueItem   *vp, *next;
+    WebsTime    now;
+    bool        expiring;
+
+    now = time(0);
+    expiring = 0;
+    for (vp = valueHead; vp; vp = next) {
+        next = vp->next;
+        if (vp->expires && vp->expires <= now) {
+            removeValue(vp);
+        } else if (vp->expires) {
+            expiring = 1;
+        }
+    }
+    if (expiring) {
+        websRestartEvent(id, CACHE_PRUNE);
+    } else {
+        websStopEvent(id);
+        valuePruneId = -1;
+    }
+}
+
+
+static void removeValue(ValueItem *vp)
+{
+    hashDelete(values, vp->key);
+    valueUnlink(vp);
+    valueMemory -= vp->size;
+    wfree(vp);
+}
+
+
+/*
+    Append to the tail of the LRU list
+ */
+static void valueAppend(ValueItem *vp)
+{
+    vp->next = 0;
+    vp->prev = valueTail;
+    if (valueTail) {
+        valueTail->next = vp;
+    } else {
+        valueHead = vp;
+    }
+    valueTail = vp;
+}
+
+
+static void valueUnlink(ValueItem *vp)
+{
+    if (vp->prev) {
+        vp->prev->next = vp->next;
+    } else {
+        valueHead = vp->next;
+    }
+    if (vp->next) {
+        vp->next->prev = vp->prev;
+    } else {
+        valueTail = vp->prev;
+    }
+    vp->prev = vp->next = 0;
+}
+
+#endif /* BIT_GOAHEAD_CACHE */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+ */
@@ -44,6 +44,7 @@ static int launchCgi(char *cgiPath, char **argp, char **envp, char *stdIn, char
 static bool cgiHandler(Webs *wp)
 {
     Cgi         *cgip;
+    WebsCgiState *cgi;
     WebsKey     *s;
     char        cgiPrefix[BIT_GOAHEAD_LIMIT_FILENAME], *stdIn, *stdOut, cwd[BIT_GOAHEAD_LIMIT_FILENAME];
     char        *cp, *cgiName, *cgiPath, **argp, **envp, **ep, *tok, *query, *dir, *extraPath;
@@ -51,6 +52,10 @@ static bool cgiHandler(Webs *wp)
 
     assert(websValid(wp));
     
+    if ((cgi = websGetCgiState(wp)) == 0) {
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't allocate CGI state");
+        return 1;
+    }
     websSetEnv(wp);
 
     /*
@@ -163,10 +168,10 @@ static bool cgiHandler(Webs *wp)
         Create temporary file name(s) for the child's stdin and stdout. For POST data the stdin temp file (and name)
         should already exist.  
      */
-    if (wp->cgiStdin == NULL) {
-        wp->cgiStdin = websGetCgiCommName();
+    if (cgi->cgiStdin == NULL) {
+        cgi->cgiStdin = websGetCgiCommName();
     } 
-    stdIn = wp->cgiStdin;
+    stdIn = cgi->cgiStdin;
     stdOut = websGetCgiCommName();
     /*
         Now launch the process.  If not successful, do the cleanup of resources.  If successful, the cleanup will be
@@ -214,13 +219,29 @@ PUBLIC int websCgiOpen()
 }
 
 
+/*
+    Get the CGI state for a request. The state is allocated on first use and freed with the request.
+ */
+PUBLIC WebsCgiState *websGetCgiState(Webs *wp)
+{
+    if (wp->cgi == 0) {
+        if ((wp->cgi = walloc(sizeof(WebsCgiState))) == 0) {
+            return 0;
+        }
+        wp->cgi->cgiStdin = 0;
+        wp->cgi->cgifd = -1;
+    }
+    return wp->cgi;
+}
+
+
 PUBLIC int websProcessCgiData(Webs *wp)
 {
     ssize   nbytes;
 
     nbytes = bufLen(&wp->input);
     trace(5, "cgi: write %d bytes to CGI program", nbytes);
-    if (write(wp->cgifd, wp->input.servp, (int) nbytes) != nbytes) {
+    if (write(wp->cgi->cgifd, wp->input.servp, (int) nbytes) != nbytes) {
         websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR| WEBS_CLOSE, "Can't write to CGI gateway");
         return -1;
     }
@@ -382,8 +403,8 @@ WebsTime websCgiPoll()
                 unlink(cgip->stdIn);
                 unlink(cgip->stdOut);
                 /*
-                    Free all the memory buffers pointed to by cgip. The stdin file name (wp->cgiStdin) gets freed as
-                    part of websFree().
+                    Free all the memory buffers pointed to by cgip. The stdin file name (wp->cgi->cgiStdin) gets
+                    freed as part of websFree().
                  */
                 cgiMax = wfreeHandle(&cgiList, cid);
                 for (ep = cgip->envp; ep != NULL && *ep != NULL; ep++) {
@@ -0,0 +1,450 @@
+/*
+    fiber.c -- Coroutines for action handlers
+
+    A fiber action runs on its own stack so it can wait for a descriptor, a timer or a disk read in straight line
+    code. Waiting switches back to the event loop which resumes the fiber from the socket, timer or I/O completion
+    callback. Stacks are allocated with a guard page and idle stacks are pooled to avoid mmap on each request.
+    Stack pages are only committed by the kernel when first touched, so a waiting fiber costs its struct plus the
+    stack pages it has used.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#if __APPLE__
+    /* ucontext is only declared in XSI mode on MacOS */
+    #define _XOPEN_SOURCE 600
+    #define _DARWIN_C_SOURCE 1
+#endif
+
+#include    "goahead.h"
+
+#if BIT_GOAHEAD_FIBER
+#include    <ucontext.h>
+#include    <sys/mman.h>
+
+/*********************************** Locals ***********************************/
+
+typedef struct Fiber {
+    ucontext_t      context;                /* Saved fiber registers and stack */
+    ucontext_t      caller;                 /* Context to return to when the fiber waits or completes */
+    Webs            *wp;                    /* Owning request. Null if the request was freed. */
+    WebsAction      proc;                   /* Procedure run by the fiber */
+    char            *stack;                 /* Stack mapping including the guard page */
+    ssize           stackSize;              /* Size of the stack mapping */
+    ssize           nbytes;                 /* Bytes read by websAwaitRead */
+    char            *buf;                   /* Buffer for websAwaitRead */
+    int             sid;                    /* Socket wrapping an awaited descriptor */
+    int             timer;                  /* Event to resume the fiber after a delay or timeout */
+    int             result;                 /* Result of the wait */
+    int             running;                /* Fiber is executing */
+    int             done;                   /* Fiber procedure has returned */
+    struct Fiber    *next;                  /* Next fiber in the pool */
+} Fiber;
+
+static Fiber    *pool;                      /* Idle fibers with stacks */
+static int      poolCount;                  /* Number of idle fibers */
+static Fiber    *current;                   /* Fiber being started. Read by fiberMain. */
+
+/**************************** Forward Declarations ****************************/
+
+static Fiber *allocFiber();
+static void endWait(Fiber *fiber);
+static void fiberEvent(int sid, int mask, void *data);
+#if BIT_GOAHEAD_AIO
+static void fiberRead(Webs *wp, WebsAio *aio);
+#endif
+static void fiberMain();
+static void fiberTimeout(void *data, int id);
+static void fiberWritable(Webs *wp);
+static void freeFiber(Fiber *fiber);
+static void releaseFiber(Fiber *fiber);
+static void resume(Fiber *fiber);
+static void resumeRequest(Fiber *fiber);
+static int awaitEvent(Webs *wp, int fd, int mask, int timeout);
+static int yield(Webs *wp);
+
+/************************************* Code ***********************************/
+
+PUBLIC int websStartFiber(Webs *wp, WebsAction proc)
+{
+    Fiber   *fiber;
+
+    assert(websValid(wp));
+    assert(proc);
+    assert(wp->fiber == 0);
+
+    if ((fiber = allocFiber()) == 0) {
+        return -1;
+    }
+    if (getcontext(&fiber->context) < 0) {
+        releaseFiber(fiber);
+        return -1;
+    }
+    /* The lowest page of the mapping is the guard page */
+    fiber->context.uc_stack.ss_sp = fiber->stack + getpagesize();
+    fiber->context.uc_stack.ss_size = fiber->stackSize - getpagesize();
+    fiber->context.uc_link = 0;
+    makecontext(&fiber->context, fiberMain, 0);
+
+    fiber->wp = wp;
+    fiber->proc = proc;
+    wp->fiber = fiber;
+    current = fiber;
+    resume(fiber);
+    return 0;
+}
+
+
+PUBLIC void websFiberCancel(Webs *wp)
+{
+    Fiber   *fiber;
+
+    if ((fiber = wp->fiber) == 0) {
+        return;
+    }
+    wp->fiber = 0;
+    endWait(fiber);
+    if (wp->writeData == fiberWritable) {
+        wp->writeData = 0;
+    }
+    fiber->wp = 0;
+    if (!fiber->running) {
+        /*
+            Resume the waiting fiber so the action can release its resources and return. The wait and any further
+            waits return -1 and output is discarded as the response can no longer be written.
+         */
+        wp->flags |= WEBS_FINALIZED;
+        wp->state = WEBS_COMPLETE;
+        resume(fiber);
+        if (!fiber->done) {
+            error("Fiber action did not return after its request was freed");
+        }
+    }
+}
+
+
+PUBLIC void websFiberClose()
+{
+    Fiber   *fiber;
+
+    while ((fiber = pool) != 0) {
+        pool = fiber->next;
+        freeFiber(fiber);
+    }
+    poolCount = 0;
+}
+
+
+PUBLIC int websSleep(Webs *wp, int msecs)
+{
+    Fiber   *fiber;
+
+    if ((fiber = wp->fiber) == 0 || !fiber->running || !fiber->wp) {
+        return -1;
+    }
+    fiber->timer = websStartEvent(msecs, fiberTimeout, fiber);
+    return yield(wp) < 0 ? -1 : 0;
+}
+
+
+PUBLIC int websAwaitReadable(Webs *wp, int fd, int timeout)
+{
+    assert(fd >= 0);
+    return awaitEvent(wp, fd, SOCKET_READABLE, timeout);
+}
+
+
+PUBLIC int websAwaitWritable(Webs *wp, int fd, int timeout)
+{
+    return awaitEvent(wp, fd, SOCKET_WRITABLE, timeout);
+}
+
+
+PUBLIC ssize websAwaitRead(Webs *wp, int fd, char *buf, ssize size, Offset offset)
+{
+    Fiber   *fiber;
+
+    assert(fd >= 0);
+    assert(buf);
+    assert(size > 0);
+
+    if ((fiber = wp->fiber) == 0 || !fiber->running || !fiber->wp) {
+        return -1;
+    }
+#if BIT_GOAHEAD_AIO
+    if (websAioRead(wp, fd, offset, size, fiberRead) == 0) {
+        fiber->buf = buf;
+        fiber->nbytes = 0;
+        if (yield(wp) < 0) {
+            return -1;
+        }
+        fiber->buf = 0;
+        return fiber->nbytes;
+    }
+#endif
+    return pread(fd, buf, size, offset);
+}
+
+
+/*
+    Wait for a descriptor. If fd is negative, wait for the response output to drain.
+ */
+static int awaitEvent(Webs *wp, int fd, int mask, int timeout)
+{
+    Fiber       *fiber;
+    WebsSocket  *sp;
+
+    if ((fiber = wp->fiber) == 0 || !fiber->running || !fiber->wp) {
+        return -1;
+    }
+    if (fd < 0) {
+        if (websFlush(wp)) {
+            return 1;
+        }
+        wp->writeData = fiberWritable;
+        sp = socketPtr(wp->sid);
+        socketRegisterInterest(wp->sid, sp->handlerMask | SOCKET_WRITABLE);
+    } else {
+        if ((fiber->sid = socketAlloc(0, 0, 0, 0)) < 0) {
+            return -1;
+        }
+        sp = socketPtr(fiber->sid);
+        sp->sock = fd;
+        sp->flags |= SOCKET_BORROWED;
+        socketHighestFd = max(socketHighestFd, fd);
+        socketCreateHandler(fiber->sid, mask, fiberEvent, fiber);
+    }
+    if (timeout > 0) {
+        fiber->timer = websStartEvent(timeout, fiberTimeout, fiber);
+    }
+    return yield(wp);
+}
+
+
+/*
+    Switch to the caller of resume. Returns the wait result or -1 if the request is completed while waiting.
+ */
+static int yield(Webs *wp)
+{
+    Fiber   *fiber;
+
+    fiber = wp->fiber;
+    fiber->result = -1;
+    fiber->running = 0;
+    swapcontext(&fiber->context, &fiber->caller);
+    /* Resumed */
+    return fiber->wp ? fiber->result : -1;
+}
+
+
+static void resume(Fiber *fiber)
+{
+    fiber->running = 1;
+    swapcontext(&fiber->caller, &fiber->context);
+    fiber->running = 0;
+    if (fiber->done) {
+        if (fiber->wp) {
+            fiber->wp->fiber = 0;
+        }
+        releaseFiber(fiber);
+    }
+}
+
+
+/*
+    Resume from an event that is not a request socket event. The request must be pumped and freed if closed.
+ */
+static void resumeRequest(Fiber *fiber)
+{
+    Webs    *wp;
+
+    wp = fiber->wp;
+    assert(wp);
+    resume(fiber);
+    websPump(wp);
+    if (wp->flags & WEBS_CLOSED) {
+        websFree(wp);
+    }
+}
+
+
+static void fiberMain()
+{
+    Fiber   *fiber;
+
+    fiber = current;
+    current = 0;
+    (fiber->proc)(fiber->wp);
+    fiber->done = 1;
+    setcontext(&fiber->caller);
+}
+
+
+/*
+    Remove the socket and timer used to wait
+ */
+static void endWait(Fiber *fiber)
+{
+    if (fiber->sid >= 0) {
+        socketFree(fiber->sid);
+        fiber->sid = -1;
+    }
+    if (fiber->timer >= 0) {
+        websStopEvent(fiber->timer);
+        fiber->timer = -1;
+    }
+}
+
+
+static void fiberEvent(int sid, int mask, void *data)
+{
+    Fiber   *fiber;
+
+    fiber = data;
+    endWait(fiber);
+    fiber->result = 1;
+    resumeRequest(fiber);
+}
+
+
+static void fiberTimeout(void *data, int id)
+{
+    Fiber   *fiber;
+    Webs    *wp;
+
+    fiber = data;
+    wp = fiber->wp;
+    if (wp->writeData == fiberWritable) {
+        wp->writeData = 0;
+        socketRegisterInterest(wp->sid, socketPtr(wp->sid)->handlerMask & ~SOCKET_WRITABLE);
+    }
+    endWait(fiber);
+    fiber->result = 0;
+    resumeRequest(fiber);
+}
+
+
+/*
+    Background writer called by the request socket handler once the response output has drained. The socket handler
+    pumps the request.
+ */
+static void fiberWritable(Webs *wp)
+{
+    Fiber   *fiber;
+
+    fiber = wp->fiber;
+    wp->writeData = 0;
+    socketRegisterInterest(wp->sid, socketPtr(wp->sid)->handlerMask & ~SOCKET_WRITABLE);
+    endWait(fiber);
+    fiber->result = 1;
+    resume(fiber);
+}
+
+
+#if BIT_GOAHEAD_AIO
+/*
+    I/O completion callback. The I/O dispatcher pumps the request.
+ */
+static void fiberRead(Webs *wp, WebsAio *aio)
+{
+    Fiber   *fiber;
+
+    fiber = wp->fiber;
+    if (aio->error) {
+        fiber->nbytes = -1;
+    } else {
+        fiber->nbytes = aio->nbytes;
+        memcpy(fiber->buf, aio->buf, aio->nbytes);
+    }
+    fiber->result = 1;
+    resume(fiber);
+}
+#endif
+
+
+static Fiber *allocFiber()
+{
+    Fiber   *fiber;
+    ssize   size;
+
+    if ((fiber = pool) != 0) {
+        pool = fiber->next;
+        poolCount--;
+    } else {
+        if ((fiber = walloc(sizeof(Fiber))) == 0) {
+            return 0;
+        }
+        size = getpagesize();
+        size = ((BIT_GOAHEAD_FIBER_STACK + size - 1) / size + 1) * size;
+        fiber->stack = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (fiber->stack == MAP_FAILED) {
+            wfree(fiber);
+            return 0;
+        }
+        if (mprotect(fiber->stack, getpagesize(), PROT_NONE) < 0) {
+            munmap(fiber->stack, size);
+            wfree(fiber);
+            return 0;
+        }
+        fiber->stackSize = size;
+    }
+    fiber->wp = 0;
+    fiber->proc = 0;
+    fiber->buf = 0;
+    fiber->nbytes = 0;
+    fiber->sid = -1;
+    fiber->timer = -1;
+    fiber->result = 0;
+    fiber->running = 0;
+    fiber->done = 0;
+    fiber->next = 0;
+    return fiber;
+}
+
+
+/*
+    Return a fiber to the pool
+ */
+static void releaseFiber(Fiber *fiber)
+{
+    endWait(fiber);
+    if (poolCount >= BIT_GOAHEAD_FIBER_POOL) {
+        freeFiber(fiber);
+        return;
+    }
+    fiber->wp = 0;
+    fiber->next = pool;
+    pool = fiber;
+    poolCount++;
+}
+
+
+static void freeFiber(Fiber *fiber)
+{
+    munmap(fiber->stack, fiber->stackSize);
+    wfree(fiber);
+}
+
+#endif /* BIT_GOAHEAD_FIBER */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
@@ -13,9 +13,72 @@
 static char   *websIndex;                   /* Default page name */
 static char   *websDocuments;               /* Default Web page directory */
 
+#if BIT_GOAHEAD_AIO
+#define FILE_AIO_BLOCK  (64 * 1024)         /* Size of document blocks read by the I/O threads */
+#endif
+
+#if BIT_GOAHEAD_MMAP
+#define FILE_MAP_WRITE  (BIT_GOAHEAD_LIMIT_BUFFER * 8)  /* Maximum written directly from a mapping per socket write */
+
+static sigjmp_buf       mapJump;            /* Recovery point if a mapped document is truncated */
+static volatile int     mapGuard;           /* Set while copying from a mapped document */
+static struct sigaction mapPrior;           /* SIGBUS action replaced by mapFault */
+static char             mapBuf[BIT_GOAHEAD_LIMIT_BUFFER];  /* Copy of mapped data for TLS and cache capture */
+#endif
+
+#if BIT_GOAHEAD_INDEX_REWRITE
+/*
+    Directories known to be served via the index. The value is when the directory was last checked. Entries are
+    re-checked at most once a second and discarded if the directory has been removed or replaced.
+ */
+static WebsHash indexes = -1;               /* Hash of directory filenames known to be served via the index */
+#endif
+
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+/*
+    Negative lookup cache of documents that do not exist. Repeated requests for missing documents are answered
+    with a pre-rendered 404 response. The containing directory is re-checked at most once a second and the entry is
+    discarded if the directory has been modified.
+ */
+typedef struct Missing {
+    char        *body;                      /* Pre-rendered error response body */
+    char        *dir;                       /* Nearest existing parent directory */
+    WebsTime    modified;                   /* Directory modification time when cached */
+    WebsTime    checked;                    /* When the directory was last checked */
+    WebsTime    expires;                    /* When the entry expires */
+} Missing;
+
+static WebsHash missing = -1;               /* Hash of missing filenames */
+static int      missingCount;               /* Number of missing entries */
+#endif
+
 /**************************** Forward Declarations ****************************/
 
 static void fileWriteEvent(Webs *wp);
+static bool serveDirectory(Webs *wp);
+static void serveDocument(Webs *wp, WebsFileInfo *info);
+#if BIT_GOAHEAD_AIO
+static void aioWriteEvent(Webs *wp);
+static void fileOpened(Webs *wp, WebsAio *aio);
+static void fileRead(Webs *wp, WebsAio *aio);
+#endif
+#if BIT_GOAHEAD_MMAP
+static void catchMapFaults();
+static int copyMap(char *dest, char *src, ssize len);
+static void mapFault(int signo);
+static void mapWriteEvent(Webs *wp);
+#endif
+#if BIT_GOAHEAD_INDEX_REWRITE
+static bool knownIndex(Webs *wp);
+static bool rewriteIndex(Webs *wp);
+#endif
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+static void addMissing(Webs *wp);
+static void freeMissing(Missing *mp);
+static void pruneMissing(bool all);
+static void removeMissing(char *filename);
+static bool serveMissing(Webs *wp);
+#endif
 
 /*********************************** Code *************************************/
 /*
@@ -24,9 +87,9 @@ static void fileWriteEvent(Webs *wp);
 static bool fileHandler(Webs *wp)
 {
     WebsFileInfo    info;
-    char            *tmp, *date;
+#if BIT_GOAHEAD_INDEX_REWRITE
     ssize           nchars;
-    int             code;
+#endif
 
     assert(websValid(wp));
     assert(wp->method);
@@ -42,29 +105,49 @@ static bool fileHandler(Webs *wp)
         }
     } else if (smatch(wp->method, "PUT")) {
         /* Code is already set for us by processContent() */
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+        removeMissing(wp->filename);
+#endif
         websResponse(wp, wp->code, 0);
 
     } else 
 #endif /* !BIT_ROM */
     {
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+        if (serveMissing(wp)) {
+            return 1;
+        }
+#endif
+#if BIT_GOAHEAD_INDEX_REWRITE
+        nchars = strlen(wp->path);
+        if (wp->path[nchars - 1] == '/' && knownIndex(wp)) {
+            return rewriteIndex(wp);
+        }
+#endif
+#if BIT_GOAHEAD_AIO
         /*
-            If the file is a directory, redirect using the nominated default page
+            On slow mounts, open and stat the document using the I/O threads so the event loop is not blocked
          */
-        if (websPageIsDirectory(wp)) {
-            nchars = strlen(wp->path);
-            if (wp->path[nchars - 1] == '/' || wp->path[nchars - 1] == '\\') {
-                wp->path[--nchars] = '\0';
+        if (websAioWanted(wp, -1)) {
+            if (websAioOpenFile(wp, fileOpened) < 0) {
+                websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't read document");
             }
-            tmp = sfmt("%s/%s", wp->path, websIndex);
-            websRedirect(wp, tmp);
-            wfree(tmp);
             return 1;
         }
+#endif
+        if (websPageIsDirectory(wp)) {
+            return serveDirectory(wp);
+        }
         if (websPageOpen(wp, O_RDONLY | O_BINARY, 0666) < 0) {
 #if BIT_DEBUG
             if (wp->referrer) {
                 trace(1, "From %s", wp->referrer);
             }
+#endif
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+            if (errno == ENOENT) {
+                addMissing(wp);
+            }
 #endif
             websError(wp, HTTP_CODE_NOT_FOUND, "Cannot open document for: %s", wp->path);
             return 1;
@@ -73,42 +156,200 @@ static bool fileHandler(Webs *wp)
             websError(wp, HTTP_CODE_NOT_FOUND, "Cannot stat page for URL");
             return 1;
         }
-        code = 200;
-        if (wp->since && info.mtime <= wp->since) {
-            code = 304;
-            info.size = 0;
-        }
-        websSetStatus(wp, code);
-        websWriteHeaders(wp, info.size, 0);
-        if ((date = websGetDateString(&info)) != NULL) {
-            websWriteHeader(wp, "Last-Modified", "%s", date);
-            wfree(date);
+        serveDocument(wp, &info);
+    }
+    return 1;
+}
+
+
+/*
+    Serve a directory request. Returns false if the request has been rewritten and must be rerouted.
+ */
+static bool serveDirectory(Webs *wp)
+{
+    char    *tmp;
+    ssize   nchars;
+
+    nchars = strlen(wp->path);
+#if BIT_GOAHEAD_INDEX_REWRITE
+    /*
+        If the URL has a trailing slash, internally rewrite to the default page.
+        Otherwise, redirect to add the trailing slash so relative links in the default page resolve.
+     */
+    if (wp->path[nchars - 1] == '/') {
+        hashEnter(indexes, wp->filename, valueInteger((long) time(0)), 0);
+        return rewriteIndex(wp);
+    }
+    tmp = sfmt("%s/", wp->path);
+#else
+    /*
+        Redirect using the nominated default page
+     */
+    if (wp->path[nchars - 1] == '/' || wp->path[nchars - 1] == '\\') {
+        wp->path[--nchars] = '\0';
+    }
+    tmp = sfmt("%s/%s", wp->path, websIndex);
+#endif
+    websRedirect(wp, tmp);
+    wfree(tmp);
+    return 1;
+}
+
+
+/*
+    Write the response headers and start writing the opened document
+ */
+static void serveDocument(Webs *wp, WebsFileInfo *info)
+{
+    char    *date;
+    int     code;
+#if BIT_ROM
+    char    *encoding;
+#endif
+
+    code = 200;
+    if (wp->since && info->mtime <= wp->since) {
+        code = 304;
+        info->size = 0;
+    }
+#if BIT_ROM
+    /*
+        Serve directly from the compiled page. Use the gzip variant if the client accepts it.
+     */
+    wp->rom = &websRomIndex[wp->docfd];
+    wp->romData = wp->rom->page;
+    wp->romLen = info->size;
+    if (wp->rom->gzpage && code == 200 && 
+            (encoding = websGetVar(wp, "HTTP_ACCEPT_ENCODING", 0)) != 0 && strstr(encoding, "gzip")) {
+        wp->romData = wp->rom->gzpage;
+        wp->romLen = info->size = wp->rom->gzsize;
+    }
+#endif
+    websSetStatus(wp, code);
+    websWriteHeaders(wp, info->size, 0);
+    if ((date = websGetDateString(info)) != NULL) {
+        websWriteHeader(wp, "Last-Modified", "%s", date);
+        wfree(date);
+    }
+#if BIT_ROM
+    if (wp->romData == wp->rom->gzpage) {
+        /* The gzip variant is a different entity, so it needs its own strong ETag */
+        if (wp->rom->etag) {
+            websWriteHeader(wp, "ETag", "%.*s-gzip\"", (int) slen(wp->rom->etag) - 1, wp->rom->etag);
         }
-        websWriteEndHeaders(wp);
+        websWriteHeader(wp, "Content-Encoding", "gzip");
+    } else if (wp->rom->etag) {
+        websWriteHeader(wp, "ETag", "%s", wp->rom->etag);
+    }
+    if (wp->rom->gzpage) {
+        websWriteHeader(wp, "Vary", "Accept-Encoding");
+    }
+#endif
+    websWriteEndHeaders(wp);
 
-        /*
-            All done if the browser did a HEAD request
-         */
-        if (smatch(wp->method, "HEAD")) {
-            websDone(wp);
-            return 1;
+    /*
+        All done if the browser did a HEAD request
+     */
+    if (smatch(wp->method, "HEAD")) {
+        websDone(wp);
+        return;
+    }
+    if (info->size > 0) {
+#if BIT_GOAHEAD_AIO
+        if (websAioWanted(wp, info->size)) {
+            if (websAioRead(wp, wp->docfd, 0, FILE_AIO_BLOCK, fileRead) < 0) {
+                wp->flags &= ~WEBS_KEEP_ALIVE;
+                websDone(wp);
+                return;
+            }
+            websSetBackgroundWriter(wp, aioWriteEvent);
+            return;
         }
-        if (info.size > 0) {
-            websSetBackgroundWriter(wp, fileWriteEvent);
-        } else {
-            websDone(wp);
+#endif
+#if BIT_GOAHEAD_MMAP
+        if ((wp->map = websMapFile(wp->filename, wp->docfd, info)) != 0) {
+            websPageClose(wp);
+            websSetBackgroundWriter(wp, mapWriteEvent);
+            return;
+        }
+#endif
+        websSetBackgroundWriter(wp, fileWriteEvent);
+    } else {
+        websDone(wp);
+    }
+}
+
+
+#if BIT_GOAHEAD_INDEX_REWRITE
+/*
+    Test if the request is for a directory known to be served via the index
+ */
+static bool knownIndex(Webs *wp)
+{
+    WebsKey         *sp;
+    WebsFileInfo    info;
+    WebsTime        now;
+
+    if ((sp = hashLookup(indexes, wp->filename)) == 0) {
+        return 0;
+    }
+    now = time(0);
+    if (sp->content.value.integer != now) {
+        if (websStatFile(wp->filename, &info) < 0 || !info.isDir) {
+            hashDelete(indexes, wp->filename);
+            return 0;
         }
+        sp->content.value.integer = (long) now;
     }
     return 1;
 }
 
 
+/*
+    Reroute a directory request to the default page. Returns false so the request is rerouted.
+ */
+static bool rewriteIndex(Webs *wp)
+{
+    char    *url;
+
+    url = sfmt("%s%s", wp->path, websIndex);
+    if (websRewriteRequest(wp, url) < 0) {
+        wfree(url);
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't rewrite request");
+        return 1;
+    }
+    wfree(url);
+    return 0;
+}
+#endif
+
+
 /*
     Do output back to the browser in the background. This is a socket write handler.
     This bypasses the output buffer and writes directly to the socket.
  */
 static void fileWriteEvent(Webs *wp)
 {
+#if BIT_ROM
+    ssize   wrote;
+
+    assert(wp);
+    assert(websValid(wp));
+
+    /*
+        Write straight from the compiled page without copying
+     */
+    while (wp->romLen > 0) {
+        if ((wrote = websWriteSocket(wp, (char*) wp->romData, wp->romLen)) <= 0) {
+            break;
+        }
+        wp->romData += wrote;
+        wp->romLen -= wrote;
+    }
+    if (wp->romLen <= 0) {
+        websDone(wp);
+    }
+#else
     char    *buf;
     ssize   len, wrote;
 
@@ -135,9 +376,334 @@ static void fileWriteEvent(Webs *wp)
     if (len <= 0) {
         websDone(wp);
     }
+#endif
 }
 
 
+#if BIT_GOAHEAD_MMAP
+/*
+    Write a memory mapped document. Plain sockets are written directly from the mapping. If the document is truncated,
+    the kernel fails the send with EFAULT rather than raising SIGBUS. Direct writes are bounded to FILE_MAP_WRITE so
+    lengths past 4GB never reach the socket layer. TLS and cache capture read the data in user space, so each block is
+    first copied with the SIGBUS guard armed. In either case a truncated document abandons the response and closes
+    the connection.
+ */
+static void mapWriteEvent(Webs *wp)
+{
+    WebsMap     *map;
+    ssize       len, wrote;
+    bool        direct, truncated;
+
+    assert(wp);
+    assert(websValid(wp));
+    assert(wp->map);
+
+    map = wp->map;
+    direct = !(wp->flags & WEBS_SECURE);
+#if BIT_GOAHEAD_CACHE
+    if (wp->cache) {
+        direct = 0;
+    }
+#endif
+    wrote = 0;
+    truncated = 0;
+    while (wp->mapPos < map->size) {
+        if (direct) {
+            len = min(map->size - wp->mapPos, (ssize) FILE_MAP_WRITE);
+            wrote = websWriteSocket(wp, &map->data[wp->mapPos], len);
+            truncated = (wrote < 0 && errno == EFAULT);
+        } else {
+            len = min(map->size - wp->mapPos, (ssize) sizeof(mapBuf));
+            if (copyMap(mapBuf, &map->data[wp->mapPos], len) < 0) {
+                wrote = -1;
+                truncated = 1;
+            } else {
+                wrote = websWriteSocket(wp, mapBuf, len);
+            }
+        }
+        if (wrote <= 0) {
+            break;
+        }
+        wp->mapPos += wrote;
+    }
+    if (truncated) {
+        error("Document %s truncated while being served", wp->filename);
+        websInvalidateMap(map);
+    }
+    if (wrote < 0) {
+        wp->flags &= ~WEBS_KEEP_ALIVE;
+        websDone(wp);
+    } else if (wp->mapPos >= map->size) {
+        websDone(wp);
+    }
+}
+
+
+/*
+    Copy from a mapped document. Returns -1 if the document has been truncated and the copy faulted.
+    The guard is armed only for the copy. SIGBUS is not blocked in mapFault, so the signal mask need not be restored.
+ */
+static int copyMap(char *dest, char *src, ssize len)
+{
+    if (sigsetjmp(mapJump, 0) != 0) {
+        return -1;
+    }
+    mapGuard = 1;
+    memcpy(dest, src, len);
+    mapGuard = 0;
+    return 0;
+}
+
+
+/*
+    Install the SIGBUS handler once. It is kept across websClose and websOpen.
+ */
+static void catchMapFaults()
+{
+    struct sigaction    act;
+    static int          installed = 0;
+
+    if (installed) {
+        return;
+    }
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = mapFault;
+    act.sa_flags = SA_NODEFER;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGBUS, &act, &mapPrior);
+    installed = 1;
+}
+
+
+static void mapFault(int signo)
+{
+    if (mapGuard) {
+        mapGuard = 0;
+        siglongjmp(mapJump, 1);
+    }
+    /* Not a guarded copy. Restore the prior action and redeliver. */
+    sigaction(SIGBUS, &mapPrior, 0);
+    raise(SIGBUS);
+}
+#endif
+
+
+#if BIT_GOAHEAD_AIO
+/*
+    Completion callback when a document has been opened by the I/O threads
+ */
+static void fileOpened(Webs *wp, WebsAio *aio)
+{
+    if (aio->error) {
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+        if (aio->error == ENOENT) {
+            addMissing(wp);
+        }
+#endif
+        websError(wp, HTTP_CODE_NOT_FOUND, "Cannot open document for: %s", wp->path);
+        return;
+    }
+    if (aio->info.isDir) {
+        if (!serveDirectory(wp)) {
+            /* Rewritten to the index. Reroute when the request is pumped. */
+            wp->flags &= ~WEBS_REROUTE;
+            wp->state = WEBS_READY;
+        }
+        return;
+    }
+    wp->docfd = aio->fd;
+    aio->fd = -1;
+    serveDocument(wp, &aio->info);
+}
+
+
+/*
+    Completion callback when a document block has been read by the I/O threads
+ */
+static void fileRead(Webs *wp, WebsAio *aio)
+{
+    WebsSocket  *sp;
+
+    if (aio->error || (aio->nbytes == 0 && aio->offset < wp->txLen)) {
+        error("Can't read document %s, errno %d", wp->filename, aio->error);
+        wp->flags &= ~WEBS_KEEP_ALIVE;
+        websDone(wp);
+    } else if (aio->nbytes == 0) {
+        websDone(wp);
+    } else {
+        wp->aioPos = 0;
+        sp = socketPtr(wp->sid);
+        socketRegisterInterest(wp->sid, sp->handlerMask | SOCKET_WRITABLE);
+        if (bufLen(&wp->output) == 0) {
+            aioWriteEvent(wp);
+        }
+    }
+}
+
+
+/*
+    Write document blocks read by the I/O threads. Writable events are suspended while the next block is read.
+ */
+static void aioWriteEvent(Webs *wp)
+{
+    WebsAio     *aio;
+    WebsSocket  *sp;
+    ssize       wrote;
+
+    assert(wp);
+    assert(websValid(wp));
+    assert(wp->aio);
+
+    aio = wp->aio;
+    if (!aio->busy) {
+        while (wp->aioPos < aio->nbytes) {
+            if ((wrote = websWriteSocket(wp, &aio->buf[wp->aioPos], aio->nbytes - wp->aioPos)) < 0) {
+                wp->flags &= ~WEBS_KEEP_ALIVE;
+                websDone(wp);
+                return;
+            } else if (wrote == 0) {
+                return;
+            }
+            wp->aioPos += wrote;
+        }
+        if (websAioRead(wp, wp->docfd, aio->offset + aio->nbytes, FILE_AIO_BLOCK, fileRead) < 0) {
+            wp->flags &= ~WEBS_KEEP_ALIVE;
+            websDone(wp);
+            return;
+        }
+    }
+    sp = socketPtr(wp->sid);
+    socketRegisterInterest(wp->sid, sp->handlerMask & ~SOCKET_WRITABLE);
+}
+#endif
+
+
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+/*
+    Answer a request for a known missing document from memory. Return true if the request was served.
+ */
+static bool serveMissing(Webs *wp)
+{
+    WebsKey         *sp;
+    WebsFileInfo    info;
+    Missing         *mp;
+    WebsTime        now;
+
+    if ((sp = hashLookup(missing, wp->filename)) == 0) {
+        return 0;
+    }
+    mp = sp->content.value.symbol;
+    now = time(0);
+    if (now >= mp->expires) {
+        removeMissing(wp->filename);
+        return 0;
+    }
+    if (now != mp->checked) {
+        if (websStatFile(mp->dir, &info) < 0 || info.mtime != mp->modified) {
+            removeMissing(wp->filename);
+            return 0;
+        }
+        mp->checked = now;
+    }
+    if (wp->rxRemaining) {
+        wp->flags &= ~WEBS_KEEP_ALIVE;
+    }
+    websResponse(wp, HTTP_CODE_NOT_FOUND, mp->body);
+    return 1;
+}
+
+
+/*
+    Remember that the requested document does not exist
+ */
+static void addMissing(Webs *wp)
+{
+    WebsFileInfo    info;
+    Missing         *mp;
+    WebsTime        now;
+    char            *dir, *cp, *msg;
+
+    if (missingCount >= BIT_GOAHEAD_LIMIT_MISSING) {
+        pruneMissing(0);
+        if (missingCount >= BIT_GOAHEAD_LIMIT_MISSING) {
+            return;
+        }
+    }
+    /*
+        Find the nearest existing parent directory. Creating the document (or any missing parent) will modify it.
+     */
+    dir = sclone(wp->filename);
+    while ((cp = strrchr(dir, '/')) != 0 && cp > dir) {
+        *cp = '\0';
+        if (websStatFile(dir, &info) == 0) {
+            break;
+        }
+    }
+    now = time(0);
+    /*
+        Don't trust a directory modified this second as a later change in the same second would not alter the mtime
+     */
+    if (!cp || cp == dir || !info.isDir || info.mtime >= now) {
+        wfree(dir);
+        return;
+    }
+    if ((mp = walloc(sizeof(Missing))) == 0) {
+        wfree(dir);
+        return;
+    }
+    mp->dir = dir;
+    msg = sfmt("Cannot open document for: %s", wp->path);
+    mp->body = websErrorPage(HTTP_CODE_NOT_FOUND, msg);
+    wfree(msg);
+    mp->modified = info.mtime;
+    mp->checked = now;
+    mp->expires = now + BIT_GOAHEAD_MISSING_LIFESPAN;
+    hashEnter(missing, wp->filename, valueSymbol(mp), 0);
+    missingCount++;
+}
+
+
+static void removeMissing(char *filename)
+{
+    WebsKey     *sp;
+
+    if ((sp = hashLookup(missing, filename)) != 0) {
+        freeMissing(sp->content.value.symbol);
+        hashDelete(missing, filename);
+        missingCount--;
+    }
+}
+
+
+/*
+    Remove expired entries, or all entries
+ */
+static void pruneMissing(bool all)
+{
+    WebsKey     *sp, *next;
+    Missing     *mp;
+    WebsTime    now;
+
+    now = time(0);
+    for (sp = hashFirst(missing); sp; sp = next) {
+        next = hashNext(missing, sp);
+        mp = sp->content.value.symbol;
+        if (all || now >= mp->expires) {
+            removeMissing(sp->name.value.string);
+        }
+    }
+}
+
+
+static void freeMissing(Missing *mp)
+{
+    wfree(mp->body);
+    wfree(mp->dir);
+    wfree(mp);
+}
+#endif /* BIT_GOAHEAD_LIMIT_MISSING */
+
+
 #if !BIT_ROM
 PUBLIC int websProcessPutData(Webs *wp)
 {
@@ -165,6 +731,19 @@ PUBLIC int websProcessPutData(Webs *wp)
 
 static void fileClose()
 {
+#if BIT_GOAHEAD_INDEX_REWRITE
+    if (indexes >= 0) {
+        hashFree(indexes);
+        indexes = -1;
+    }
+#endif
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+    if (missing >= 0) {
+        pruneMissing(1);
+        hashFree(missing);
+        missing = -1;
+    }
+#endif
     wfree(websIndex);
     websIndex = NULL;
     wfree(websDocuments);
@@ -175,6 +754,16 @@ static void fileClose()
 PUBLIC void websFileOpen()
 {
     websIndex = sclone("index.html");
+#if BIT_GOAHEAD_MMAP
+    catchMapFaults();
+#endif
+#if BIT_GOAHEAD_INDEX_REWRITE
+    indexes = hashCreate(-1);
+#endif
+#if BIT_GOAHEAD_LIMIT_MISSING > 0
+    missing = hashCreate(-1);
+    missingCount = 0;
+#endif
     websDefineHandler("file", fileHandler, fileClose, 0);
 }
 
@@ -8,30 +8,63 @@
 
 #include    "goahead.h"
 
-/******************************** Local Data **********************************/
+#if BIT_GOAHEAD_OPENAT && LINUX
+    #include    <sys/syscall.h>
+#endif
 
-#if BIT_ROM
-static WebsHash romFs;             /* Symbol table for web pages */
+/*********************************** Defines **********************************/
+
+#if BIT_GOAHEAD_MMAP
+#define MAP_PRUNE       (10 * 1000)         /* Unmap unused documents after 10 seconds */
+
+static WebsHash maps = -1;                  /* Hash of shared document mappings */
+static int      mapPruneId = -1;            /* Map prune timer */
+
+static void freeMap(WebsMap *map);
+static void pruneMaps(void *data, int id);
+#endif
+
+#if BIT_GOAHEAD_OPENAT
+/*
+    Open documents directory. The path is re-checked at most once a second and the directory reopened if it has been
+    replaced or removed.
+ */
+typedef struct DirFd {
+    int         fd;                         /* Directory descriptor */
+    dev_t       dev;                        /* Device of the directory when opened */
+    ino_t       ino;                        /* Inode of the directory when opened */
+    WebsTime    checked;                    /* When the path was last checked */
+} DirFd;
+
+static WebsHash dirs = -1;                  /* Hash of open documents directory descriptors */
+static int      *retired;                   /* Descriptors of replaced directories */
+static int      retiredCount;               /* Number of retired descriptors */
+
+static void retireDir(int fd);
+
+#if LINUX && defined(SYS_openat2)
+/*
+    Argument to openat2. Defined here as older C libraries do not provide linux/openat2.h.
+ */
+typedef struct OpenHow {
+    uint64      flags;
+    uint64      mode;
+    uint64      resolve;
+} OpenHow;
+
+#define OPEN_RESOLVE_BENEATH    0x08        /* Reject paths that resolve outside the directory */
+
+static int hasOpenat2 = 1;                  /* Cleared if the kernel does not support openat2 */
+#endif
 #endif
 
 /*********************************** Code *************************************/
 
 PUBLIC int websFsOpen()
 {
-#if BIT_ROM
-    WebsRomIndex    *wip;
-    char            name[BIT_GOAHEAD_LIMIT_FILENAME];
-    ssize           len;
-
-    romFs = hashCreate(WEBS_HASH_INIT);
-    for (wip = websRomIndex; wip->path; wip++) {
-        strncpy(name, wip->path, BIT_GOAHEAD_LIMIT_FILENAME);
-        len = strlen(name) - 1;
-        if (len > 0 &&
-            (name[len] == '/' || name[len] == '\\')) {
-            name[len] = '\0';
-        }
-        hashEnter(romFs, name, valueSymbol(wip), 0);
+#if BIT_GOAHEAD_MMAP
+    if ((maps = hashCreate(-1)) < 0) {
+        return -1;
     }
 #endif
     return 0;
@@ -40,22 +73,226 @@ PUBLIC int websFsOpen()
 
 PUBLIC void websFsClose()
 {
-#if BIT_ROM
-    hashFree(romFs);
+#if BIT_GOAHEAD_MMAP || BIT_GOAHEAD_OPENAT
+    WebsKey     *sp, *next;
+#endif
+#if BIT_GOAHEAD_OPENAT
+    DirFd       *dp;
+#endif
+#if BIT_GOAHEAD_MMAP
+    WebsMap     *map;
+
+    if (mapPruneId >= 0) {
+        websStopEvent(mapPruneId);
+        mapPruneId = -1;
+    }
+    if (maps >= 0) {
+        for (sp = hashFirst(maps); sp; sp = next) {
+            next = hashNext(maps, sp);
+            map = sp->content.value.symbol;
+            map->detached = 1;
+            if (map->refs == 0) {
+                freeMap(map);
+            }
+        }
+        hashFree(maps);
+        maps = -1;
+    }
+#endif
+#if BIT_GOAHEAD_OPENAT
+    if (dirs >= 0) {
+        for (sp = hashFirst(dirs); sp; sp = next) {
+            next = hashNext(dirs, sp);
+            dp = sp->content.value.symbol;
+            close(dp->fd);
+            wfree(dp);
+        }
+        hashFree(dirs);
+        dirs = -1;
+    }
+    while (retiredCount > 0) {
+        close(retired[--retiredCount]);
+    }
+    wfree(retired);
+    retired = 0;
 #endif
 }
 
 
+#if BIT_GOAHEAD_MMAP
+PUBLIC WebsMap *websMapFile(char *path, int fd, WebsFileInfo *info)
+{
+    WebsKey     *sp;
+    WebsMap     *map;
+    void        *data;
+    int         mapfd;
+
+    assert(path && *path);
+    assert(info);
+
+    if (maps < 0 || info->size <= 0 || info->size > MAXSSIZE) {
+        return 0;
+    }
+    if ((sp = hashLookup(maps, path)) != 0) {
+        map = sp->content.value.symbol;
+        if (map->size == (ssize) info->size && map->mtime == info->mtime) {
+            map->refs++;
+            map->lastUsed = time(0);
+            return map;
+        }
+        /* Document has changed */
+        websInvalidateMap(map);
+    }
+    if ((mapfd = fd) < 0 && (mapfd = open(path, O_RDONLY | O_BINARY, 0)) < 0) {
+        return 0;
+    }
+    data = mmap(0, info->size, PROT_READ, MAP_SHARED, mapfd, 0);
+    if (mapfd != fd) {
+        close(mapfd);
+    }
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+    if ((map = walloc(sizeof(WebsMap))) == 0) {
+        munmap(data, info->size);
+        return 0;
+    }
+    map->path = sclone(path);
+    map->data = data;
+    map->size = info->size;
+    map->mtime = info->mtime;
+    map->lastUsed = time(0);
+    map->refs = 1;
+    map->detached = 0;
+    hashEnter(maps, path, valueSymbol(map), 0);
+    if (mapPruneId < 0) {
+        mapPruneId = websStartEvent(MAP_PRUNE, pruneMaps, 0);
+    }
+    return map;
+}
+
+
+PUBLIC void websUnmapFile(WebsMap *map)
+{
+    assert(map);
+    assert(map->refs > 0);
+
+    if (--map->refs == 0 && map->detached) {
+        freeMap(map);
+    }
+}
+
+
+PUBLIC void websInvalidateMap(WebsMap *map)
+{
+    assert(map);
+
+    if (!map->detached) {
+        hashDelete(maps, map->path);
+        map->detached = 1;
+        if (map->refs == 0) {
+            freeMap(map);
+        }
+    }
+}
+
+
+static void freeMap(WebsMap *map)
+{
+    munmap(map->data, map->size);
+    wfree(map->path);
+    wfree(map);
+}
+
+
+/*
+    Unmap documents that have not been used recently
+ */
+static void pruneMaps(void *data, int id)
+{
+    WebsKey     *sp, *next;
+    WebsMap     *map;
+    WebsTime    when;
+
+    when = time(0) - MAP_PRUNE / 1000;
+    for (sp = hashFirst(maps); sp; sp = next) {
+        next = hashNext(maps, sp);
+        map = sp->content.value.symbol;
+        if (map->refs == 0 && map->lastUsed <= when) {
+            websInvalidateMap(map);
+        }
+    }
+    if (hashFirst(maps)) {
+        websRestartEvent(id, MAP_PRUNE);
+    } else {
+        websStopEvent(id);
+        mapPruneId = -1;
+    }
+}
+#endif /* BIT_GOAHEAD_MMAP */
+
+
+#if BIT_ROM
+/*
+    FNV-1a hash. This must match the hash used by webcomp.
+ */
+static uint hashRomPath(char *path, uint seed)
+{
+    uint    hash;
+
+    hash = 2166136261U ^ seed;
+    while (*path) {
+        hash ^= (uchar) *path++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/*
+    Lookup a ROM document using the collision free hash generated by webcomp
+ */
+PUBLIC WebsRomIndex *websLookupRom(char *path)
+{
+    WebsRomIndex    *wip;
+    char            name[BIT_GOAHEAD_LIMIT_FILENAME];
+    ssize           len;
+    uint            seed;
+    int             index;
+
+    assert(path);
+
+    if (websRomHashSize <= 0) {
+        return 0;
+    }
+    /*
+        Directories are compiled without a trailing separator
+     */
+    len = slen(path);
+    if (len > 1 && len < BIT_GOAHEAD_LIMIT_FILENAME && (path[len - 1] == '/' || path[len - 1] == '\\')) {
+        memcpy(name, path, len - 1);
+        name[len - 1] = '\0';
+        path = name;
+    }
+    seed = websRomHashSeeds[hashRomPath(path, 0) & (websRomHashBuckets - 1)];
+    if ((index = websRomHash[hashRomPath(path, seed) & (websRomHashSize - 1)]) < 0) {
+        return 0;
+    }
+    wip = &websRomIndex[index];
+    return strcmp(wip->path, path) == 0 ? wip : 0;
+}
+#endif
+
+
 PUBLIC int websOpenFile(char *path, int flags, int mode)
 {
 #if BIT_ROM
     WebsRomIndex    *wip;
-    WebsKey         *sp;
 
-    if ((sp = hashLookup(romFs, path)) == NULL) {
+    if ((wip = websLookupRom(path)) == NULL) {
+        errno = ENOENT;
         return -1;
     }
-    wip = (WebsRomIndex*) sp->content.value.symbol;
     wip->pos = 0;
     return (int) (wip - websRomIndex);
 #else
@@ -64,6 +301,125 @@ PUBLIC int websOpenFile(char *path, int flags, int mode)
 }
 
 
+#if BIT_GOAHEAD_OPENAT
+PUBLIC int websGetDirFd(char *dir)
+{
+    WebsKey     *sp;
+    WebsStat    s;
+    DirFd       *dp;
+    WebsTime    now;
+    int         fd;
+
+    if (!dir || !*dir) {
+        return -1;
+    }
+    if (dirs < 0 && (dirs = hashCreate(-1)) < 0) {
+        return -1;
+    }
+    now = time(0);
+    if ((sp = hashLookup(dirs, dir)) != 0) {
+        dp = sp->content.value.symbol;
+        if (dp->checked == now) {
+            return dp->fd;
+        }
+        if (stat(dir, &s) == 0 && s.st_dev == dp->dev && s.st_ino == dp->ino) {
+            dp->checked = now;
+            return dp->fd;
+        }
+        /* The directory has been replaced or removed */
+        retireDir(dp->fd);
+        wfree(dp);
+        hashDelete(dirs, dir);
+    }
+    if ((fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0) {
+        return -1;
+    }
+    if (fstat(fd, &s) < 0 || (dp = walloc(sizeof(DirFd))) == 0) {
+        close(fd);
+        return -1;
+    }
+    dp->fd = fd;
+    dp->dev = s.st_dev;
+    dp->ino = s.st_ino;
+    dp->checked = now;
+    hashEnter(dirs, dir, valueSymbol(dp), 0);
+    return fd;
+}
+
+
+/*
+    Requests in progress and the I/O threads may still be using the descriptor of a replaced directory, so it is kept
+    open until websFsClose. Directories are rarely replaced.
+ */
+static void retireDir(int fd)
+{
+    int     *fds;
+
+    if ((fds = wrealloc(retired, (retiredCount + 1) * sizeof(int))) == 0) {
+        return;
+    }
+    retired = fds;
+    retired[retiredCount++] = fd;
+}
+
+
+/*
+    Skip the leading "/" of a request path. The directory itself is "."
+ */
+static char *relativePath(char *path)
+{
+    while (*path == '/') {
+        path++;
+    }
+    return *path ? path : ".";
+}
+
+
+PUBLIC int websOpenFileAt(int dirfd, char *path, int flags, int mode)
+{
+#if LINUX && defined(SYS_openat2)
+    OpenHow     how;
+    int         fd;
+#endif
+
+    assert(dirfd >= 0);
+    assert(path);
+
+    path = relativePath(path);
+#if LINUX && defined(SYS_openat2)
+    if (hasOpenat2) {
+        memset(&how, 0, sizeof(how));
+        how.flags = (uint64) flags;
+        how.mode = (flags & O_CREAT) ? (uint64) mode : 0;
+        how.resolve = OPEN_RESOLVE_BENEATH;
+        if ((fd = (int) syscall(SYS_openat2, dirfd, path, &how, sizeof(how))) >= 0 || errno != ENOSYS) {
+            return fd;
+        }
+        hasOpenat2 = 0;
+    }
+#endif
+    return openat(dirfd, path, flags, mode);
+}
+
+
+PUBLIC int websStatFileAt(int dirfd, char *path, WebsFileInfo *sbuf)
+{
+    WebsStat    s;
+
+    assert(dirfd >= 0);
+    assert(path);
+
+    if (fstatat(dirfd, relativePath(path), &s, 0) < 0) {
+        return -1;
+    }
+    sbuf->size = (Offset) s.st_size;
+    sbuf->mtime = s.st_mtime;
+    sbuf->isDir = s.st_mode & S_IFDIR;
+    return 0;
+}
+#endif
+
+
 PUBLIC void websCloseFile(int fd)
 {
     if (fd >= 0) {
@@ -78,16 +434,15 @@ PUBLIC int websStatFile(char *path, WebsFileInfo *sbuf)
 {
 #if BIT_ROM
     WebsRomIndex    *wip;
-    WebsKey         *sp;
 
     assert(path && *path);
 
-    if ((sp = hashLookup(romFs, path)) == NULL) {
+    if ((wip = websLookupRom(path)) == NULL) {
         return -1;
     }
-    wip = (WebsRomIndex*) sp->content.value.symbol;
     memset(sbuf, 0, sizeof(WebsFileInfo));
     sbuf->size = wip->size;
+    sbuf->mtime = wip->mtime;
     if (wip->page == NULL) {
         sbuf->isDir = 1;
     }
@@ -97,7 +452,7 @@ PUBLIC int websStatFile(char *path, WebsFileInfo *sbuf)
     if (stat(path, &s) < 0) {
         return -1;
     }
-    sbuf->size = (ssize) s.st_size;
+    sbuf->size = (Offset) s.st_size;
     sbuf->mtime = s.st_mtime;
     sbuf->isDir = s.st_mode & S_IFDIR;                                                                     
     return 0;  
@@ -8,6 +8,7 @@
         --home directory       # Change to directory to run
         --log logFile:level    # Log to file file at verbosity level
         --route routeFile      # Route configuration file
+        --stats statsFile      # Publish statistics for goahead-stat
         --verbose              # Same as --log stderr:2
         --version              # Output version information
 
@@ -42,7 +43,7 @@ static void sigHandler(int signo);
 
 MAIN(goahead, int argc, char **argv, char **envp)
 {
-    char  *argp, *home, *documents, *endpoints, *endpoint, *route, *auth, *tok;
+    char  *argp, *home, *documents, *endpoints, *endpoint, *route, *auth, *stats, *tok;
     int     argind;
 
 #if WINDOWS
@@ -52,6 +53,7 @@ MAIN(goahead, int argc, char **argv, char **envp)
 #endif
     route = "route.txt";
     auth = "auth.txt";
+    stats = 0;
 
     for (argind = 1; argind < argc; argind++) {
         argp = argv[argind];
@@ -84,6 +86,10 @@ MAIN(goahead, int argc, char **argv, char **envp)
         } else if (smatch(argp, "--route") || smatch(argp, "-r")) {
             route = argv[++argind];
 
+        } else if (smatch(argp, "--stats")) {
+            if (argind + 1 >= argc) usage();
+            stats = argv[++argind];
+
         } else if (smatch(argp, "--version") || smatch(argp, "-V")) {
             printf("%s-%s\n", BIT_VERSION, BIT_BUILD_NUMBER);
             exit(0);
@@ -143,6 +149,15 @@ MAIN(goahead, int argc, char **argv, char **envp)
         }
     }
 #endif
+    if (stats) {
+#if BIT_GOAHEAD_STATS
+        if (websOpenStats(stats) < 0) {
+            return -1;
+        }
+#else
+        error("Statistics are not enabled in this build");
+#endif
+    }
     websServiceEvents(&finished);
     logmsg(1, "Instructed to exit");
     websClose();
@@ -184,6 +199,7 @@ static void usage() {
         "    --home directory       # Change to directory to run\n"
         "    --log logFile:level    # Log to file file at verbosity level\n"
         "    --route routeFile      # Route configuration file\n"
+        "    --stats statsFile      # Publish statistics for goahead-stat\n"
         "    --verbose              # Same as --log stderr:2\n"
         "    --version              # Output version information\n\n",
         BIT_TITLE, BIT_PRODUCT);
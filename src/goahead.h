@@ -30,6 +30,26 @@
         #error "Ecos does not support CGI. Disable BIT_GOAHEAD_CGI"
     #endif
 #endif /* ECOS */
+#if BIT_GOAHEAD_IO_URING && !LINUX
+    #undef BIT_GOAHEAD_IO_URING
+    #define BIT_GOAHEAD_IO_URING 0              /**< io_uring is only available on Linux */
+#endif
+#if BIT_GOAHEAD_MMAP && (BIT_ROM || !BIT_UNIX_LIKE)
+    #undef BIT_GOAHEAD_MMAP
+    #define BIT_GOAHEAD_MMAP 0                  /**< Memory mapped files require a Unix file system */
+#endif
+#if BIT_GOAHEAD_OPENAT && (BIT_ROM || !BIT_UNIX_LIKE)
+    #undef BIT_GOAHEAD_OPENAT
+    #define BIT_GOAHEAD_OPENAT 0                /**< Directory relative file access requires openat */
+#endif
+#if BIT_GOAHEAD_AIO && (BIT_ROM || !BIT_UNIX_LIKE)
+    #undef BIT_GOAHEAD_AIO
+    #define BIT_GOAHEAD_AIO 0                   /**< The I/O thread pool requires Unix threads and a file system */
+#endif
+#if BIT_GOAHEAD_FIBER && !BIT_UNIX_LIKE
+    #undef BIT_GOAHEAD_FIBER
+    #define BIT_GOAHEAD_FIBER 0                 /**< Fibers require ucontext */
+#endif
 
 #if QNX
     typedef long fd_mask;
@@ -815,6 +835,7 @@ PUBLIC WebsKey *hashNext(WebsHash id, WebsKey *last);
 #define SOCKET_BUFFERED_READ    0x200   /**< Message pending on this socket */
 #define SOCKET_BUFFERED_WRITE   0x400   /**< Message pending on this socket */
 #define SOCKET_NODELAY          0x800   /**< Disable Nagle algorithm */
+#define SOCKET_BORROWED         0x1000  /**< Descriptor is owned by the caller and not closed by socketFree */
 
 #define SOCKET_PORT_MAX         0xffff  /* Max Port size */
 
@@ -863,21 +884,27 @@ typedef int (*SocketAccept)(int sid, char *ipaddr, int port, int listenSid);
     socketSelect socketGetHandle socketSetBlock socketGetBlock socketAlloc socketFree socketGetError
     socketPtr socketWaitForEvent socketRegisterInterest
     @defgroup WebsSocket WebsSocket
+    @remarks Socket structures are allocated from contiguous slabs indexed by socket ID and are never moved. The fields
+        read by the event loop for every socket are placed first so a scan touches one cache line per socket.
  */
 typedef struct WebsSocket {
-    WebsBuf         lineBuf;            /**< Line ring queue */
-    SocketAccept    accept;             /**< Accept handler */
+    Socket          sock;               /**< Actual socket handle */
+    int             handlerMask;        /**< Handler events of interest */
+    int             currentEvents;      /**< Mask of ready events (FD_xx) */
+    int             flags;              /**< Current state flags */
+    int             sid;                /**< Index into socket[]. Set to -1 when the slot is free. */
+#if BIT_GOAHEAD_IO_URING
+    int             ringMask;           /**< Poll events currently armed in the io_uring */
+    uint            ringSeq;            /**< Sequence number of the armed poll request */
+#endif
     SocketHandler   handler;            /**< User I/O handler */
-    char            *ip;                /**< Server listen address or remote client address */
     void            *handler_data;      /**< User handler data */
-    int             handlerMask;        /**< Handler events of interest */
-    int             sid;                /**< Index into socket[] */
+    SocketAccept    accept;             /**< Accept handler */
+    char            *ip;                /**< Server listen address or remote client address */
+    WebsBuf         lineBuf;            /**< Line ring queue */
     int             port;               /**< Port to listen on */
-    int             flags;              /**< Current state flags */
-    Socket          sock;               /**< Actual socket handle */
     int             fileHandle;         /**< ID of the file handler */
     int             interestEvents;     /**< Mask of events to watch for */
-    int             currentEvents;      /**< Mask of ready events (FD_xx) */
     int             selectEvents;       /**< Events being selected */
     int             saveMask;           /**< saved Mask for socketFlush */
     int             error;              /**< Last error */
@@ -891,6 +918,12 @@ typedef struct WebsSocket {
  */
 PUBLIC WebsSocket **socketList;         /* List of open sockets */
 
+/**
+    Highest file descriptor of the open sockets. Used by select based event notification.
+    @ingroup WebsSocket
+ */
+PUBLIC_DATA Socket socketHighestFd;
+
 /**
     Extract the numerical IP address and port for the given socket info
     @param addr Reference to the socket address.
@@ -937,15 +970,24 @@ PUBLIC void socketCloseConnection(int sid);
 
 /**
     Connect to a server and create a new socket
+    @description For non-blocking sockets, the connection completes in the background and the socket is flagged
+        with SOCKET_CONNECTING. Wait for the socket to become writable and then call socketConnected to test the result.
     @param host Host IP address.
     @param port Port number to connect to
     @param flags Set to SOCKET_BLOCK for blocking I/O. Otherwise non-blocking I/O is used.
-    @return True if the address is an IPv6 address.
+    @return Socket ID handle. Returns -1 if the connection cannot be initiated.
     @ingroup WebsSocket
-    @internal
  */
 PUBLIC int socketConnect(char *host, int port, int flags);
 
+/**
+    Test if a non-blocking connect has completed
+    @param sid Socket ID handle returned from socketConnect.
+    @return Zero if connected. Otherwise the connect error code.
+    @ingroup WebsSocket
+ */
+PUBLIC int socketConnected(int sid);
+
 /**
     Create a socket handler that will be invoked when I/O events occur.
     @param sid Socket ID handle returned from socketConnect or socketAccept.
@@ -1248,6 +1290,16 @@ PUBLIC int wfreeHandle(void *map, int handle);
  */
 PUBLIC uint hextoi(char *str);
 
+/**
+    Convert a decimal string to a 64 bit integer
+    @description Leading white space and a sign are permitted. Conversion stops at the first non-digit character.
+        Values that overflow are clamped to MAXINT64.
+    @param str Pointer to the string to parse.
+    @return Returns the integer equivalent value of the string.
+    @ingroup WebsRuntime
+ */
+PUBLIC int64 stoi(char *str);
+
 /**
     Convert an integer to a string buffer.
     @description This call converts the supplied 64 bit integer into a string formatted into the supplied buffer according
@@ -1506,7 +1558,7 @@ typedef struct WebsUpload {
     char    *filename;              /**< Local (temp) name of the file */
     char    *clientFilename;        /**< Client side name of the file */
     char    *contentType;           /**< Content type */
-    ssize   size;                   /**< Uploaded file size */
+    Offset  size;                   /**< Uploaded file size */
 } WebsUpload;
 
 /**
@@ -1561,6 +1613,12 @@ PUBLIC WebsUpload *websLookupUpload(struct Webs *wp, char *key);
 #define WEBS_UPLOAD             0x800       /**< Multipart-mime file upload */
 #define WEBS_REROUTE            0x1000      /**< Restart route matching */
 #define WEBS_VARS_ADDED         0x8000      /**< Query and body form vars added */
+#define WEBS_VARS_PENDING       0x4000      /**< Query and body form vars not yet decoded */
+#define WEBS_EXPECT_CONTINUE    0x10000     /**< Client sent "Expect: 100-continue" */
+#define WEBS_AUTHORIZED         0x20000     /**< Request authorized for wp->route */
+#define WEBS_IDLE               0x40000     /**< Connection is in the idle keep-alive list */
+#define WEBS_JSON               0x80000     /**< JSON request body is parsed as it is received */
+#define WEBS_INPUT_PAUSED       0x100000    /**< Reading the request body is paused */
 
 #if BIT_GOAHEAD_LEGACY
 #define WEBS_LOCAL              0x2000      /**< Request from local system */
@@ -1600,106 +1658,185 @@ PUBLIC WebsUpload *websLookupUpload(struct Webs *wp, char *key);
  */
 typedef void (*WebsWriteProc)(struct Webs *wp);
 
+/**
+    Request cookie
+    @description Name and value of a cookie supplied in the request Cookie header
+    @ingroup Webs
+ */
+typedef struct WebsCookie {
+    char            *name;              /**< Cookie name */
+    char            *value;             /**< Cookie value with any quotes removed */
+} WebsCookie;
+
+/**
+    Authentication state of a request
+    @description Allocated by websGetAuthState when the request supplies credentials or is challenged.
+    @ingroup Webs
+ */
+typedef struct WebsAuthState {
+    char            *authDetails;       /**< Http header auth details */
+    char            *authResponse;      /**< Outgoing auth header */
+    char            *digest;            /**< Password digest */
+    char            *password;          /**< Authorization password */
+    char            *realm;             /**< Realm field supplied in auth header */
+    int             encoded;            /**< True if the password is MD5(username:realm:password) */
+#if BIT_DIGEST
+    char            *cnonce;            /**< check nonce */
+    char            *digestUri;         /**< URI found in digest header */
+    char            *nonce;             /**< opaque-to-client string sent by server */
+    char            *nc;                /**< nonce count */
+    char            *opaque;            /**< opaque value passed from server */
+    char            *qop;               /**< quality operator */
+#endif
+} WebsAuthState;
+
+#if BIT_GOAHEAD_CGI
+/**
+    CGI state of a request
+    @description Allocated when a CGI request has body data.
+    @ingroup Webs
+ */
+typedef struct WebsCgiState {
+    char            *cgiStdin;          /**< Filename for CGI program input */
+    int             cgifd;              /**< File handle for CGI program input */
+} WebsCgiState;
+#endif
+
+#if BIT_GOAHEAD_UPLOAD
+/**
+    File upload parser state of a request
+    @description Allocated when a multipart-mime upload request is received.
+    @ingroup WebsUpload
+ */
+typedef struct WebsUploadState {
+    int             upfd;               /**< Upload file handle */
+    char            *boundary;          /**< Mime boundary (static) */
+    ssize           boundaryLen;        /**< Boundary length */
+    int             uploadState;        /**< Current file upload state */
+    WebsUpload      *currentFile;       /**< Current file context */
+    char            *clientFilename;    /**< Current file filename */
+    char            *uploadTmp;         /**< Current temp filename for upload data */
+    char            *uploadVar;         /**< Current upload form variable name */
+} WebsUploadState;
+#endif
+
 /**
     GoAhead request structure. This is a per-socket connection structure.
+    @description The fields used on every I/O event are grouped at the start of the structure so they share a few
+        cache lines. State that few requests need (authentication, CGI and upload) is allocated on demand.
     @defgroup Webs Webs
  */
 typedef struct Webs {
+    int             sid;                /**< Socket id (handler) */
+    int             state;              /**< Current state */
+    int             flags;              /**< Current flags -- see above */
+    int             code;               /**< Response status code */
+    int             timeout;            /**< Timeout handle */
+    int             wid;                /**< Index into webs */
+    int             rxChunkState;       /**< Rx chunk encoding state */
+    int             txChunkState;       /**< Transmit chunk state */
+    Offset          rxLen;              /**< Rx content length */
+    Offset          rxRemaining;        /**< Remaining content to read from client */
+    Offset          txLen;              /**< Tx content length header value */
+    Offset          written;            /**< Bytes actually transferred */
+    ssize           lastRead;           /**< Number of bytes last read from the socket */
+    WebsTime        timestamp;          /**< Last transaction with browser */
+    WebsBuf         *txbuf;
+    WebsWriteProc   writeData;          /**< Handler write I/O event callback. Used by fileHandler */
+    struct WebsRoute *route;            /**< Request route */
+    void            *ssl;               /**< SSL context */
+    int             docfd;              /**< File descriptor for document being served */
+    bool            eof;                /**< If at the end of the request content */
     WebsBuf         rxbuf;              /**< Raw receive buffer */
-    WebsBuf         input;              /**< Receive buffer after de-chunking */
     WebsBuf         output;             /**< Transmit buffer after chunking */
+
+    WebsBuf         input;              /**< Receive buffer after de-chunking */
     WebsBuf         chunkbuf;           /**< Pre-chunking data buffer */
-    WebsBuf         *txbuf;
     WebsTime        since;              /**< Parsed if-modified-since time */
-    WebsHash        vars;               /**< CGI standard variables */
-    WebsTime        timestamp;          /**< Last transaction with browser */
-    int             timeout;            /**< Timeout handle */
-    char            ipaddr[64];         /**< Connecting ipaddress */
-    char            ifaddr[64];         /**< Local interface ipaddress */
+    WebsHash        vars;               /**< CGI standard variables. Call websParseVars before direct access. */
 
-    int             rxChunkState;       /**< Rx chunk encoding state */
     ssize           rxChunkSize;        /**< Rx chunk size */
     char            *rxEndp;            /**< Pointer to end of raw data in input beyond endp */
-    ssize           lastRead;           /**< Number of bytes last read from the socket */
-    bool            eof;                /**< If at the end of the request content */
 
     char            txChunkPrefix[16];  /**< Transmit chunk prefix */
     char            *txChunkPrefixNext; /**< Current I/O pos in txChunkPrefix */
     ssize           txChunkPrefixLen;   /**< Length of prefix */
     ssize           txChunkLen;         /**< Length of the chunk */
-    int             txChunkState;       /**< Transmit chunk state */
 
-    char            *authDetails;       /**< Http header auth details */
-    char            *authResponse;      /**< Outgoing auth header */
     char            *authType;          /**< Authorization type (Basic/DAA) */
     char            *contentType;       /**< Body content type */
     char            *cookie;            /**< Request cookie string */
+    WebsCookie      *cookies;           /**< Parsed request cookies. Allocated on first use. */
+    char            *sessionCookie;     /**< Session ID value in cookies */
     char            *decodedQuery;      /**< Decoded request query */
-    char            *digest;            /**< Password digest */
     char            *ext;               /**< Path extension */
     char            *filename;          /**< Document path name */
     char            *host;              /**< Requested host */
     char            *inputFile;         /**< File name to write input body data */
     char            *method;            /**< HTTP request method */
-    char            *password;          /**< Authorization password */
     char            *path;              /**< Path name without query. This is decoded. */
     char            *protoVersion;      /**< Protocol version (HTTP/1.1)*/
     char            *protocol;          /**< Protocol scheme (normally http|https) */
     char            *putname;           /**< PUT temporary filename */
     char            *query;             /**< Request query. This is decoded. */
-    char            *realm;             /**< Realm field supplied in auth header */
     char            *referrer;          /**< The referring page */
     char            *responseCookie;    /**< Outgoing cookie */
     char            *url;               /**< Full request url. This is not decoded. */
     char            *userAgent;         /**< User agent (browser) */
     char            *username;          /**< Authorization username */
 
-    int             sid;                /**< Socket id (handler) */
+    int             cookieCount;        /**< Number of parsed request cookies */
     int             listenSid;          /**< Listen Socket id */
     int             port;               /**< Request port number */
-    int             state;              /**< Current state */
-    int             flags;              /**< Current flags -- see above */
-    int             code;               /**< Response status code */
-    ssize           rxLen;              /**< Rx content length */
-    ssize           rxRemaining;        /**< Remaining content to read from client */
-    ssize           txLen;              /**< Tx content length header value */
-    int             wid;                /**< Index into webs */
-#if BIT_GOAHEAD_CGI
-    char            *cgiStdin;          /**< Filename for CGI program input */
-    int             cgifd;              /**< File handle for CGI program input */
-#endif
+    int             requests;           /**< Number of requests completed on the connection */
+    struct Webs     *idlePrev;          /**< Older connection in the idle keep-alive list */
+    struct Webs     *idleNext;          /**< Newer connection in the idle keep-alive list */
 #if !BIT_ROM
     int             putfd;              /**< File handle to write PUT data */
+#else
+    struct WebsRomIndex *rom;           /**< ROM document being served */
+    uchar           *romData;           /**< ROM document data remaining to be written */
+    ssize           romLen;             /**< Length of ROM document data remaining to be written */
 #endif
-    int             docfd;              /**< File descriptor for document being served */
-    ssize           written;            /**< Bytes actually transferred */
-    ssize           putLen;             /**< Bytes read by a PUT request */
+#if BIT_GOAHEAD_OPENAT
+    int             docdir;             /**< Documents directory descriptor to resolve the path. Not owned. */
+#endif
+    Offset          putLen;             /**< Bytes read by a PUT request */
 
     struct WebsSession *session;        /**< Session record */
-    struct WebsRoute *route;            /**< Request route */
     struct WebsUser *user;              /**< User auth record */
-    WebsWriteProc   writeData;          /**< Handler write I/O event callback. Used by fileHandler */
-    int             encoded;            /**< True if the password is MD5(username:realm:password) */
-#if BIT_DIGEST
-    char            *cnonce;            /**< check nonce */
-    char            *digestUri;         /**< URI found in digest header */
-    char            *nonce;             /**< opaque-to-client string sent by server */
-    char            *nc;                /**< nonce count */
-    char            *opaque;            /**< opaque value passed from server */
-    char            *qop;               /**< quality operator */
+    WebsAuthState   *auth;              /**< Authentication state. Allocated on demand. */
+#if BIT_GOAHEAD_CGI
+    WebsCgiState    *cgi;               /**< CGI input state. Allocated on demand. */
 #endif
 #if BIT_GOAHEAD_UPLOAD
-    int             upfd;               /**< Upload file handle */
     WebsHash        files;              /**< Uploaded files */
-    char            *boundary;          /**< Mime boundary (static) */
-    ssize           boundaryLen;        /**< Boundary length */
-    int             uploadState;        /**< Current file upload state */
-    WebsUpload      *currentFile;       /**< Current file context */
-    char            *clientFilename;    /**< Current file filename */
-    char            *uploadTmp;         /**< Current temp filename for upload data */
-    char            *uploadVar;         /**< Current upload form variable name */
+    WebsUploadState *upload;            /**< Upload parser state. Allocated on demand. */
 #endif
-    void            *ssl;               /**< SSL context */
+#if BIT_GOAHEAD_MMAP
+    struct WebsMap  *map;               /**< Memory mapping of the document being served */
+    ssize           mapPos;             /**< Position in the mapped document to write next */
+#endif
+#if BIT_GOAHEAD_AIO
+    struct WebsAio  *aio;               /**< Disk I/O request for the I/O thread pool */
+    ssize           aioPos;             /**< Position in the I/O buffer to write next */
+#endif
+#if BIT_GOAHEAD_FIBER
+    void            *fiber;             /**< Coroutine running the action handler */
+#endif
+#if BIT_GOAHEAD_JSON
+    void            *json;              /**< JSON body parser state. Allocated on demand. */
+#endif
+#if BIT_GOAHEAD_CACHE
+    void            *cache;             /**< Response cache item being filled, awaited or written */
+    ssize           cachePos;           /**< Position in the cached response body being written */
+#endif
+#if BIT_GOAHEAD_PROXY
+    char            *headers;           /**< Raw request headers preserved for forwarding by the proxy handler */
+    void            *proxy;             /**< Proxy handler request state */
+#endif
+    char            ipaddr[64];         /**< Connecting ipaddress */
+    char            ifaddr[64];         /**< Local interface ipaddress */
 } Webs;
 
 #if BIT_GOAHEAD_LEGACY
@@ -1767,167 +1904,470 @@ typedef struct WebsMime {
     @ingroup Webs
  */
 typedef struct WebsFileInfo {
-    ulong           size;                   /**< File length */
+    Offset          size;                   /**< File length */
     int             isDir;                  /**< Set if directory */
     WebsTime        mtime;                  /**< Modified time */
 } WebsFileInfo;
 
+#define WEBS_MAX_JST_ARGS   16              /**< Maximum arguments to a precompiled Javascript template call */
+
 /**
-    Compiled Rom Page Index
+    Precompiled Javascript template segment generated by webcomp --jst
+    @description Templates are an array of segments terminated by a segment with a null text field. Literal segments
+        reference the compiled page data. Call segments invoke a Javascript function defined via websDefineJst.
     @ingroup Webs
  */
-typedef struct WebsRomIndex {
-    char            *path;                  /**< Web page URL path */
-    uchar           *page;                  /**< Web page data */
-    int             size;                   /**< Size of web page in bytes */
-    Offset          pos;                    /**< Current read position */
-} WebsRomIndex;
+typedef struct WebsJstSegment {
+    char            *text;                  /**< Literal text or function name. Null to end the template. */
+    ssize           len;                    /**< Length of the literal text. Set to -1 for function calls. */
+    int             argc;                   /**< Count of function arguments */
+    char            **argv;                 /**< Function arguments */
+    int             vars;                   /**< Bit mask of arguments that are request variable names */
+    void            *fn;                    /**< Resolved WebsJstProc. Set on first use. */
+} WebsJstSegment;
 
-#if BIT_ROM
-    /**
-        List of documents to service when built with ROM support
-        @ingroup Webs
-     */
-    PUBLIC_DATA WebsRomIndex websRomIndex[];
-#endif
-
-#define WEBS_DECODE_TOKEQ 1                 /**< Decode base 64 blocks up to a NULL or equals */
+#if BIT_GOAHEAD_MMAP
+/**
+    Memory mapped document
+    @description Mappings are shared by all requests serving the same unmodified document
+    @ingroup Webs
+ */
+typedef struct WebsMap {
+    char            *path;                  /**< Document filename */
+    char            *data;                  /**< Mapped document data */
+    ssize           size;                   /**< Size of the mapping */
+    WebsTime        mtime;                  /**< Document modification time when mapped */
+    WebsTime        lastUsed;               /**< When the mapping was last acquired */
+    int             refs;                   /**< Count of requests using the mapping */
+    int             detached;               /**< Set when removed from the map cache */
+} WebsMap;
 
 /**
-    Accept a new connection 
-    @param sid Socket ID handle for the newly accepted socket
-    @param ipaddr IP address originating the connection.
-    @param port Port number originating the connection.
-    @param listenSid Socket ID of the listening socket
-    @return Zero if successful, otherwise -1
+    Map a document into memory
+    @description Returns a shared mapping for the document if its size and modification time match. Otherwise a new
+        mapping is created. Release with websUnmapFile.
+    @param path Document filename
+    @param fd Open file descriptor for the document. Set to -1 to open the path.
+    @param info Document information from websStatFile
+    @return The mapping or null if the document cannot be mapped.
     @ingroup Webs
  */
-PUBLIC int websAccept(int sid, char *ipaddr, int port, int listenSid);
+PUBLIC WebsMap *websMapFile(char *path, int fd, WebsFileInfo *info);
 
 /**
-    Open the action handler
+    Release a memory mapped document
+    @param map Mapping returned by websMapFile
     @ingroup Webs
  */
-PUBLIC void websActionOpen();
+PUBLIC void websUnmapFile(WebsMap *map);
 
 /**
-    Allocate a new Webs object
-    @param sid Socket ID handle for the newly accepted socket
-    @return The webs[] handle index for the allocated Webs object
+    Remove a mapping from the map cache
+    @description Used when the document is found to be truncated. The mapping is unmapped when no longer used.
+    @param map Mapping returned by websMapFile
     @ingroup Webs
  */
-PUBLIC int websAlloc(int sid);
+PUBLIC void websInvalidateMap(WebsMap *map);
+#endif
+
+#if BIT_GOAHEAD_AIO
+#define WEBS_AIO_OPEN       1               /**< Open and stat a document */
+#define WEBS_AIO_READ       2               /**< Read from a document at an offset */
+
+struct WebsAio;
 
 /**
-    Cancel the request timeout.
-    @description Handlers may choose to manually manage the request timeout. This routine will disable the
-        centralized management of the timeout for this request.
+    Disk I/O completion callback
+    @description Invoked on the event loop when an operation started by websAioOpenFile or websAioRead completes.
+        The request is pumped after the callback returns.
     @param wp Webs request object
+    @param aio Completed I/O request. The error field is set to the errno value if the operation failed.
     @ingroup Webs
  */
-PUBLIC void websCancelTimeout(Webs *wp);
+typedef void (*WebsAioProc)(Webs *wp, struct WebsAio *aio);
 
-#if BIT_GOAHEAD_CGI
 /**
-    Open the CGI handler
-    @return Zero if successful, otherwise -1
+    Disk I/O request performed by the I/O thread pool
+    @description Each request has at most one operation in progress. Fields other than wp and proc must not be
+        accessed while the operation is busy.
     @ingroup Webs
  */
-PUBLIC int websCgiOpen();
+typedef struct WebsAio {
+    Webs            *wp;                    /**< Owning request. Null if the request was freed while busy. */
+    WebsAioProc     proc;                   /**< Completion callback */
+    int             op;                     /**< WEBS_AIO_OPEN or WEBS_AIO_READ */
+    int             fd;                     /**< File opened or file to read */
+    int             dirfd;                  /**< Directory to resolve the path or -1 if the path is absolute */
+    char            *path;                  /**< Filename to open */
+    char            *buf;                   /**< Read buffer. Null terminated after a read. */
+    ssize           size;                   /**< Size of the read buffer excluding the null */
+    ssize           nbytes;                 /**< Bytes read. Zero at end of file. */
+    Offset          offset;                 /**< File offset of the read */
+    WebsFileInfo    info;                   /**< Document information after an open */
+    int             error;                  /**< Errno value if the operation failed */
+    int             busy;                   /**< Operation queued or in progress */
+    struct WebsAio  *next;                  /**< Next request in the pending or completed queue */
+} WebsAio;
 
 /**
-    CGI handler service callback
-    @param wp Webs object
-    @return Returns 1 if the request was handled. 
+    Cancel disk I/O for a request
+    @description Called when a request is freed. Any operation in progress is abandoned and its file and buffer
+        are released when it completes.
+    @param wp Webs request object
     @ingroup Webs
+    @internal
  */
-PUBLIC int websCgiHandler(Webs *wp);
+PUBLIC void websAioCancel(Webs *wp);
 
 /**
-    Poll for output from CGI processes and output.
-    @return Time delay till next poll
+    Close the I/O thread pool
     @ingroup Webs
+    @internal
  */
-PUBLIC WebsTime websCgiPoll();
-#endif /* BIT_GOAHEAD_CGI */
+PUBLIC void websAioClose();
 
 /**
-    Close the core GoAhead web server module
-    @description Invoked when GoAhead is shutting down.
+    Open the I/O thread pool
+    @description The threads are started when first required.
     @ingroup Webs
+    @internal
  */
-PUBLIC void websClose();
+PUBLIC void websAioOpen();
 
 /**
-    Close an open file
-    @param fd Open file handle returned by websOpenFile
+    Open and stat the request document in the I/O thread pool
+    @description On completion, aio->fd is the open file and aio->info describes the document. The callback should
+        take ownership of the file by setting aio->fd to -1. Otherwise the file is closed after the callback returns.
+    @param wp Webs request object. The document filename is wp->filename.
+    @param proc Completion callback
+    @return Zero if the operation was started, otherwise -1.
     @ingroup Webs
  */
-PUBLIC void websCloseFile(int fd);
+PUBLIC int websAioOpenFile(Webs *wp, WebsAioProc proc);
 
 /**
-    Compare a request variable
+    Read from a document in the I/O thread pool
+    @description Reads until the buffer is full or the end of file. On completion, the data is in aio->buf and
+        aio->nbytes is the number of bytes read.
     @param wp Webs request object
-    @param var Variable name
-    @param value Value to compare with
-    @return True if the value matches. Otherwise return 0
+    @param fd Open file to read. If the request is freed while the read is busy, the file is closed when the
+        read completes. Otherwise the file remains owned by the caller.
+    @param offset File offset to read from
+    @param size Number of bytes to read
+    @param proc Completion callback
+    @return Zero if the operation was started, otherwise -1.
     @ingroup Webs
  */
-PUBLIC int websCompareVar(Webs *wp, char *var, char *value);
+PUBLIC int websAioRead(Webs *wp, int fd, Offset offset, ssize size, WebsAioProc proc);
 
 /**
-    Consume input from the request input buffer.
-    @description This is called by handlers when consuming data from the request input buffer.
-        This call updates the input service pointers and compacts the input buffer if required.
+    Test if the request document should be read using the I/O thread pool
+    @description Returns true for routes with the "aio" option, for documents on slow mounts (network, FAT and
+        FUSE file systems) and for documents of at least BIT_GOAHEAD_AIO_THRESHOLD bytes.
     @param wp Webs request object
-    @param nbytes Number of bytes the handler has consumed from the input buffer.
+    @param size Document size. Set to -1 if not yet known.
+    @return True if the I/O thread pool should be used.
     @ingroup Webs
  */
-PUBLIC void websConsumeInput(Webs *wp, ssize nbytes);
+PUBLIC bool websAioWanted(Webs *wp, Offset size);
+#endif
 
+#if BIT_GOAHEAD_FIBER
 /**
-    Decode the string using base-64 encoding
-    @description This modifies the original string
-    @param str String to decode
-    @return The original string.
+    Wait until a file descriptor is readable
+    @description Suspends the request fiber and returns to the event loop until the descriptor is readable or the
+        timeout expires. The descriptor remains owned by the caller. Must only be called from a fiber action.
+    @param wp Webs request object
+    @param fd Descriptor to wait for. Typically a non-blocking socket or pipe.
+    @param timeout Timeout in milliseconds. Set to zero to wait without a timeout. Timers have one second resolution.
+    @return 1 if the descriptor is readable, zero if the timeout expired and -1 if the request is not running in a
+        fiber or was completed while waiting.
     @ingroup Webs
  */
-PUBLIC char *websDecode64(char *str);
+PUBLIC int websAwaitReadable(Webs *wp, int fd, int timeout);
 
 /**
-    Decode a block using base-46 encoding
-    @param str String to decode. The string must be null terminated.
-    @param len Reference to an integer holding the length of the decoded string.
-    @param flags Reserved.
-    @return The original string.
+    Wait until a file descriptor is writable
+    @description Suspends the request fiber and returns to the event loop until the descriptor is writable or the
+        timeout expires. Must only be called from a fiber action.
+    @param wp Webs request object
+    @param fd Descriptor to wait for. Set to -1 to wait until buffered response data has been written to the client
+        so more output can be written without blocking.
+    @param timeout Timeout in milliseconds. Set to zero to wait without a timeout. Timers have one second resolution.
+    @return 1 if the descriptor is writable, zero if the timeout expired and -1 if the request is not running in a
+        fiber or was completed while waiting.
     @ingroup Webs
  */
-PUBLIC char *websDecode64Block(char *str, ssize *len, int flags);
+PUBLIC int websAwaitWritable(Webs *wp, int fd, int timeout);
 
 /**
-    Decode a URL expanding %NN encoding
-    @description Supports insitu decoding. i.e. Input and output buffers may be the same.
-    @param decoded Buffer to hold the decoded URL
-    @param input Input URL or buffer to decode
-    @param len Length of the decoded buffer.
+    Read from a file without blocking the event loop
+    @description Suspends the request fiber while the read is performed by the I/O thread pool. If the pool is not
+        configured, the file is read directly. Must only be called from a fiber action.
+    @param wp Webs request object
+    @param fd Open file to read
+    @param buf Buffer to receive the data
+    @param size Size of buf
+    @param offset File offset to read from
+    @return The number of bytes read. Zero at end of file and -1 on errors.
     @ingroup Webs
  */
-PUBLIC void websDecodeUrl(char *decoded, char *input, ssize len);
+PUBLIC ssize websAwaitRead(Webs *wp, int fd, char *buf, ssize size, Offset offset);
 
 /**
-    Define a request handler
-    @param name Name of the handler
-    @param service Handler callback service procedure. Invoked to service each relevant request.
-    @param close Handler callback close procedure. Called when GoAhead is shutting down.
-    @param flags Set to WEBS_LEGACY_HANDLER to support the legacy handler API calling sequence.
+    Define an action that runs in a fiber
+    @description Fiber actions run on a pooled coroutine stack of BIT_GOAHEAD_FIBER_STACK bytes. They may call
+        websAwaitReadable, websAwaitWritable, websAwaitRead and websSleep to wait without blocking other requests.
+        A fiber action must call websDone when the response is complete and must not wait after calling websDone.
+        If the request is freed while the fiber is waiting (timeout or the client closing the connection), the
+        fiber is resumed and the wait returns -1. The action must then release any resources it holds and return.
+        Further waits also return -1 and output is discarded.
+    @param name URI path suffix. This suffix is added to "/action" to form the bound URI path.
+    @param fun Callback function. The signature is void (*WebsAction)(Webs *wp);
     @return Zero if successful, otherwise -1.
     @ingroup Webs
  */
-PUBLIC int websDefineHandler(char *name, WebsHandlerProc service, WebsHandlerClose close, int flags);
+PUBLIC int websDefineFiberAction(char *name, void *fun);
 
 /**
-    Complete a request.
-    @description A handler should call websDone() to complete the request.
+    Cancel the fiber of a request
+    @description Called when a request is freed. A waiting fiber is resumed with a -1 result so the action can
+        release its resources and return.
+    @param wp Webs request object
+    @ingroup Webs
+    @internal
+ */
+PUBLIC void websFiberCancel(Webs *wp);
+
+/**
+    Release pooled fiber stacks
+    @ingroup Webs
+    @internal
+ */
+PUBLIC void websFiberClose();
+
+/**
+    Suspend the request fiber
+    @description Returns to the event loop and resumes the fiber after the given delay. Must only be called from a
+        fiber action.
+    @param wp Webs request object
+    @param msecs Delay in milliseconds. Timers have one second resolution.
+    @return Zero if successful and -1 if the request is not running in a fiber or was completed while waiting.
+    @ingroup Webs
+ */
+PUBLIC int websSleep(Webs *wp, int msecs);
+
+/**
+    Run a handler in a fiber
+    @description Creates a fiber for the request and runs the procedure until it completes or first waits.
+    @param wp Webs request object
+    @param proc Procedure to run
+    @return Zero if the fiber was started, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websStartFiber(Webs *wp, WebsAction proc);
+#endif
+
+/**
+    Compiled Rom Page Index
+    @ingroup Webs
+ */
+typedef struct WebsRomIndex {
+    char            *path;                  /**< Web page URL path */
+    uchar           *page;                  /**< Web page data */
+    int             size;                   /**< Size of web page in bytes */
+    Offset          pos;                    /**< Current read position */
+    WebsTime        mtime;                  /**< Modification time of the source document */
+    char            *etag;                  /**< Precomputed entity tag */
+    char            *mimeType;              /**< Precomputed mime type. Null if resolved by extension. */
+    uchar           *gzpage;                /**< Gzip compressed web page data. Null if not compressed. */
+    int             gzsize;                 /**< Size of the compressed web page in bytes */
+    WebsJstSegment  *jst;                   /**< Precompiled Javascript template. Null if interpreted. */
+} WebsRomIndex;
+
+#if BIT_ROM
+    /**
+        List of documents to service when built with ROM support
+        @ingroup Webs
+     */
+    PUBLIC_DATA WebsRomIndex websRomIndex[];
+
+    /**
+        Collision free hash of ROM document paths generated by webcomp. Paths hash to a bucket whose seed selects
+        a slot in websRomHash. Each slot holds an index into websRomIndex or -1. Sizes are powers of two.
+        @ingroup Webs
+     */
+    PUBLIC_DATA short websRomHash[];
+    PUBLIC_DATA int websRomHashSize;
+    PUBLIC_DATA ushort websRomHashSeeds[];
+    PUBLIC_DATA int websRomHashBuckets;
+
+    /**
+        Lookup a ROM document
+        @param path Document filename
+        @return The ROM document index entry or null if not found.
+        @ingroup Webs
+     */
+    PUBLIC WebsRomIndex *websLookupRom(char *path);
+#endif
+
+#define WEBS_DECODE_TOKEQ 1                 /**< Decode base 64 blocks up to a NULL or equals */
+
+/**
+    Accept a new connection 
+    @param sid Socket ID handle for the newly accepted socket
+    @param ipaddr IP address originating the connection.
+    @param port Port number originating the connection.
+    @param listenSid Socket ID of the listening socket
+    @return Zero if successful, otherwise -1
+    @ingroup Webs
+ */
+PUBLIC int websAccept(int sid, char *ipaddr, int port, int listenSid);
+
+/**
+    Open the action handler
+    @ingroup Webs
+ */
+PUBLIC void websActionOpen();
+
+/**
+    Allocate a new Webs object
+    @param sid Socket ID handle for the newly accepted socket
+    @return The webs[] handle index for the allocated Webs object
+    @ingroup Webs
+ */
+PUBLIC int websAlloc(int sid);
+
+/**
+    Cancel the request timeout.
+    @description Handlers may choose to manually manage the request timeout. This routine will disable the
+        centralized management of the timeout for this request.
+    @param wp Webs request object
+    @ingroup Webs
+ */
+PUBLIC void websCancelTimeout(Webs *wp);
+
+#if BIT_GOAHEAD_CGI
+/**
+    Open the CGI handler
+    @return Zero if successful, otherwise -1
+    @ingroup Webs
+ */
+PUBLIC int websCgiOpen();
+
+/**
+    Get the CGI state of the request
+    @description The state is allocated on first use and freed with the request.
+    @param wp Webs request object
+    @return The CGI state or null if memory cannot be allocated.
+    @ingroup Webs
+    @internal
+ */
+PUBLIC WebsCgiState *websGetCgiState(Webs *wp);
+
+/**
+    CGI handler service callback
+    @param wp Webs object
+    @return Returns 1 if the request was handled. 
+    @ingroup Webs
+ */
+PUBLIC int websCgiHandler(Webs *wp);
+
+/**
+    Poll for output from CGI processes and output.
+    @return Time delay till next poll
+    @ingroup Webs
+ */
+PUBLIC WebsTime websCgiPoll();
+#endif /* BIT_GOAHEAD_CGI */
+
+/**
+    Close the core GoAhead web server module
+    @description Invoked when GoAhead is shutting down.
+    @ingroup Webs
+ */
+PUBLIC void websClose();
+
+/**
+    Close an open file
+    @param fd Open file handle returned by websOpenFile
+    @ingroup Webs
+ */
+PUBLIC void websCloseFile(int fd);
+
+/**
+    Compare a request variable
+    @param wp Webs request object
+    @param var Variable name
+    @param value Value to compare with
+    @return True if the value matches. Otherwise return 0
+    @ingroup Webs
+ */
+PUBLIC int websCompareVar(Webs *wp, char *var, char *value);
+
+/**
+    Consume input from the request input buffer.
+    @description This is called by handlers when consuming data from the request input buffer.
+        This call updates the input service pointers and compacts the input buffer if required.
+    @param wp Webs request object
+    @param nbytes Number of bytes the handler has consumed from the input buffer.
+    @ingroup Webs
+ */
+PUBLIC void websConsumeInput(Webs *wp, ssize nbytes);
+
+/**
+    Pause or resume reading the request body
+    @description Handlers that forward the request body as it is received use this to stop reading from the client
+        while the body can't be forwarded. When resumed, buffered body data is processed and reading continues.
+    @param wp Webs request object
+    @param pause Set to true to pause reading and false to resume.
+    @ingroup Webs
+ */
+PUBLIC void websPauseInput(Webs *wp, bool pause);
+
+/**
+    Decode the string using base-64 encoding
+    @description This modifies the original string
+    @param str String to decode
+    @return The original string.
+    @ingroup Webs
+ */
+PUBLIC char *websDecode64(char *str);
+
+/**
+    Decode a block using base-46 encoding
+    @param str String to decode. The string must be null terminated.
+    @param len Reference to an integer holding the length of the decoded string.
+    @param flags Reserved.
+    @return The original string.
+    @ingroup Webs
+ */
+PUBLIC char *websDecode64Block(char *str, ssize *len, int flags);
+
+/**
+    Decode a URL expanding %NN encoding
+    @description Supports insitu decoding. i.e. Input and output buffers may be the same.
+    @param decoded Buffer to hold the decoded URL
+    @param input Input URL or buffer to decode
+    @param len Length of the decoded buffer.
+    @ingroup Webs
+ */
+PUBLIC void websDecodeUrl(char *decoded, char *input, ssize len);
+
+/**
+    Define a request handler
+    @param name Name of the handler
+    @param service Handler callback service procedure. Invoked to service each relevant request.
+    @param close Handler callback close procedure. Called when GoAhead is shutting down.
+    @param flags Set to WEBS_LEGACY_HANDLER to support the legacy handler API calling sequence.
+    @return Zero if successful, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websDefineHandler(char *name, WebsHandlerProc service, WebsHandlerClose close, int flags);
+
+/**
+    Complete a request.
+    @description A handler should call websDone() to complete the request.
     @param wp Webs request object
     @ingroup Webs
  */
@@ -1978,6 +2418,17 @@ PUBLIC void websError(Webs *wp, int code, char *fmt, ...);
  */
 PUBLIC char *websErrorMsg(int code);
 
+/**
+    Format the HTML body of an error response
+    @description This is the body used by websError. Handlers that cache error responses should use it so the cached
+        response matches the response from websError.
+    @param code HTTP status code
+    @param msg Error message. The message is HTML escaped.
+    @return An allocated block containing the HTML body. Caller must free.
+    @ingroup Webs
+ */
+PUBLIC char *websErrorPage(int code, char *msg);
+
 /**
     Open and initialize the file handler
     @ingroup Webs
@@ -2000,6 +2451,15 @@ PUBLIC bool websFlush(Webs *wp);
  */
 PUBLIC void websFree(Webs *wp);
 
+/**
+    Get the authentication state of the request
+    @description The state is allocated on first use and freed with the request.
+    @param wp Webs request object
+    @return The authentication state or null if memory cannot be allocated.
+    @ingroup Webs
+ */
+PUBLIC WebsAuthState *websGetAuthState(Webs *wp);
+
 /**
     Get the background execution flag
     @description If GoAhead is invoked with --background, it will run as a daemon in the background.
@@ -2025,6 +2485,16 @@ PUBLIC char *websGetCgiCommName();
  */
 PUBLIC char *websGetCookie(Webs *wp);
 
+/**
+    Get the value of a request cookie
+    @description The Cookie header is parsed once on first use into a table of cookies for the request.
+    @param wp Webs request object
+    @param name Cookie name
+    @return Cookie value if defined, otherwise null. The value is owned by the request and must not be freed.
+    @ingroup Webs
+ */
+PUBLIC char *websGetCookieValue(Webs *wp, char *name);
+
 /**
     Get a date as a string
     @description If sbuf is supplied, it is used to calculate the date. Otherwise, the current time is used.
@@ -2122,7 +2592,7 @@ PUBLIC char *websGetMethod(Webs *wp);
 /**
     Get the request password
     @description The request password may be encoded depending on the authentication scheme. 
-        See wp->encoded to test if it is encoded.
+        See wp->auth->encoded to test if it is encoded.
     @param wp Webs request object
     @return Password string. Caller should not free.
     @ingroup Webs
@@ -2339,6 +2809,45 @@ PUBLIC int websOsOpen();
  */
 PUBLIC int websOpenFile(char *path, int flags, int mode);
 
+#if BIT_GOAHEAD_OPENAT
+/**
+    Get a descriptor for a documents directory
+    @description Descriptors are opened on first use and cached until websFsClose. The directory path is re-checked
+        at most once a second and a new descriptor is opened if the directory has been replaced. Descriptors of replaced
+        directories remain valid for requests in progress until websFsClose.
+    @param dir Directory path
+    @return Directory file descriptor if successful, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websGetDirFd(char *dir);
+
+/**
+    Open a file relative to a documents directory
+    @description On Linux, the path is resolved with openat2 RESOLVE_BENEATH where supported so that it cannot
+        escape the directory. Symbolic links are followed only if they resolve beneath the directory. Absolute
+        symbolic links are always rejected, even if they refer to a document inside the directory. Such documents
+        can be served when opened by path with websOpenFile but not via this routine. This routine does not allocate
+        memory and may be called from any thread.
+    @param dirfd Directory descriptor from websGetDirFd
+    @param path Filename path relative to the directory. A leading "/" is ignored.
+    @param flags File open flags
+    @param mode Permissions mask
+    @return Positive file handle if successful, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websOpenFileAt(int dirfd, char *path, int flags, int mode);
+
+/**
+    Get file status for a file relative to a documents directory
+    @param dirfd Directory descriptor from websGetDirFd
+    @param path Filename path relative to the directory. A leading "/" is ignored.
+    @param sbuf File information structure to modify with file status
+    @return Zero if successful, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websStatFileAt(int dirfd, char *path, WebsFileInfo *sbuf);
+#endif
+
 /**
     Open the options handler
     @return Zero if successful, otherwise -1.
@@ -2608,6 +3117,16 @@ PUBLIC void websSetEnv(Webs *wp);
  */
 PUBLIC void websSetFormVars(Webs *wp);
 
+/**
+    Decode the query and form variables for a request
+    @description Routing defers decoding the query string and form body until the request variables are first
+        used. The variable access routines such as websGetVar, websSetVar and websSetEnv call this routine
+        automatically. Handlers that read wp->vars directly must call websParseVars first.
+    @param wp Webs request object
+    @ingroup Webs
+ */
+PUBLIC void websParseVars(Webs *wp);
+
 /**
     Define the host name for the server
     @param host String host name
@@ -2652,7 +3171,7 @@ PUBLIC void websSetStatus(Webs *wp, int status);
     @param length Length value to use
     @ingroup Webs
  */
-PUBLIC void websSetTxLength(Webs *wp, ssize length);
+PUBLIC void websSetTxLength(Webs *wp, Offset length);
 
 /**
     Set a request variable to a formatted string value
@@ -2733,7 +3252,7 @@ PUBLIC bool websValid(Webs *wp);
     @ingroup Webs
     @see websSetStatus
  */
-PUBLIC void websWriteHeaders(Webs *wp, ssize contentLength, char *redirect);
+PUBLIC void websWriteHeaders(Webs *wp, Offset contentLength, char *redirect);
 
 /**
     Signify the end of the response headers
@@ -2791,6 +3310,41 @@ PUBLIC ssize websWriteFile(int fd, char *buf, ssize size);
  */
 PUBLIC ssize websWriteBlock(Webs *wp, char *buf, ssize size);
 
+/**
+    Write a string to the response with HTML special characters escaped
+    @description The escaped characters are written directly to the response output buffer. No intermediate copy
+        of the string is allocated. The characters &, <, >, " and ' are replaced by HTML entities.
+    @param wp Webs request object
+    @param str String to escape
+    @param len Length of str. Set to -1 to use the length of the null terminated string.
+    @return Count of bytes written after escaping. Returns -1 on errors.
+    @ingroup Webs
+ */
+PUBLIC ssize websWriteEscapedHtml(Webs *wp, char *str, ssize len);
+
+/**
+    Write a string to the response escaped for use inside a JSON string literal
+    @description Quotes, backslash and control characters are escaped. The "<" character is written as \u003c so
+        the output may be safely embedded in a script element.
+    @param wp Webs request object
+    @param str String to escape
+    @param len Length of str. Set to -1 to use the length of the null terminated string.
+    @return Count of bytes written after escaping. Returns -1 on errors.
+    @ingroup Webs
+ */
+PUBLIC ssize websWriteEscapedJson(Webs *wp, char *str, ssize len);
+
+/**
+    Write a string to the response encoded as a URI component
+    @description All characters other than letters, digits and "-._~" are written as %XX hex escapes.
+    @param wp Webs request object
+    @param str String to encode
+    @param len Length of str. Set to -1 to use the length of the null terminated string.
+    @return Count of bytes written after encoding. Returns -1 on errors.
+    @ingroup Webs
+ */
+PUBLIC ssize websWriteEscapedUri(Webs *wp, char *str, ssize len);
+
 /**
     Write a block of data to the network
     @description This bypassed output buffering and is the lowest level write.
@@ -2967,6 +3521,18 @@ typedef struct WebsRoute {
     WebsAskLogin    askLogin;               /**< Route path prefix */
     WebsParseAuth   parseAuth;              /**< Parse authentication details callback*/
     WebsVerify      verify;                 /**< Verify password callback */
+#if BIT_GOAHEAD_CACHE
+    int             lifespan;               /**< Response cache lifespan in seconds. Zero if not caching */
+#endif
+#if BIT_GOAHEAD_PROXY
+    char            *proxy;                 /**< Upstream URL for the proxy handler */
+#endif
+#if BIT_GOAHEAD_JSON
+    int             json;                   /**< Parse JSON request bodies into a document for websGetJson */
+#endif
+#if BIT_GOAHEAD_AIO
+    int             aio;                    /**< Always read documents using the I/O thread pool */
+#endif
     int             flags;                  /**< Route control flags */
 } WebsRoute;
 
@@ -3018,6 +3584,28 @@ PUBLIC int websRemoveRoute(char *uri);
  */
 PUBLIC void websRouteRequest(Webs *wp);
 
+/**
+    Check a request can be routed
+    @description This selects the matching route and authenticates the request without invoking the route handler.
+        It is used to reject a request before reading the request body. If the request cannot be routed or
+        access is denied, an error response is generated.
+    @param wp Webs request object
+    @return True if the request can be routed and is authorized.
+    @ingroup WebsRoute
+ */
+PUBLIC bool websCheckRoute(Webs *wp);
+
+/**
+    Select the route that is expected to service a request
+    @description This returns the first matching route that does not continue to later routes. It does not
+        authenticate or modify the request and does not generate an error response. It is used to make decisions
+        about the request body before the request is routed.
+    @param wp Webs request object
+    @return The matching route or null.
+    @ingroup WebsRoute
+ */
+PUBLIC WebsRoute *websSelectRoute(Webs *wp);
+
 /**
     Configure a route by adding matching criteria
     @param route Route to modify
@@ -3043,6 +3631,546 @@ PUBLIC int websSetRouteMatch(WebsRoute *route, char *dir, char *protocol, WebsHa
  */
 PUBLIC int websSetRouteAuth(WebsRoute *route, char *authType);
 
+/*************************************** Cache *********************************/
+#if BIT_GOAHEAD_CACHE
+/**
+    Response cache statistics
+    @see websGetCacheStats
+    @ingroup WebsRoute
+ */
+typedef struct WebsCacheStats {
+    int64       hits;                       /**< Requests served from a fresh cache item */
+    int64       misses;                     /**< Requests that generated a cache item */
+    int64       stale;                      /**< Requests served from a stale item while it was refreshed */
+    int64       waits;                      /**< Requests that waited for another request to fill an item */
+    int64       passes;                     /**< Requests that bypassed the cache for an uncacheable URL */
+    int64       evictions;                  /**< Items removed to stay within the memory limit */
+    int         items;                      /**< Number of cached items */
+    ssize       memory;                     /**< Memory used by cached items */
+} WebsCacheStats;
+
+/**
+    Cancel cache activity for a request
+    @description Called when a request is freed. If the request was filling a cache item, waiting requests are
+        rerouted.
+    @param wp Webs request object
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC void websCacheCancel(Webs *wp);
+
+/**
+    Add the response of a filling request to the cache
+    @description Called by websDone.
+    @param wp Webs request object
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC void websCacheComplete(Webs *wp);
+
+/**
+    Get a value from the value cache
+    @description The value cache is shared by all requests. Reading a value makes it the most recently used.
+    @param key Cache key
+    @param len Optional reference to receive the length of the value
+    @return The null terminated value or null if the key is not cached or has expired. The value is owned by the
+        cache and remains valid until the cache is next modified or the caller returns to the event loop.
+        Clone the value to keep it for longer.
+    @ingroup Webs
+ */
+PUBLIC char *websCacheGet(char *key, ssize *len);
+
+/**
+    Remove a value from the value cache
+    @param key Cache key
+    @ingroup Webs
+ */
+PUBLIC void websCacheRemove(char *key);
+
+/**
+    Serve a request from the response cache
+    @description Called when routing a request to a route with a cache lifespan.
+    @param wp Webs request object
+    @return True if the request has been served from the cache or is waiting for another request to fill the
+        cache item. False if the route handler should generate the response.
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC bool websCacheRequest(Webs *wp);
+
+/**
+    Set a value in the value cache
+    @description The value is copied into the cache. The least recently used values are evicted to stay within
+        the "limitCacheValues" memory limit. The key and value may be returned by websCacheGet as they are copied
+        before anything is removed or evicted.
+    @param key Cache key
+    @param value Value to cache. Set to null to remove the key.
+    @param len Length of the value. Set to -1 if the value is null terminated.
+    @param lifespan Lifespan in seconds. Set to zero to keep the value until it is evicted or removed.
+    @return Zero if successful, otherwise -1 if the value is too big to cache or memory cannot be allocated.
+    @ingroup Webs
+ */
+PUBLIC int websCacheSet(char *key, char *value, ssize len, int lifespan);
+
+/**
+    Capture response data for the cache
+    @description Called by websWriteBlock.
+    @param wp Webs request object
+    @param buf Data written
+    @param len Length of data written
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC void websCacheWrite(Webs *wp, char *buf, ssize len);
+
+/**
+    Close the response cache
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC void websCloseCache();
+
+/**
+    Get response cache statistics
+    @param stats Structure to receive the statistics
+    @ingroup WebsRoute
+ */
+PUBLIC void websGetCacheStats(WebsCacheStats *stats);
+
+/**
+    Open the response cache
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC int websOpenCache();
+
+/**
+    Set the response cache lifespan for a route
+    @description Successful GET responses for the route are cached and served to later requests for the same URL
+        until the lifespan expires.
+    @param route Route to modify
+    @param lifespan Lifespan in seconds. Set to zero to disable caching.
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsRoute
+ */
+PUBLIC int websSetRouteCache(WebsRoute *route, int lifespan);
+#endif
+
+/*************************************** Proxy *********************************/
+#if BIT_GOAHEAD_PROXY
+/**
+    Free the proxy state for a request
+    @description Called when a request is freed. Any upstream connection for an incomplete response is closed.
+    @param wp Webs request object
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC void websFreeProxy(Webs *wp);
+
+/**
+    Test if any routes use the proxy handler
+    @return True if a proxy route has been defined
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC bool websProxyEnabled();
+
+/**
+    Start forwarding a request before the body is received
+    @description Called when the request headers have been parsed for a request with a body. If the route uses the
+        proxy handler, the upstream request is started and the body is forwarded as it is received.
+    @param wp Webs request object
+    @param route Route selected for the request
+    @return 1 if the body will be forwarded, zero if the body should be received before routing and -1 if an error
+        response has been generated.
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC int websOpenProxyBody(Webs *wp, WebsRoute *route);
+
+/**
+    Process request body data for a proxied request
+    @description This routine is called by the core HTTP engine to forward request body data to the upstream.
+    @param wp Webs request object
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC int websProcessProxyData(Webs *wp);
+
+/**
+    Open the proxy handler
+    @ingroup WebsRoute
+    @internal
+ */
+PUBLIC int websProxyOpen();
+
+/**
+    Set the upstream server for a proxy route
+    @description Requests for routes using the "proxy" handler are forwarded to the upstream server. If the target
+        includes a path, the route prefix in the request URI is replaced with the path.
+    @param route Route to modify
+    @param target Upstream URL. For example: "http://127.0.0.1:9000/app".
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsRoute
+ */
+PUBLIC int websSetRouteProxy(WebsRoute *route, char *target);
+#endif
+
+/*************************************** JSON **********************************/
+
+#define WEBS_JSON_BUF       1024            /**< Size of the JSON writer output staging buffer */
+#define WEBS_JSON_DEPTH     32              /**< Maximum nesting of JSON objects and arrays plus one */
+
+/**
+    Streaming JSON writer
+    @description The writer formats values into a staging buffer in the context and writes them to the response in
+        blocks without allocating memory. Commas and member separators are inserted as required. Staged output is
+        written when the top level value is complete. After a misuse or write error, all further calls fail.
+    @see websJsonOpen
+    @defgroup WebsJson WebsJson
+ */
+typedef struct WebsJson {
+    Webs        *wp;                        /**< Request receiving the output */
+    uint        comma;                      /**< Bit for each nesting level that has written a value */
+    uint        objects;                    /**< Bit for each nesting level that is an object */
+    int         depth;                      /**< Current nesting level. Zero is the top level. */
+    int         key;                        /**< Set after a member name until its value is written */
+    int         error;                      /**< Set after a misuse or write error */
+    ssize       len;                        /**< Length of staged output in buf */
+    char        buf[WEBS_JSON_BUF];         /**< Staged output */
+} WebsJson;
+
+/**
+    Start writing JSON to a response
+    @param jp Writer context. Typically a local variable.
+    @param wp Webs request object
+    @ingroup WebsJson
+ */
+PUBLIC void websJsonOpen(WebsJson *jp, Webs *wp);
+
+/**
+    Start a JSON array
+    @param jp Writer context
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonBeginArray(WebsJson *jp);
+
+/**
+    Start a JSON object
+    @description Each member must be written by calling websJsonKey followed by a value routine.
+    @param jp Writer context
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonBeginObject(WebsJson *jp);
+
+/**
+    Write a boolean value
+    @param jp Writer context
+    @param value Value to write
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonBool(WebsJson *jp, bool value);
+
+#if BIT_FLOAT
+/**
+    Write a number
+    @description The value is written in fixed point if it has up to six decimal places. Otherwise the fewest of
+        15 to 17 significant digits that read back as the same value are written. Infinity and NaN are written as null.
+    @param jp Writer context
+    @param value Value to write
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonDouble(WebsJson *jp, double value);
+#endif
+
+/**
+    End a JSON array
+    @param jp Writer context
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonEndArray(WebsJson *jp);
+
+/**
+    End a JSON object
+    @param jp Writer context
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonEndObject(WebsJson *jp);
+
+/**
+    Write an integer
+    @param jp Writer context
+    @param value Value to write
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonInt(WebsJson *jp, int64 value);
+
+/**
+    Write an object member name
+    @param jp Writer context
+    @param key Member name. The name is escaped as required.
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonKey(WebsJson *jp, char *key);
+
+/**
+    Write a null value
+    @param jp Writer context
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonNull(WebsJson *jp);
+
+/**
+    Write a string value
+    @param jp Writer context
+    @param value String to write. The string is escaped by websWriteEscapedJson. If null, a JSON null is written.
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websJsonString(WebsJson *jp, char *value);
+
+#if BIT_GOAHEAD_JSON
+/*
+    JSON parser events
+ */
+#define WEBS_JSON_OBJECT        1           /**< Start of an object */
+#define WEBS_JSON_END_OBJECT    2           /**< End of an object */
+#define WEBS_JSON_ARRAY         3           /**< Start of an array */
+#define WEBS_JSON_END_ARRAY     4           /**< End of an array */
+#define WEBS_JSON_KEY           5           /**< Object member name */
+#define WEBS_JSON_STRING        6           /**< String value */
+#define WEBS_JSON_NUMBER        7           /**< Number value */
+#define WEBS_JSON_TRUE          8           /**< The literal true */
+#define WEBS_JSON_FALSE         9           /**< The literal false */
+#define WEBS_JSON_NULL          10          /**< The literal null */
+#define WEBS_JSON_EVENT_MASK    0xFF        /**< Mask for the event type */
+#define WEBS_JSON_ESCAPED       0x100       /**< Event flag. The key or string token contains escapes. */
+
+/**
+    JSON parser event callback
+    @description Called for each JSON token. The token references the parser input and is not null terminated. It is
+        only valid during the callback. Key and string tokens are the characters between the quotes. If the event
+        includes WEBS_JSON_ESCAPED, call websJsonDecode to decode the escapes.
+    @param data Data argument supplied to websJsonParserOpen
+    @param event Event type and flags
+    @param token Token text. Null for structure events.
+    @param len Length of the token
+    @return Zero to continue parsing or -1 to abort.
+    @ingroup WebsJson
+ */
+typedef int (*WebsJsonEvent)(void *data, int event, char *token, ssize len);
+
+/**
+    Incremental JSON parser
+    @description The parser may be fed the input as it is received. Each call to websJsonParse returns the count of
+        bytes consumed. Unconsumed bytes hold an incomplete token and must be supplied again, followed by more input,
+        on the next call.
+    @ingroup WebsJson
+ */
+typedef struct WebsJsonParser {
+    WebsJsonEvent   event;                  /**< Event callback */
+    void            *data;                  /**< Callback data argument */
+    char            *error;                 /**< Parse error message. Static string. */
+    ssize           pending;                /**< Length of an incomplete string token already scanned */
+    int             escaped;                /**< The incomplete string token contains escapes */
+    int             state;                  /**< Expected next token */
+    int             depth;                  /**< Current nesting level */
+    int             maxDepth;               /**< Maximum nesting level */
+    char            stack[BIT_GOAHEAD_LIMIT_JSON_DEPTH + 1];   /**< Container type for each nesting level */
+} WebsJsonParser;
+
+/**
+    JSON document node
+    @description Documents are created by websJsonParseDoc and freed as a whole by websJsonCloseDoc.
+    @ingroup WebsJson
+ */
+typedef struct WebsJsonNode {
+    struct WebsJsonNode *next;              /**< Next member or element of the parent */
+    struct WebsJsonNode *children;          /**< First member or element of an object or array */
+    char            *name;                  /**< Member name if the parent is an object */
+    char            *value;                 /**< Decoded string, number text or literal. Null for objects and arrays. */
+    ssize           len;                    /**< Length of value. Count of children for objects and arrays. */
+    int             type;                   /**< Node type. Set to the parser event for the value. */
+} WebsJsonNode;
+
+/**
+    Parsed JSON document
+    @description Nodes and strings are allocated from blocks owned by the document.
+    @ingroup WebsJson
+ */
+typedef struct WebsJsonDoc {
+    WebsJsonParser  parser;                 /**< Incremental parser */
+    WebsJsonNode    *root;                  /**< Root value. Set once the first value starts. */
+    WebsJsonNode    *parents[BIT_GOAHEAD_LIMIT_JSON_DEPTH + 1]; /**< Open object or array at each level */
+    WebsJsonNode    *last[BIT_GOAHEAD_LIMIT_JSON_DEPTH + 1];    /**< Last child at each level */
+    char            *name;                  /**< Pending member name */
+    void            *blocks;                /**< Allocation blocks */
+    char            *next;                  /**< Next free byte in the current block */
+    char            *end;                   /**< End of the current block */
+    ssize           memory;                 /**< Memory allocated for blocks */
+    ssize           maxMemory;              /**< Maximum memory for blocks */
+} WebsJsonDoc;
+
+/**
+    Close a JSON document and free its memory
+    @param doc Document returned by websJsonOpenDoc
+    @ingroup WebsJson
+ */
+PUBLIC void websJsonCloseDoc(WebsJsonDoc *doc);
+
+/**
+    Decode the escapes in a key or string token
+    @param buf Buffer to receive the decoded, null terminated string. May be the token itself.
+    @param size Size of buf. The decoded string is never longer than the token.
+    @param token Token text
+    @param len Length of token
+    @return Length of the decoded string, otherwise -1 if the token is invalid or buf is too small.
+    @ingroup WebsJson
+ */
+PUBLIC ssize websJsonDecode(char *buf, ssize size, char *token, ssize len);
+
+/**
+    Get an object member
+    @param node Object node
+    @param name Member name
+    @return The member node or null if not found.
+    @ingroup WebsJson
+ */
+PUBLIC WebsJsonNode *websJsonGet(WebsJsonNode *node, char *name);
+
+/**
+    Get an array element
+    @param node Array node
+    @param index Element index
+    @return The element node or null if not found.
+    @ingroup WebsJson
+ */
+PUBLIC WebsJsonNode *websJsonGetItem(WebsJsonNode *node, int index);
+
+/**
+    Open a JSON document to receive parsed input
+    @param maxMemory Maximum memory for the document. Set to zero for BIT_GOAHEAD_LIMIT_JSON.
+    @return A document or null if memory can't be allocated.
+    @ingroup WebsJson
+ */
+PUBLIC WebsJsonDoc *websJsonOpenDoc(ssize maxMemory);
+
+/**
+    Parse JSON input
+    @description Parses as much of the input as possible and issues an event for each complete token.
+    @param parser Parser opened by websJsonParserOpen
+    @param buf Input to parse
+    @param len Length of buf
+    @param eof Set if this is the end of the input
+    @return Count of bytes consumed. Returns -1 on parse errors and sets parser->error.
+    @ingroup WebsJson
+ */
+PUBLIC ssize websJsonParse(WebsJsonParser *parser, char *buf, ssize len, bool eof);
+
+/**
+    Parse JSON input into a document
+    @description The input may be supplied incrementally as for websJsonParse.
+    @param doc Document opened by websJsonOpenDoc
+    @param buf Input to parse
+    @param len Length of buf
+    @param eof Set if this is the end of the input
+    @return Count of bytes consumed. Returns -1 on parse errors or if the memory limit is exceeded.
+    @ingroup WebsJson
+ */
+PUBLIC ssize websJsonParseDoc(WebsJsonDoc *doc, char *buf, ssize len, bool eof);
+
+/**
+    Open a JSON parser
+    @param parser Parser to initialize
+    @param event Callback for parser events
+    @param data Data argument for the callback
+    @ingroup WebsJson
+ */
+PUBLIC void websJsonParserOpen(WebsJsonParser *parser, WebsJsonEvent event, void *data);
+
+/**
+    Define an action that receives the request JSON body as parser events
+    @description JSON request bodies for the action are parsed as they are received and the events passed to
+        the event callback with the request as the data argument. The action procedure is then run as for
+        websDefineAction. Bodies for routes with the "json" option are parsed into a document that is returned by
+        websGetJson. Bodies for other requests are not parsed.
+    @param name Action name
+    @param fn Action procedure
+    @param event Parser event callback
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+ */
+PUBLIC int websDefineJsonAction(char *name, void *fn, WebsJsonEvent event);
+
+/**
+    Free the JSON body parser state for a request
+    @param wp Webs request object
+    @ingroup WebsJson
+    @internal
+ */
+PUBLIC void websFreeJson(Webs *wp);
+
+/**
+    Prepare to parse a JSON request body
+    @description Called after the request headers are parsed when the body has an application/json content type.
+        The body is parsed only for actions defined via websDefineJsonAction and for routes with the "json" option.
+        The body for other handlers is not parsed and is passed to the handler as for other content types.
+    @param wp Webs request object
+    @return Zero if successful, otherwise -1 if memory can't be allocated.
+    @ingroup WebsJson
+    @internal
+ */
+PUBLIC int websOpenJsonBody(Webs *wp);
+
+/**
+    Get the JSON event callback for an action request
+    @param wp Webs request object
+    @return The callback defined by websDefineJsonAction or null.
+    @ingroup WebsJson
+    @internal
+ */
+PUBLIC WebsJsonEvent websGetActionJsonEvent(Webs *wp);
+
+/**
+    Get the parsed JSON request body
+    @param wp Webs request object
+    @return The root value of the body. Null if the body is not JSON or the route does not have the "json" option.
+    @ingroup WebsJson
+ */
+PUBLIC WebsJsonNode *websGetJson(Webs *wp);
+
+/**
+    Get a member of the JSON request body
+    @param wp Webs request object
+    @param name Name of a member of the top level object
+    @param defaultValue Value to return if the member is missing or is an object or array.
+    @return The member value text.
+    @ingroup WebsJson
+ */
+PUBLIC char *websGetJsonVar(Webs *wp, char *name, char *defaultValue);
+
+/**
+    Process JSON request body data
+    @description Called as body data is received. Consumes the parsed input.
+    @param wp Webs request object
+    @return Zero if successful, otherwise -1.
+    @ingroup WebsJson
+    @internal
+ */
+PUBLIC int websProcessJsonData(Webs *wp);
+#endif /* BIT_GOAHEAD_JSON */
+
 /*************************************** Auth **********************************/
 #if BIT_GOAHEAD_AUTH
 
@@ -3253,7 +4381,8 @@ PUBLIC WebsSession *websAllocSession(Webs *wp, char *id, WebsTime lifespan);
 /**
     Get the session ID
     @param wp Webs request object
-    @return The session ID if session state storage is defined for this request.
+    @return The session ID if session state storage is defined for this request. The ID is owned by the request and 
+        must not be freed.
     @ingroup WebsSession
  */
 PUBLIC char *websGetSessionID(Webs *wp);
@@ -3295,6 +4424,94 @@ PUBLIC void websRemoveSessionVar(Webs *wp, char *name);
  */
 PUBLIC int websSetSessionVar(Webs *wp, char *name, char *value);
 
+/*************************************** Stats *********************************/
+#if BIT_GOAHEAD_STATS
+
+#define WEBS_STATS_MAGIC    0x53424557      /**< Statistics file signature: "WEBS" in little endian byte order */
+#define WEBS_STATS_VERSION  1               /**< Statistics file layout version */
+
+/**
+    Server statistics
+    @description The server keeps these counters in memory and copies them to a memory mapped statistics file
+        after each pass of the event loop. Monitoring programs such as goahead-stat map the file and read the
+        counters without issuing requests to the server. The layout is fixed for each WEBS_STATS_VERSION.
+        The seq field is a sequence lock. It is odd while the server is updating the file. Readers copy the counters
+        and retry if seq was odd or changed during the copy.
+    @see websOpenStats websReadStats
+    @ingroup Webs
+ */
+typedef struct WebsStats {
+    uint        magic;                      /**< WEBS_STATS_MAGIC */
+    uint        version;                    /**< WEBS_STATS_VERSION */
+    uint        size;                       /**< Size of this structure */
+    uint        seq;                        /**< Sequence lock. Odd while an update is in progress. */
+    int64       pid;                        /**< Server process ID */
+    int64       started;                    /**< Time the server started (seconds since 1970) */
+    int64       updated;                    /**< Time of the last update (milliseconds since 1970) */
+    int64       requests;                   /**< Requests received */
+    int64       errors;                     /**< Error responses sent */
+    int64       bytesRead;                  /**< Bytes read from clients */
+    int64       bytesWritten;               /**< Bytes written to clients */
+    int64       connections;                /**< Connections accepted */
+    int64       activeConnections;          /**< Connections currently open */
+    int64       loopLag;                    /**< Longest event loop pass in the last second (msec) */
+    int64       maxLoopLag;                 /**< Longest event loop pass since the server started (msec) */
+    int64       sessions;                   /**< Active sessions */
+    int64       allocMemory;                /**< Memory allocated via walloc. Sampled from the system allocator once per
+                                                 second without replaceMalloc. -1 if not available. */
+    int64       allocCount;                 /**< Allocations via walloc. -1 without replaceMalloc. */
+    int64       allocFailures;              /**< Failed allocations via walloc. -1 without replaceMalloc. */
+} WebsStats;
+
+/**
+    Server statistics updated by the server
+    @ingroup Webs
+    @internal
+ */
+PUBLIC_DATA WebsStats websStats;
+
+/**
+    Stop publishing statistics and remove the statistics file
+    @ingroup Webs
+ */
+PUBLIC void websCloseStats();
+
+/**
+    Publish statistics to a memory mapped file
+    @description The file is created or truncated and updated after each pass of the event loop. Unix only.
+    @param path Statistics file path
+    @return Zero if successful, otherwise -1.
+    @ingroup Webs
+ */
+PUBLIC int websOpenStats(char *path);
+
+/**
+    Read a consistent copy of the statistics published by a server
+    @description This is used by monitoring programs and does not communicate with the server.
+    @param path Statistics file path given to websOpenStats
+    @param stats Structure to receive the statistics
+    @return Zero if successful, otherwise -1 if the file cannot be read or has a different layout version.
+    @ingroup Webs
+ */
+PUBLIC int websReadStats(char *path, WebsStats *stats);
+
+/**
+    Note the start of an event loop pass
+    @description Called by websServiceEvents.
+    @ingroup Webs
+    @internal
+ */
+PUBLIC void websStatsLoopStart();
+
+/**
+    Note the end of an event loop pass and publish the statistics
+    @description Called by websServiceEvents.
+    @ingroup Webs
+    @internal
+ */
+PUBLIC void websStatsLoopEnd();
+#endif
+
 /************************************ Legacy **********************************/
 /*
     Legacy mappings for pre GoAhead 3.X applications
@@ -3408,7 +4625,7 @@ PUBLIC int websSetSessionVar(Webs *wp, char *name, char *value);
     #define websGetRequestFlags(wp) wp->flags
     #define websGetRequestLpath(wp) wp->filename
     #define websGetRequestPath(wp) wp->path
-    #define websGetRequestPassword(wp) wp->password
+    #define websGetRequestPassword(wp) websGetPassword(wp)
     #define websGetRequestUserName(wp) wp->username
     #define websGetRequestWritten(wp) wp->written
 
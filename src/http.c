@@ -21,6 +21,9 @@ static int defaultSslPort;              /* Default port number for https */
 #define WEBS_TIMEOUT (BIT_GOAHEAD_LIMIT_TIMEOUT * 1000)
 #define PARSE_TIMEOUT (BIT_GOAHEAD_LIMIT_PARSE_TIMEOUT * 1000)
 #define CHUNK_LOW   128                 /* Low water mark for chunking */
+#define READ_BUDGET 16                  /* Maximum reads per readable event before yielding to other connections */
+#define READ_MAX    (BIT_GOAHEAD_LIMIT_BUFFER * 8)  /* Maximum size of a single socket read */
+#define IDLE_REAP   8                   /* Idle connections closed at a time when short of descriptors or memory */
 
 /************************************ Locals **********************************/
 
@@ -29,12 +32,26 @@ static int          listenMax;
 static Webs         **webs;                     /* Open connection list head */
 static WebsHash     websMime;                   /* Set of mime types */
 static int          websMax;                    /* List size */
+static Webs         *idleHead;                  /* Least recently used idle keep-alive connection */
+static Webs         *idleTail;                  /* Most recently used idle keep-alive connection */
+static int          idleCount;                  /* Number of idle keep-alive connections */
+static int          fileHigh = MAXINT;          /* Descriptor high water mark to start closing idle connections */
 static char         websHost[64];               /* Host name for the server */
 static char         websIpAddr[64];             /* IP address for the server */
 static char         *websHostUrl = NULL;        /* URL to access server */
 static char         *websIpAddrUrl = NULL;      /* URL to access server */
 
 #define WEBS_ENCODE_HTML    0x1                 /* Bit setting in charMatch[] */
+#define WEBS_ENCODE_URI     0x8                 /* Encode as a URI component */
+
+/*
+    Word at a time character matching. WORD_HAS_ZERO is non-zero if any byte in the word is zero.
+ */
+#define WORD_ONES           ((uint64) 0x0101010101010101LL)
+#define WORD_HIGHS          ((uint64) 0x8080808080808080LL)
+#define WORD_HAS_ZERO(w)    (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+#define WORD_HAS_BYTE(w, c) WORD_HAS_ZERO((w) ^ (WORD_ONES * (uchar) (c)))
+#define WORD_HAS_LESS(w, n) (((w) - WORD_ONES * (n)) & ~(w) & WORD_HIGHS)
 
 /*
     Character escape/descape matching codes. Generated by charGen.
@@ -175,6 +192,7 @@ static WebsError websErrors[] = {
     { 406, "Not Acceptable" },
     { 408, "Request Timeout" },
     { 413, "Request too large" },
+    { 417, "Expectation Failed" },
     { 500, "Internal Server Error" },
     { 501, "Not Implemented" },
     { 503, "Service Unavailable" },
@@ -193,8 +211,17 @@ static int      pruneId;                            /* Callback ID */
 /**************************** Forward Declarations ****************************/
 
 static void     checkTimeout(void *arg, int id);
+static void     freeAuthState(WebsAuthState *auth);
 static WebsTime dateParse(WebsTime tip, char *cmd);
+static bool     checkRoute(Webs *wp);
+static bool     expectContinue(Webs *wp);
+static void     idleAdd(Webs *wp);
+static void     idleRemove(Webs *wp);
 static bool     filterChunkData(Webs *wp);
+static ssize    htmlSpan(char *str, ssize len);
+static ssize    jsonSpan(char *str, ssize len);
+static ssize    uriSpan(char *str, ssize len);
+static ssize    writeEscaped(Webs *wp, char *str, ssize len, ssize (*span)(char*, ssize), char *(*escape)(int, char*));
 static WebsTime getTimeSinceMark(Webs *wp);
 static char     *getToken(Webs *wp, char *delim);
 static void     parseFirstLine(Webs *wp);
@@ -203,6 +230,8 @@ static bool     processContent(Webs *wp);
 static bool     parseIncoming(Webs *wp);
 static void     pruneCache();
 static void     readEvent(Webs *wp);
+static int      reapIdle(int count);
+static ssize    readSize(Webs *wp);
 static void     reuseConn(Webs *wp);
 static void     setFileLimits();
 static int      setLocalHost();
@@ -246,6 +275,11 @@ PUBLIC int websOpen(char *documents, char *routeFile)
     if (websOpenRoute() < 0) {
         return -1;
     }
+#if BIT_GOAHEAD_CACHE
+    if (websOpenCache() < 0) {
+        return -1;
+    }
+#endif
 #if BIT_GOAHEAD_CGI && !BIT_ROM
     websCgiOpen();
 #endif
@@ -258,12 +292,18 @@ PUBLIC int websOpen(char *documents, char *routeFile)
 #if BIT_GOAHEAD_JAVASCRIPT
     websJstOpen();
 #endif
+#if BIT_GOAHEAD_PROXY
+    websProxyOpen();
+#endif
 #if BIT_GOAHEAD_AUTH
     if (websOpenAuth(0) < 0) {
         return -1;
     }
 #endif
     websFsOpen();
+#if BIT_GOAHEAD_AIO
+    websAioOpen();
+#endif
     if (websLoad(routeFile) < 0) {
         return -1;
     }
@@ -318,6 +358,18 @@ PUBLIC void websClose()
         wp->sid = -1;
         websFree(wp);
     }
+#if BIT_GOAHEAD_CACHE
+    websCloseCache();
+#endif
+#if BIT_GOAHEAD_AIO
+    websAioClose();
+#endif
+#if BIT_GOAHEAD_FIBER
+    websFiberClose();
+#endif
+#if BIT_GOAHEAD_STATS
+    websCloseStats();
+#endif
     wfree(websHostUrl);
     wfree(websIpAddrUrl);
     websIpAddrUrl = websHostUrl = NULL;
@@ -340,48 +392,71 @@ PUBLIC void websClose()
 }
 
 
+/*
+    Initialize a request. New requests are zeroed by wallocObject. When a keep-alive connection is reused, termWebs
+    has released the optional authentication, CGI, upload, JSON, cache and proxy state and cleared the references,
+    so only the fields set while processing a request are reset here. The connection fields (wid, sid, timeout, ssl,
+    addresses, rxbuf and request count) are preserved.
+ */
 static void initWebs(Webs *wp, int flags, int reuse)
 {
-    WebsBuf     rxbuf;
-    void        *ssl;
-    int         wid, sid, timeout;
-
     assert(wp);
 
     if (reuse) {
-        rxbuf = wp->rxbuf;
-        wid = wp->wid;
-        sid = wp->sid;
-        timeout = wp->timeout;
-        ssl = wp->ssl;
+        wp->rxChunkState = 0;
+        wp->txChunkState = 0;
+        wp->rxRemaining = 0;
+        wp->written = 0;
+        wp->lastRead = 0;
+        wp->writeData = 0;
+        wp->route = 0;
+        wp->eof = 0;
+        wp->since = 0;
+        wp->rxChunkSize = 0;
+        wp->rxEndp = 0;
+        wp->txChunkPrefixNext = 0;
+        wp->txChunkPrefixLen = 0;
+        wp->txChunkLen = 0;
+        wp->authType = wp->contentType = wp->cookie = wp->sessionCookie = wp->decodedQuery = 0;
+        wp->ext = wp->filename = wp->host = wp->inputFile = wp->method = wp->path = 0;
+        wp->protoVersion = wp->protocol = wp->putname = wp->query = wp->referrer = 0;
+        wp->responseCookie = wp->url = wp->userAgent = wp->username = 0;
+        wp->cookies = 0;
+        wp->cookieCount = 0;
+        wp->putLen = 0;
+        wp->session = 0;
+        wp->user = 0;
+#if BIT_ROM
+        wp->rom = 0;
+        wp->romData = 0;
+        wp->romLen = 0;
+#endif
+#if BIT_GOAHEAD_MMAP
+        wp->mapPos = 0;
+#endif
+#if BIT_GOAHEAD_AIO
+        wp->aioPos = 0;
+#endif
+#if BIT_GOAHEAD_CACHE
+        wp->cachePos = 0;
+#endif
     } else {
-        wid = sid = -1;
-        timeout = -1;
-        ssl = 0;
+        wp->wid = wp->sid = -1;
+        wp->timeout = -1;
+        bufCreate(&wp->rxbuf, BIT_GOAHEAD_LIMIT_HEADERS, (int) min(BIT_GOAHEAD_LIMIT_HEADERS + BIT_GOAHEAD_LIMIT_PUT, MAXINT));
     }
-    memset(wp, 0, sizeof(Webs));
     wp->flags = flags;
     wp->state = WEBS_BEGIN;
-    wp->wid = wid;
-    wp->sid = sid;
-    wp->timeout = timeout;
+    wp->code = HTTP_CODE_OK;
     wp->docfd = -1;
+#if BIT_GOAHEAD_OPENAT
+    wp->docdir = -1;
+#endif
     wp->txLen = -1;
     wp->rxLen = -1;
-    wp->code = HTTP_CODE_OK;
-    wp->ssl = ssl;
 #if !BIT_ROM
     wp->putfd = -1;
 #endif
-#if BIT_GOAHEAD_CGI
-    wp->cgifd = -1;
-#endif
-#if BIT_GOAHEAD_UPLOAD
-    wp->upfd = -1;
-#endif
-    if (!reuse) {
-        wp->timeout = -1;
-    }
     wp->vars = hashCreate(WEBS_HASH_INIT);
     /*
         Ring queues can never be totally full and are short one byte. Better to do even I/O and allocate
@@ -390,13 +465,7 @@ static void initWebs(Webs *wp, int flags, int reuse)
     assert(BIT_GOAHEAD_LIMIT_BUFFER >= 1024);
     bufCreate(&wp->output, BIT_GOAHEAD_LIMIT_BUFFER + 1, BIT_GOAHEAD_LIMIT_BUFFER + 1);
     bufCreate(&wp->chunkbuf, BIT_GOAHEAD_LIMIT_BUFFER + 1, BIT_GOAHEAD_LIMIT_BUFFER * 2);
-    bufCreate(&wp->input, BIT_GOAHEAD_LIMIT_BUFFER + 1, BIT_GOAHEAD_LIMIT_PUT + 1);
-    if (reuse) {
-        wp->rxbuf = rxbuf;
-    } else {
-        bufCreate(&wp->rxbuf, BIT_GOAHEAD_LIMIT_HEADERS, BIT_GOAHEAD_LIMIT_HEADERS + BIT_GOAHEAD_LIMIT_PUT);
-    }
-    wp->rxbuf = wp->rxbuf;
+    bufCreate(&wp->input, BIT_GOAHEAD_LIMIT_BUFFER + 1, (int) min(BIT_GOAHEAD_LIMIT_PUT + 1, MAXINT));
 }
 
 
@@ -422,9 +491,13 @@ static void termWebs(Webs *wp, int reuse)
         }
     }
 #if BIT_GOAHEAD_CGI
-    if (wp->cgifd >= 0) {
-        close(wp->cgifd);
-        wp->cgifd = -1;
+    if (wp->cgi) {
+        if (wp->cgi->cgifd >= 0) {
+            close(wp->cgi->cgifd);
+        }
+        wfree(wp->cgi->cgiStdin);
+        wfree(wp->cgi);
+        wp->cgi = 0;
     }
 #endif
 #if !BIT_ROM
@@ -436,56 +509,59 @@ static void termWebs(Webs *wp, int reuse)
             error("Can't rename put file from %s to %s", wp->putname, wp->filename);
         }
     }
+#endif
+#if BIT_GOAHEAD_CACHE
+    websCacheCancel(wp);
+#endif
+#if BIT_GOAHEAD_PROXY
+    websFreeProxy(wp);
+#endif
+#if BIT_GOAHEAD_MMAP
+    if (wp->map) {
+        websUnmapFile(wp->map);
+        wp->map = 0;
+    }
+#endif
+#if BIT_GOAHEAD_AIO
+    websAioCancel(wp);
+#endif
+#if BIT_GOAHEAD_FIBER
+    websFiberCancel(wp);
 #endif
     websPageClose(wp);
     if (wp->timeout >= 0 && !reuse) {
         websCancelTimeout(wp);
     }
-    wfree(wp->authDetails);
-    wfree(wp->authResponse);
     wfree(wp->authType);
     wfree(wp->contentType);
     wfree(wp->cookie);
+    wfree(wp->cookies);
     wfree(wp->decodedQuery);
-    wfree(wp->digest);
     wfree(wp->ext);
     wfree(wp->filename);
     wfree(wp->host);
     wfree(wp->inputFile);
     wfree(wp->method);
-    wfree(wp->password);
     wfree(wp->path);
     wfree(wp->protoVersion);
     wfree(wp->putname);
     wfree(wp->query);
-    wfree(wp->realm);
     wfree(wp->referrer);
     wfree(wp->responseCookie);
     wfree(wp->url);
     wfree(wp->userAgent);
     wfree(wp->username);
-#if BIT_GOAHEAD_UPLOAD
-    wfree(wp->boundary);
-    wfree(wp->uploadTmp);
-    wfree(wp->uploadVar);
-#endif
-#if BIT_GOAHEAD_CGI
-    wfree(wp->cgiStdin);
-#endif
-#if BIT_DIGEST
-    wfree(wp->cnonce);
-    wfree(wp->digestUri);
-    wfree(wp->opaque);
-    wfree(wp->nc);
-    wfree(wp->nonce);
-    wfree(wp->qop);
-#endif
+    if (wp->auth) {
+        freeAuthState(wp->auth);
+        wp->auth = 0;
+    }
     hashFree(wp->vars);
 
 #if BIT_GOAHEAD_UPLOAD
-    if (wp->files) {
-        websFreeUpload(wp);
-    }
+    websFreeUpload(wp);
+#endif
+#if BIT_GOAHEAD_JSON
+    websFreeJson(wp);
 #endif
 }
 
@@ -504,6 +580,10 @@ PUBLIC int websAlloc(int sid)
     wp->wid = wid;
     wp->sid = sid;
     wp->timestamp = time(0);
+#if BIT_GOAHEAD_STATS
+    websStats.connections++;
+    websStats.activeConnections++;
+#endif
     return wid;
 }
 
@@ -519,6 +599,7 @@ static void reuseConn(Webs *wp)
     }
     termWebs(wp, 1);
     initWebs(wp, wp->flags & (WEBS_KEEP_ALIVE | WEBS_SECURE | WEBS_HTTP11), 1);
+    wp->requests++;
 }
 
 
@@ -527,10 +608,16 @@ PUBLIC void websFree(Webs *wp)
     assert(wp);
     assert(websValid(wp));
 
+    if (wp->flags & WEBS_IDLE) {
+        idleRemove(wp);
+    }
     termWebs(wp, 0);
     websMax = wfreeHandle(&webs, wp->wid);
     wfree(wp);
     assert(websMax >= 0);
+#if BIT_GOAHEAD_STATS
+    websStats.activeConnections--;
+#endif
 }
 
 
@@ -549,6 +636,9 @@ PUBLIC void websDone(Webs *wp)
     }
     assert(WEBS_BEGIN <= wp->state && wp->state < WEBS_COMPLETE);
     wp->flags |= WEBS_FINALIZED;
+#if BIT_GOAHEAD_CACHE
+    websCacheComplete(wp);
+#endif
 
     if (!websFlush(wp)) {
         /* Need to wait for output buffer to drain */
@@ -557,6 +647,12 @@ PUBLIC void websDone(Webs *wp)
     }
 #if BIT_GOAHEAD_ACCESS_LOG
     logRequest(wp, wp->code);
+#endif
+#if BIT_GOAHEAD_STATS
+    websStats.requests++;
+    if (wp->code >= 400) {
+        websStats.errors++;
+    }
 #endif
     websPageClose(wp);
     if (!(wp->flags & WEBS_RESPONSE_TRACED)) {
@@ -574,6 +670,9 @@ static void complete(Webs *wp, int reuse)
     if (reuse && wp->flags & WEBS_KEEP_ALIVE && wp->rxRemaining == 0) {
         reuseConn(wp);
         socketCreateHandler(wp->sid, SOCKET_READABLE, socketEvent, wp);
+        if (bufLen(&wp->rxbuf) == 0) {
+            idleAdd(wp);
+        }
         trace(5, "Keep connection alive");
         return;
     }
@@ -661,11 +760,18 @@ PUBLIC int websAccept(int sid, char *ipaddr, int port, int listenSid)
     assert(listenSid >= 0);
     assert(port >= 0);
 
+    if (socketList[sid]->sock >= fileHigh) {
+        /* Running short of descriptors. Close the least recently used idle connections first. */
+        reapIdle(IDLE_REAP);
+    }
     /*
         Allocate a new handle for this accepted connection. This will allocate a Webs structure in the webs[] list
      */
     if ((wid = websAlloc(sid)) < 0) {
-        return -1;
+        /* Running short of memory */
+        if (reapIdle(IDLE_REAP) == 0 || (wid = websAlloc(sid)) < 0) {
+            return -1;
+        }
     }
     wp = webs[wid];
     assert(wp);
@@ -770,7 +876,8 @@ static void readEvent(Webs *wp)
 {
     WebsBuf     *rxbuf;
     WebsSocket  *sp;
-    ssize       nbytes;
+    ssize       nbytes, size;
+    int         budget;
 
     assert(wp);
     assert(websValid(wp));
@@ -779,26 +886,48 @@ static void readEvent(Webs *wp)
         return;
     }
     websNoteRequestActivity(wp);
+    if (wp->flags & WEBS_IDLE) {
+        idleRemove(wp);
+    }
     rxbuf = &wp->rxbuf;
 
-    if (bufRoom(rxbuf) < (BIT_GOAHEAD_LIMIT_BUFFER + 1)) {
-        if (!bufGrow(rxbuf, BIT_GOAHEAD_LIMIT_BUFFER + 1)) {
-            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't grow rxbuf");
+    /*
+        Read until the socket is drained, the request has been received or the read budget is exhausted. This lets 
+        large bodies be received in a few loop iterations while preserving fairness for other connections.
+     */
+    for (budget = READ_BUDGET; ; ) {
+        size = readSize(wp);
+        if (bufRoom(rxbuf) < (size + 1)) {
+            if (!bufGrow(rxbuf, size + 1)) {
+                websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't grow rxbuf");
+                websPump(wp);
+                return;
+            }
+        }
+        if ((nbytes = websRead(wp, (char*) rxbuf->endp, size)) > 0) {
+            wp->lastRead = nbytes;
+#if BIT_GOAHEAD_STATS
+            websStats.bytesRead += nbytes;
+#endif
+            bufAdjustEnd(rxbuf, nbytes);
+            bufAddNull(rxbuf);
+        } 
+        if (nbytes > 0 || wp->state > WEBS_BEGIN) {
             websPump(wp);
+        }
+        if (wp->flags & WEBS_CLOSED) {
             return;
         }
+        /*
+            A short read means the socket has no more data (the next read would return EAGAIN). Also stop if the 
+            request has moved past receiving, if the received data is not being consumed or if reading is paused.
+         */
+        if (nbytes < size || --budget <= 0 || wp->state >= WEBS_READY || bufLen(rxbuf) > READ_MAX ||
+                (wp->flags & WEBS_INPUT_PAUSED)) {
+            break;
+        }
     }
-    if ((nbytes = websRead(wp, (char*) rxbuf->endp, BIT_GOAHEAD_LIMIT_BUFFER)) > 0) {
-        wp->lastRead = nbytes;
-        bufAdjustEnd(rxbuf, nbytes);
-        bufAddNull(rxbuf);
-    } 
-    if (nbytes > 0 || wp->state > WEBS_BEGIN) {
-        websPump(wp);
-    }
-    if (wp->flags & WEBS_CLOSED) {
-        return;
-    } else if (nbytes < 0 && socketEof(wp->sid)) {
+    if (nbytes < 0 && socketEof(wp->sid)) {
         /* EOF or error. Allow running requests to continue. */
         if (wp->state < WEBS_READY) {
             if (wp->state > WEBS_BEGIN) {
@@ -806,14 +935,49 @@ static void readEvent(Webs *wp)
                 websPump(wp);
             }
             complete(wp, 0);
+#if BIT_GOAHEAD_FIBER
+        } else if (wp->fiber) {
+            /* The client is gone while a fiber waits. Close so the fiber is cancelled and can release resources. */
+            wp->state = WEBS_COMPLETE;
+            complete(wp, 0);
+#endif
+        } else {
+            /* Stop read events which would otherwise repeat until the request completes */
+            sp = socketPtr(wp->sid);
+            socketRegisterInterest(wp->sid, sp->handlerMask & ~SOCKET_READABLE);
         }
-    } else if (wp->state < WEBS_READY) {
+    } else if (wp->state < WEBS_READY && !(wp->flags & WEBS_INPUT_PAUSED)) {
+        sp = socketPtr(wp->sid);
+        socketCreateHandler(wp->sid, sp->handlerMask | SOCKET_READABLE, socketEvent, wp);
+#if BIT_GOAHEAD_FIBER
+    } else if (wp->fiber && bufLen(rxbuf) <= READ_MAX) {
+        /* Watch for the client closing the connection while the fiber waits */
         sp = socketPtr(wp->sid);
         socketCreateHandler(wp->sid, sp->handlerMask | SOCKET_READABLE, socketEvent, wp);
+#endif
     }
 }
 
 
+/*
+    Compute the size of the next socket read. Grow beyond the default buffer size while reads are filling the buffer,
+    but don't read beyond the remaining request body.
+ */
+static ssize readSize(Webs *wp)
+{
+    ssize   size;
+
+    size = BIT_GOAHEAD_LIMIT_BUFFER;
+    if (wp->lastRead >= size) {
+        size = min(wp->lastRead * 2, READ_MAX);
+    }
+    if (wp->state == WEBS_CONTENT && wp->rxChunkState == WEBS_CHUNK_UNCHUNKED && wp->rxRemaining > 0) {
+        size = min(size, wp->rxRemaining);
+    }
+    return size;
+}
+
+
 PUBLIC void websPump(Webs *wp)
 {
     bool    canProceed;
@@ -862,6 +1026,15 @@ static bool parseIncoming(Webs *wp)
     c = *end;
     *end = '\0';
     trace(3 | WEBS_RAW_MSG, "%s\n", wp->rxbuf.servp);
+#if BIT_GOAHEAD_PROXY
+    if (websProxyEnabled()) {
+        /* Preserve the raw headers for forwarding as parsing tokenizes them in-place */
+        char *cp;
+        if ((cp = strchr(wp->rxbuf.servp, '\n')) != 0) {
+            wp->headers = sclone(&cp[1]);
+        }
+    }
+#endif
     *end = c;
 
     /*
@@ -877,12 +1050,45 @@ static bool parseIncoming(Webs *wp)
     }
     wp->state = (wp->rxChunkState || wp->rxLen > 0) ? WEBS_CONTENT : WEBS_READY;
 
+    if (wp->state == WEBS_CONTENT && (wp->flags & WEBS_EXPECT_CONTINUE) && !expectContinue(wp)) {
+        return 1;
+    }
+#if BIT_GOAHEAD_PROXY
+    if (wp->state == WEBS_CONTENT && websProxyEnabled()) {
+        /*
+            Proxied request bodies are forwarded as they are received rather than being buffered. Authorize first
+            so the body is not forwarded for a request that will be rejected.
+         */
+        WebsRoute   *route;
+        if ((route = websSelectRoute(wp)) != 0 && route->proxy) {
+            if (!(wp->flags & WEBS_EXPECT_CONTINUE) && !checkRoute(wp)) {
+                return 1;
+            }
+            if (websOpenProxyBody(wp, route) < 0) {
+                if (wp->state < WEBS_COMPLETE) {
+                    wp->state = WEBS_RUNNING;
+                }
+                return 1;
+            }
+            if (wp->proxy) {
+                /* The body is forwarded and not received by the CGI or PUT handlers */
+                return 1;
+            }
+        }
+    }
+#endif
+
 #if !BIT_ROM
 #if BIT_GOAHEAD_CGI
     if (strstr(wp->path, BIT_GOAHEAD_CGI_BIN) != 0) {
         if (smatch(wp->method, "POST")) {
-            wp->cgiStdin = websGetCgiCommName();
-            if ((wp->cgifd = open(wp->cgiStdin, O_CREAT | O_WRONLY | O_BINARY, 0666)) < 0) {
+            WebsCgiState    *cgi;
+            if ((cgi = websGetCgiState(wp)) == 0) {
+                websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR | WEBS_CLOSE, "Can't allocate CGI state");
+                return 1;
+            }
+            cgi->cgiStdin = websGetCgiCommName();
+            if ((cgi->cgifd = open(cgi->cgiStdin, O_CREAT | O_WRONLY | O_BINARY, 0666)) < 0) {
                 websError(wp, HTTP_CODE_NOT_FOUND | WEBS_CLOSE, "Can't open CGI file");
                 return 1;
             }
@@ -905,6 +1111,49 @@ static bool parseIncoming(Webs *wp)
 }
 
 
+/*
+    The client is waiting for permission to send the body. Route and authorize the request now so a request that
+    will be rejected is answered before the body is sent. Otherwise send an interim "100 Continue" response.
+ */
+static bool expectContinue(Webs *wp)
+{
+    if (!checkRoute(wp)) {
+        return 0;
+    }
+    if (wp->flags & WEBS_HTTP11) {
+        bufPutStr(&wp->output, "HTTP/1.1 100 Continue\r\n\r\n");
+        bufAddNull(&wp->output);
+        websFlush(wp);
+    }
+    return 1;
+}
+
+
+/*
+    Route and authorize a request before its body is read. Returns false if the request was rejected.
+ */
+static bool checkRoute(Webs *wp)
+{
+    int     keepAlive;
+
+    /*
+        If the route rejects the request, the body will not be read and the connection can't be reused. Keep-alive
+        must be cleared before the error response headers are written.
+     */
+    keepAlive = wp->flags & WEBS_KEEP_ALIVE;
+    wp->flags &= ~WEBS_KEEP_ALIVE;
+    if (!websCheckRoute(wp)) {
+        if (wp->state < WEBS_COMPLETE) {
+            /* Wait for the error response to drain */
+            wp->state = WEBS_RUNNING;
+        }
+        return 0;
+    }
+    wp->flags |= keepAlive;
+    return 1;
+}
+
+
 /*
     Parse the first line of a HTTP request
  */
@@ -962,6 +1211,9 @@ static void parseFirstLine(Webs *wp)
         wp->ext = sclone(slower(ext));
     }
     wp->filename = sfmt("%s%s", websGetDocuments(), wp->path);
+#if BIT_GOAHEAD_OPENAT
+    wp->docdir = websGetDirFd(websGetDocuments());
+#endif
     wp->query = sclone(query);
     wp->host = sclone(host);
     wp->protocol = wp->flags & WEBS_SECURE ? "https" : "http";
@@ -988,10 +1240,13 @@ static void parseFirstLine(Webs *wp)
  */
 static void parseHeaders(Webs *wp)
 {
-    char    *upperKey, *cp, *key, *value, *tok;
-    int     count;
+    WebsAuthState   *auth;
+    char            *upperKey, *cp, *key, *value, *tok, *old;
+    Offset          limit;
+    int             count, json;
 
     assert(websValid(wp));
+    json = 0;
 
     /* 
         Parse the header and create the Http header keyword variables
@@ -1040,7 +1295,10 @@ static void parseHeaders(Webs *wp)
         } else if (scaselesscmp(key, "authorization") == 0) {
             wp->authType = sclone(value);
             stok(wp->authType, " \t", &tok);
-            wp->authDetails = sclone(tok);
+            if ((auth = websGetAuthState(wp)) != 0) {
+                wfree(auth->authDetails);
+                auth->authDetails = sclone(tok);
+            }
             slower(wp->authType);
 
         } else if (strcmp(key, "connection") == 0) {
@@ -1052,17 +1310,10 @@ static void parseHeaders(Webs *wp)
             }
 
         } else if (strcmp(key, "content-length") == 0) {
-            wp->rxLen = atoi(value);
-            if (smatch(wp->method, "PUT")) {
-                if (wp->rxLen > BIT_GOAHEAD_LIMIT_PUT) {
-                    websError(wp, HTTP_CODE_REQUEST_TOO_LARGE | WEBS_CLOSE, "Too big");
-                    return;
-                }
-            } else {
-                if (wp->rxLen > BIT_GOAHEAD_LIMIT_POST) {
-                    websError(wp, HTTP_CODE_REQUEST_TOO_LARGE | WEBS_CLOSE, "Too big");
-                    return;
-                }
+            wp->rxLen = stoi(value);
+            if (wp->rxLen < 0 || !isdigit((uchar) *value)) {
+                websError(wp, HTTP_CODE_BAD_REQUEST | WEBS_CLOSE, "Bad content length");
+                return;
             }
             if (wp->rxLen > 0 && !smatch(wp->method, "HEAD")) {
                 wp->rxRemaining = wp->rxLen;
@@ -1074,11 +1325,29 @@ static void parseHeaders(Webs *wp)
                 wp->flags |= WEBS_FORM;
             } else if (strstr(value, "multipart/form-data")) {
                 wp->flags |= WEBS_UPLOAD;
+#if BIT_GOAHEAD_JSON
+            } else if (strstr(value, "application/json")) {
+                json = 1;
+#endif
             }
 
         } else if (strcmp(key, "cookie") == 0) {
             wp->flags |= WEBS_COOKIE;
-            wp->cookie = sclone(value);
+            if (wp->cookie) {
+                /* Join multiple cookie headers */
+                old = wp->cookie;
+                wp->cookie = sfmt("%s; %s", old, value);
+                wfree(old);
+            } else {
+                wp->cookie = sclone(value);
+            }
+
+        } else if (strcmp(key, "expect") == 0) {
+            if (scaselesscmp(value, "100-continue") != 0) {
+                websError(wp, HTTP_CODE_EXPECTATION_FAILED | WEBS_CLOSE, "Unsupported expectation");
+                return;
+            }
+            wp->flags |= WEBS_EXPECT_CONTINUE;
 
         } else if (strcmp(key, "host") == 0) {
             wfree(wp->host);
@@ -1104,10 +1373,32 @@ static void parseHeaders(Webs *wp)
         } else if (strcmp(key, "transfer-encoding") == 0) {
             if (scaselesscmp(value, "chunked") == 0) {
                 wp->rxChunkState = WEBS_CHUNK_START;
-                wp->rxRemaining = MAXINT;
+                wp->rxRemaining = MAXINT64;
             }
         }
     }
+#if BIT_GOAHEAD_JSON
+    if (json && websOpenJsonBody(wp) < 0) {
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR | WEBS_CLOSE, "Can't allocate JSON parser");
+        return;
+    }
+#endif
+    /*
+        The body limit depends on the content type which may follow the content length
+     */
+    if (smatch(wp->method, "PUT")) {
+        limit = BIT_GOAHEAD_LIMIT_PUT;
+#if BIT_GOAHEAD_JSON
+    } else if (wp->flags & WEBS_JSON) {
+        limit = BIT_GOAHEAD_LIMIT_JSON;
+#endif
+    } else {
+        limit = BIT_GOAHEAD_LIMIT_POST;
+    }
+    if (wp->rxLen > limit) {
+        websError(wp, HTTP_CODE_REQUEST_TOO_LARGE | WEBS_CLOSE, "Too big");
+        return;
+    }
     if (!wp->rxChunkState) {
         /*
             Step over "\r\n" after headers.
@@ -1126,7 +1417,7 @@ static bool processContent(Webs *wp)
         return 0;
     }
 #if BIT_GOAHEAD_CGI && !BIT_ROM
-    if (wp->cgifd >= 0 && websProcessCgiData(wp) < 0) {
+    if (wp->cgi && wp->cgi->cgifd >= 0 && websProcessCgiData(wp) < 0) {
         return 0;
     }
 #endif
@@ -1135,10 +1426,21 @@ static bool processContent(Webs *wp)
         return 0;
     }
 #endif
+#if BIT_GOAHEAD_JSON
+    if ((wp->flags & WEBS_JSON) && websProcessJsonData(wp) < 0) {
+        return 0;
+    }
+#endif
 #if !BIT_ROM
     if (wp->putfd >= 0 && websProcessPutData(wp) < 0) {
         return 0;
     }
+#endif
+#if BIT_GOAHEAD_PROXY
+    if (wp->proxy && websProcessProxyData(wp) < 0) {
+        /* The proxy has responded to the client */
+        return 1;
+    }
 #endif
     if (wp->eof) {
         wp->state = WEBS_READY;
@@ -1165,6 +1467,8 @@ PUBLIC void websConsumeInput(Webs *wp, ssize nbytes)
     if (nbytes <= 0) {
         return;
     }
+    /* Form variables are decoded from the input buffer, so decode before the data is consumed */
+    websParseVars(wp);
     bufAdjustStart(&wp->input, nbytes);
     if (bufLen(&wp->input) == 0) {
         bufReset(&wp->input);
@@ -1172,6 +1476,30 @@ PUBLIC void websConsumeInput(Webs *wp, ssize nbytes)
 }
 
 
+PUBLIC void websPauseInput(Webs *wp, bool pause)
+{
+    WebsSocket  *sp;
+
+    assert(wp);
+
+    if ((sp = socketPtr(wp->sid)) == 0) {
+        return;
+    }
+    if (pause) {
+        wp->flags |= WEBS_INPUT_PAUSED;
+        socketRegisterInterest(wp->sid, sp->handlerMask & ~SOCKET_READABLE);
+
+    } else if (wp->flags & WEBS_INPUT_PAUSED) {
+        wp->flags &= ~WEBS_INPUT_PAUSED;
+        if (wp->state < WEBS_READY) {
+            /* Service on the next event loop iteration rather than pumping the request re-entrantly */
+            socketCreateHandler(wp->sid, sp->handlerMask | SOCKET_READABLE, socketEvent, wp);
+            socketReservice(wp->sid);
+        }
+    }
+}
+
+
 static bool filterChunkData(Webs *wp)
 {
     WebsBuf     *rxbuf;
@@ -1287,6 +1615,9 @@ PUBLIC void websServiceEvents(int *finished)
     delay = 0;
     while (!finished || !*finished) {
         if (socketSelect(-1, delay)) {
+#if BIT_GOAHEAD_STATS
+            websStatsLoopStart();
+#endif
             socketProcess();
         }
 #if BIT_GOAHEAD_CGI && !BIT_ROM
@@ -1296,6 +1627,9 @@ PUBLIC void websServiceEvents(int *finished)
 #endif
         nextEvent = websRunEvents();
         delay = min(delay, nextEvent);
+#if BIT_GOAHEAD_STATS
+        websStatsLoopEnd();
+#endif
     }
 }
 
@@ -1343,8 +1677,9 @@ PUBLIC void websSetEnv(Webs *wp)
     assert(wp);
     assert(websValid(wp));
 
+    websParseVars(wp);
     websSetVar(wp, "AUTH_TYPE", wp->authType);
-    websSetVarFmt(wp, "CONTENT_LENGTH", "%d", wp->rxLen);
+    websSetVarFmt(wp, "CONTENT_LENGTH", "%Ld", wp->rxLen);
     websSetVar(wp, "CONTENT_TYPE", wp->contentType);
     if (wp->route && wp->route->dir) {
         websSetVar(wp, "DOCUMENT_ROOT", wp->route->dir);
@@ -1383,6 +1718,25 @@ PUBLIC void websSetFormVars(Webs *wp)
 }
 
 
+/*
+    Decode the query and form variables deferred by websRouteRequest. Requests for static documents and handlers that
+    never use request variables do not pay to split and decode long query strings.
+ */
+PUBLIC void websParseVars(Webs *wp)
+{
+    if (!(wp->flags & WEBS_VARS_PENDING)) {
+        return;
+    }
+    wp->flags &= ~WEBS_VARS_PENDING;
+    if (wp->query && *wp->query) {
+        websSetQueryVars(wp);
+    }
+    if (wp->flags & WEBS_FORM) {
+        websSetFormVars(wp);
+    }
+}
+
+
 PUBLIC void websSetQueryVars(Webs *wp)
 {
     /*
@@ -1408,6 +1762,7 @@ PUBLIC void websSetVarFmt(Webs *wp, char *var, char *fmt, ...)
     assert(websValid(wp));
     assert(var && *var);
 
+    websParseVars(wp);
     if (fmt) {
         va_start(args, fmt);
         v = valueString(sfmtv(fmt, args), 0);
@@ -1427,6 +1782,7 @@ PUBLIC void websSetVar(Webs *wp, char *var, char *value)
     assert(websValid(wp));
     assert(var && *var);
 
+    websParseVars(wp);
     if (value) {
         v = valueString(value, VALUE_ALLOCATE);
     } else {
@@ -1449,6 +1805,7 @@ PUBLIC bool websTestVar(Webs *wp, char *var)
     if (var == NULL || *var == '\0') {
         return 0;
     }
+    websParseVars(wp);
     if ((sp = hashLookup(wp->vars, var)) == NULL) {
         return 0;
     }
@@ -1467,6 +1824,7 @@ PUBLIC char *websGetVar(Webs *wp, char *var, char *defaultGetValue)
     assert(websValid(wp));
     assert(var && *var);
  
+    websParseVars(wp);
     if ((sp = hashLookup(wp->vars, var)) != NULL) {
         assert(sp->content.type == string);
         if (sp->content.value.string) {
@@ -1701,6 +2059,170 @@ PUBLIC char *websEscapeHtml(char *html)
 }
 
 
+/*
+    Write str to the response with special characters escaped. The span routine returns the length of the leading run of
+    characters that do not need escaping. Runs are copied straight into the output buffer.
+ */
+static ssize writeEscaped(Webs *wp, char *str, ssize len, ssize (*span)(char*, ssize), char *(*escape)(int, char*))
+{
+    char    ebuf[8], *entity;
+    ssize   count, written;
+
+    assert(websValid(wp));
+
+    if (!str) {
+        return 0;
+    }
+    if (len < 0) {
+        len = slen(str);
+    }
+    written = 0;
+    while (len > 0) {
+        if ((count = span(str, len)) > 0) {
+            if (websWriteBlock(wp, str, count) != count) {
+                return -1;
+            }
+            written += count;
+            str += count;
+            len -= count;
+        }
+        if (len > 0) {
+            entity = escape((uchar) *str, ebuf);
+            count = slen(entity);
+            if (websWriteBlock(wp, entity, count) != count) {
+                return -1;
+            }
+            written += count;
+            str++;
+            len--;
+        }
+    }
+    return written;
+}
+
+
+/*
+    Return the length of the leading run of str that needs no HTML escaping. Tests eight bytes at a time.
+ */
+static ssize htmlSpan(char *str, ssize len)
+{
+    uint64  w;
+    ssize   i;
+
+    for (i = 0; i + (ssize) sizeof(w) <= len; i += sizeof(w)) {
+        memcpy(&w, &str[i], sizeof(w));
+        if (WORD_HAS_BYTE(w, '<') | WORD_HAS_BYTE(w, '>') | WORD_HAS_BYTE(w, '&') | WORD_HAS_BYTE(w, '"') |
+                WORD_HAS_BYTE(w, '\'')) {
+            break;
+        }
+    }
+    for (; i < len && !(charMatch[(uchar) str[i]] & WEBS_ENCODE_HTML); i++) ;
+    return i;
+}
+
+
+static char *htmlEscape(int c, char *buf)
+{
+    switch (c) {
+    case '&':
+        return "&amp;";
+    case '<':
+        return "&lt;";
+    case '>':
+        return "&gt;";
+    case '"':
+        return "&quot;";
+    default:
+        fmt(buf, 8, "&#%d;", c);
+        return buf;
+    }
+}
+
+
+/*
+    JSON strings must escape quotes, backslash and control characters. Escape "<" as well so the output may be
+    embedded in a script element.
+ */
+static ssize jsonSpan(char *str, ssize len)
+{
+    uint64  w;
+    ssize   i;
+    int     c;
+
+    for (i = 0; i + (ssize) sizeof(w) <= len; i += sizeof(w)) {
+        memcpy(&w, &str[i], sizeof(w));
+        if (WORD_HAS_LESS(w, 0x20) | WORD_HAS_BYTE(w, '"') | WORD_HAS_BYTE(w, '\\') | WORD_HAS_BYTE(w, '<')) {
+            break;
+        }
+    }
+    for (; i < len; i++) {
+        c = (uchar) str[i];
+        if (c < 0x20 || c == '"' || c == '\\' || c == '<') {
+            break;
+        }
+    }
+    return i;
+}
+
+
+static char *jsonEscape(int c, char *buf)
+{
+    switch (c) {
+    case '"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\b':
+        return "\\b";
+    case '\f':
+        return "\\f";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        fmt(buf, 8, "\\u%04x", c);
+        return buf;
+    }
+}
+
+
+static ssize uriSpan(char *str, ssize len)
+{
+    ssize   i;
+
+    for (i = 0; i < len && !(charMatch[(uchar) str[i]] & WEBS_ENCODE_URI); i++) ;
+    return i;
+}
+
+
+static char *uriEscape(int c, char *buf)
+{
+    fmt(buf, 8, "%%%02X", c);
+    return buf;
+}
+
+
+PUBLIC ssize websWriteEscapedHtml(Webs *wp, char *str, ssize len)
+{
+    return writeEscaped(wp, str, len, htmlSpan, htmlEscape);
+}
+
+
+PUBLIC ssize websWriteEscapedJson(Webs *wp, char *str, ssize len)
+{
+    return writeEscaped(wp, str, len, jsonSpan, jsonEscape);
+}
+
+
+PUBLIC ssize websWriteEscapedUri(Webs *wp, char *str, ssize len)
+{
+    return writeEscaped(wp, str, len, uriSpan, uriEscape);
+}
+
+
 /*  
     Output an error message and cleanup
  */
@@ -1735,23 +2257,34 @@ PUBLIC void websError(Webs *wp, int code, char *fmt, ...)
         if (!(code & WEBS_NOLOG)) {
             trace(2, "%s", msg);
         }
-        encoded = websEscapeHtml(msg);
+        buf = websErrorPage(code, msg);
         wfree(msg);
-        msg = encoded;
-        buf = sfmt("\
+    } else {
+        buf = 0;
+    }
+    websResponse(wp, code, buf);
+    wfree(buf);
+}
+
+
+/*
+    Format the HTML body of an error response. The message is HTML escaped.
+ */
+PUBLIC char *websErrorPage(int code, char *msg)
+{
+    char    *encoded, *buf;
+
+    encoded = websEscapeHtml(msg);
+    buf = sfmt("\
 <html>\r\n\
     <head><title>Document Error: %s</title></head>\r\n\
     <body>\r\n\
         <h2>Access Error: %s</h2>\r\n\
         <p>%s</p>\r\n\
     </body>\r\n\
-</html>\r\n", websErrorMsg(code), websErrorMsg(code), msg);
-        wfree(msg);
-    } else {
-        buf = 0;
-    }
-    websResponse(wp, code, buf);
-    wfree(buf);
+</html>\r\n", websErrorMsg(code), websErrorMsg(code), encoded);
+    wfree(encoded);
+    return buf;
 }
 
 
@@ -1827,7 +2360,7 @@ PUBLIC void websSetStatus(Webs *wp, int code)
     Write a set of headers. Does not write the trailing blank line so callers can add more headers.
     Set length to -1 if unknown and transfer-chunk-encoding will be employed.
  */
-PUBLIC void websWriteHeaders(Webs *wp, ssize length, char *location)
+PUBLIC void websWriteHeaders(Webs *wp, Offset length, char *location)
 {
     WebsKey     *key;
     char        *date;
@@ -1849,20 +2382,24 @@ PUBLIC void websWriteHeaders(Webs *wp, ssize length, char *location)
             websWriteHeader(wp, "Date", "%s", date);
             wfree(date);
         }
-        if (wp->authResponse) {
-            websWriteHeader(wp, "WWW-Authenticate", "%s", wp->authResponse);
+        if (wp->auth && wp->auth->authResponse) {
+            websWriteHeader(wp, "WWW-Authenticate", "%s", wp->auth->authResponse);
         }
         if (smatch(wp->method, "HEAD")) {
-            websWriteHeader(wp, "Content-Length", "%d", (int) length);                                           
+            websWriteHeader(wp, "Content-Length", "%Ld", length);
         } else if (length >= 0) {                                                                                    
             if (!((100 <= wp->code && wp->code <= 199) || wp->code == 204 || wp->code == 304)) {
-                websWriteHeader(wp, "Content-Length", "%d", (int) length);                                           
+                websWriteHeader(wp, "Content-Length", "%Ld", length);
             }
         }
         wp->txLen = length;
         if (wp->txLen < 0) {
             websWriteHeader(wp, "Transfer-Encoding", "chunked");
         }
+        if (wp->requests + 1 >= BIT_GOAHEAD_LIMIT_KEEP_ALIVE) {
+            /* Last request permitted on this connection */
+            wp->flags &= ~WEBS_KEEP_ALIVE;
+        }
         if (wp->flags & WEBS_KEEP_ALIVE) {
             websWriteHeader(wp, "Connection", "keep-alive");
         } else {
@@ -1870,6 +2407,10 @@ PUBLIC void websWriteHeaders(Webs *wp, ssize length, char *location)
         }
         if (location) {
             websWriteHeader(wp, "Location", "%s", location);
+#if BIT_ROM
+        } else if (wp->rom && wp->rom->mimeType) {
+            websWriteHeader(wp, "Content-Type", "%s", wp->rom->mimeType);
+#endif
         } else if ((key = hashLookup(websMime, wp->ext)) != 0) {
             websWriteHeader(wp, "Content-Type", "%s", key->content.value.string);
         }
@@ -1911,7 +2452,7 @@ PUBLIC void websWriteEndHeaders(Webs *wp)
 }
 
 
-PUBLIC void websSetTxLength(Webs *wp, ssize length)
+PUBLIC void websSetTxLength(Webs *wp, Offset length)
 {
     assert(wp);
     wp->txLen = length;
@@ -1973,6 +2514,15 @@ PUBLIC ssize websWriteSocket(Webs *wp, char *buf, ssize size)
         return -1;
     }
     wp->written += written;
+#if BIT_GOAHEAD_STATS
+    websStats.bytesWritten += written;
+#endif
+#if BIT_GOAHEAD_CACHE
+    /* Capture body data written directly by handlers. Buffered output is captured by websWriteBlock. */
+    if (wp->cache && (buf < wp->output.buf || buf >= wp->output.endbuf)) {
+        websCacheWrite(wp, buf, written);
+    }
+#endif
     websNoteRequestActivity(wp);
     return written;
 }
@@ -2135,7 +2685,7 @@ PUBLIC char *websGetHost(Webs *wp) { return wp->host; }
 PUBLIC char *websGetIfaddr(Webs *wp) { return wp->ifaddr; }
 PUBLIC char *websGetIpaddr(Webs *wp) { return wp->ipaddr; }
 PUBLIC char *websGetMethod(Webs *wp) { return wp->method; }
-PUBLIC char *websGetPassword(Webs *wp) { return wp->password; }
+PUBLIC char *websGetPassword(Webs *wp) { return wp->auth ? wp->auth->password : 0; }
 PUBLIC char *websGetPath(Webs *wp) { return wp->path; }
 PUBLIC int   websGetPort(Webs *wp) { return wp->port; }
 PUBLIC char *websGetProtocol(Webs *wp) { return wp->protocol; }
@@ -2148,6 +2698,41 @@ PUBLIC char *websGetUrl(Webs *wp) { return wp->url; }
 PUBLIC char *websGetUserAgent(Webs *wp) { return wp->userAgent; }
 PUBLIC char *websGetUsername(Webs *wp) { return wp->username; }
 
+
+/*
+    Authentication state is only needed by requests that supply credentials or are challenged, so it is allocated
+    on demand to keep the request structure small.
+ */
+PUBLIC WebsAuthState *websGetAuthState(Webs *wp)
+{
+    if (wp->auth == 0) {
+        if ((wp->auth = walloc(sizeof(WebsAuthState))) == 0) {
+            return 0;
+        }
+        memset(wp->auth, 0, sizeof(WebsAuthState));
+    }
+    return wp->auth;
+}
+
+
+static void freeAuthState(WebsAuthState *auth)
+{
+    wfree(auth->authDetails);
+    wfree(auth->authResponse);
+    wfree(auth->digest);
+    wfree(auth->password);
+    wfree(auth->realm);
+#if BIT_DIGEST
+    wfree(auth->cnonce);
+    wfree(auth->digestUri);
+    wfree(auth->opaque);
+    wfree(auth->nc);
+    wfree(auth->nonce);
+    wfree(auth->qop);
+#endif
+    wfree(auth);
+}
+
 /*
     Buffer data. Will flush as required. May return -1 on write errors.
  */
@@ -2178,6 +2763,11 @@ PUBLIC ssize websWriteBlock(Webs *wp, char *buf, ssize size)
         }
         thisWrite = min(room, size);
         bufPutBlk(op, buf, thisWrite);
+#if BIT_GOAHEAD_CACHE
+        if (wp->cache) {
+            websCacheWrite(wp, buf, thisWrite);
+        }
+#endif
         size -= thisWrite;
         buf += thisWrite;
         written += thisWrite;
@@ -2322,6 +2912,68 @@ static void checkTimeout(void *arg, int id)
 }
 
 
+/*
+    Append a connection waiting for its next request to the idle list. The list is ordered from least to most recently
+    used. If the list is full, the least recently used connections are closed.
+ */
+static void idleAdd(Webs *wp)
+{
+    assert(!(wp->flags & WEBS_IDLE));
+
+    if (idleCount >= BIT_GOAHEAD_LIMIT_IDLE) {
+        reapIdle(idleCount - BIT_GOAHEAD_LIMIT_IDLE + 1);
+    }
+    wp->idlePrev = idleTail;
+    wp->idleNext = 0;
+    if (idleTail) {
+        idleTail->idleNext = wp;
+    } else {
+        idleHead = wp;
+    }
+    idleTail = wp;
+    wp->flags |= WEBS_IDLE;
+    idleCount++;
+}
+
+
+static void idleRemove(Webs *wp)
+{
+    assert(wp->flags & WEBS_IDLE);
+
+    if (wp->idlePrev) {
+        wp->idlePrev->idleNext = wp->idleNext;
+    } else {
+        idleHead = wp->idleNext;
+    }
+    if (wp->idleNext) {
+        wp->idleNext->idlePrev = wp->idlePrev;
+    } else {
+        idleTail = wp->idlePrev;
+    }
+    wp->idlePrev = wp->idleNext = 0;
+    wp->flags &= ~WEBS_IDLE;
+    idleCount--;
+}
+
+
+/*
+    Close up to count of the least recently used idle connections. Returns the number closed.
+ */
+static int reapIdle(int count)
+{
+    Webs    *wp;
+    int     closed;
+
+    for (closed = 0; closed < count && (wp = idleHead) != 0; closed++) {
+        trace(5, "Close idle connection from %s", wp->ipaddr);
+        idleRemove(wp);
+        complete(wp, 0);
+        websFree(wp);
+    }
+    return closed;
+}
+
+
 static int setLocalHost()
 {
     struct in_addr  intaddr;
@@ -2404,6 +3056,9 @@ PUBLIC void websSetRequestFilename(Webs *wp, char *filename)
         wfree(wp->filename);
     }
     wp->filename = sclone(filename);
+#if BIT_GOAHEAD_OPENAT
+    wp->docdir = -1;
+#endif
     websSetVar(wp, "PATH_TRANSLATED", wp->filename);
 }
 #endif
@@ -2411,17 +3066,24 @@ PUBLIC void websSetRequestFilename(Webs *wp, char *filename)
 
 PUBLIC int websRewriteRequest(Webs *wp, char *url)
 {
-    char    *buf, *path;
+    char    *buf, *path, *ext;
 
     wfree(wp->url);
     wp->url = sclone(url);
     wfree(wp->path);
-    if (websUrlParse(url, &buf, NULL, NULL, &path, NULL, NULL, NULL, NULL) < 0) {
+    path = ext = 0;
+    if (websUrlParse(url, &buf, NULL, NULL, NULL, &path, &ext, NULL, NULL) < 0) {
+        wp->path = 0;
         return -1;
     }
     wp->path = sclone(path);
+    wfree(wp->ext);
+    wp->ext = ext ? sclone(slower(ext)) : 0;
     wfree(wp->filename);
     wp->filename = 0;
+#if BIT_GOAHEAD_OPENAT
+    wp->docdir = -1;
+#endif
     wp->flags |= WEBS_REROUTE;
     wfree(buf);
     return 0;
@@ -3238,6 +3900,11 @@ PUBLIC char *websNormalizeUriPath(char *pathArg)
 PUBLIC int websPageOpen(Webs *wp, int mode, int perm)
 {
     assert(websValid(wp));
+#if BIT_GOAHEAD_OPENAT
+    if (wp->docdir >= 0) {
+        return (wp->docfd = websOpenFileAt(wp->docdir, wp->path, mode, perm));
+    }
+#endif
     return (wp->docfd = websOpenFile(wp->filename, mode, perm));
 }
 
@@ -3255,6 +3922,11 @@ PUBLIC void websPageClose(Webs *wp)
 
 PUBLIC int websPageStat(Webs *wp, WebsFileInfo *sbuf)
 {
+#if BIT_GOAHEAD_OPENAT
+    if (wp->docdir >= 0) {
+        return websStatFileAt(wp->docdir, wp->path, sbuf);
+    }
+#endif
     return websStatFile(wp->filename, sbuf);
 }
 
@@ -3263,7 +3935,7 @@ PUBLIC int websPageIsDirectory(Webs *wp)
 {
     WebsFileInfo    sbuf;
 
-    if (websStatFile(wp->filename, &sbuf) >= 0) {
+    if (websPageStat(wp, &sbuf) >= 0) {
         return(sbuf.isDir);
     }
     return 0;
@@ -3358,6 +4030,104 @@ PUBLIC void websSetCookie(Webs *wp, char *name, char *value, char *path, char *c
 }
 
 
+/*
+    Parse the request Cookie header into a table of name/value pairs. The table and a copy of the header are allocated
+    as one block and the names and values reference the copy. Values may be quoted and separated by ";" or ",".
+ */
+static void parseCookies(Webs *wp)
+{
+    WebsCookie  *cookies;
+    char        *cp, *name, *value, *end;
+    ssize       len;
+    int         count, max, quoted, sep;
+
+    if (wp->cookies || !wp->cookie) {
+        return;
+    }
+    for (max = 1, cp = wp->cookie; *cp; cp++) {
+        if (*cp == ';' || *cp == ',') {
+            max++;
+        }
+    }
+    len = slen(wp->cookie) + 1;
+    if ((cookies = walloc(max * sizeof(WebsCookie) + len)) == 0) {
+        return;
+    }
+    cp = (char*) &cookies[max];
+    memcpy(cp, wp->cookie, len);
+
+    for (count = 0; *cp; ) {
+        while (isspace((uchar) *cp) || *cp == ';' || *cp == ',') {
+            cp++;
+        }
+        if (*cp == '\0') {
+            break;
+        }
+        name = cp;
+        while (*cp && *cp != '=' && *cp != ';' && *cp != ',') {
+            cp++;
+        }
+        for (end = cp; end > name && isspace((uchar) end[-1]); end--) { }
+        value = "";
+        if (*cp == '=') {
+            *end = '\0';
+            for (cp++; isspace((uchar) *cp); cp++) { }
+            quoted = (*cp == '"');
+            value = cp + quoted;
+            for (cp = value; *cp; cp++) {
+                if (quoted ? (*cp == '"' && cp[-1] != '\\') : ((*cp == ';' || *cp == ',') && cp[-1] != '\\')) {
+                    break;
+                }
+            }
+            if (quoted) {
+                if (*cp) {
+                    *cp++ = '\0';
+                }
+                while (*cp && *cp != ';' && *cp != ',') {
+                    cp++;
+                }
+            } else {
+                for (end = cp; end > value && isspace((uchar) end[-1]); end--) { }
+                sep = *cp;
+                *end = '\0';
+                cp += (sep != 0);
+            }
+        } else {
+            sep = *cp;
+            *end = '\0';
+            cp += (sep != 0);
+        }
+        if (*name) {
+            cookies[count].name = name;
+            cookies[count].value = value;
+            if (!wp->sessionCookie && strcmp(name, WEBS_SESSION) == 0) {
+                wp->sessionCookie = value;
+            }
+            count++;
+        }
+    }
+    wp->cookies = cookies;
+    wp->cookieCount = count;
+}
+
+
+PUBLIC char *websGetCookieValue(Webs *wp, char *name)
+{
+    int     i;
+
+    assert(wp);
+    assert(name && *name);
+
+    parseCookies(wp);
+    for (i = 0; i < wp->cookieCount; i++) {
+        if (strcmp(wp->cookies[i].name, name) == 0) {
+            return wp->cookies[i].value;
+        }
+    }
+    return 0;
+}
+
+
 static char *getToken(Webs *wp, char *delim)
 {
     WebsBuf     *buf;
@@ -3470,21 +4240,20 @@ WebsSession *websGetSession(Webs *wp, int create)
         id = websGetSessionID(wp);
         if ((sym = hashLookup(sessions, id)) == 0) {
             if (!create) {
-                wfree(id);
                 return 0;
             }
             if (sessionCount > BIT_GOAHEAD_LIMIT_SESSION_COUNT) {
                 error("Too many sessions %d/%d", sessionCount, BIT_GOAHEAD_LIMIT_SESSION_COUNT);
-                wfree(id);
                 return 0;
             }
             sessionCount++;
+#if BIT_GOAHEAD_STATS
+            websStats.sessions = sessionCount;
+#endif
             if ((wp->session = websAllocSession(wp, id, BIT_GOAHEAD_LIMIT_SESSION_LIFE)) == 0) {
-                wfree(id);
                 return 0;
             }
             if ((sym = hashEnter(sessions, wp->session->id, valueSymbol(wp->session), 0)) == 0) {
-                wfree(id);
                 return 0;
             }
             wp->session = (WebsSession*) sym->content.value.symbol;
@@ -3492,7 +4261,6 @@ WebsSession *websGetSession(Webs *wp, int create)
         } else {
             wp->session = (WebsSession*) sym->content.value.symbol;
         }
-        wfree(id);
     }
     if (wp->session) {
         wp->session->expires = time(0) + wp->session->lifespan;
@@ -3503,46 +4271,13 @@ WebsSession *websGetSession(Webs *wp, int create)
 
 PUBLIC char *websGetSessionID(Webs *wp)
 {
-    char    *cookies, *cookie, *cp, *value;
-    ssize   len;
-    int     quoted;
-
     assert(wp);
 
     if (wp->session) {
         return wp->session->id;
     }
-    cookies = wp->cookie;
-    for (cookie = cookies; cookie && (value = strstr(cookie, WEBS_SESSION)) != 0; cookie = value) {
-        value += strlen(WEBS_SESSION);
-        while (isspace((uchar) *value) || *value == '=') {
-            value++;
-        }
-        quoted = 0;
-        if (*value == '"') {
-            value++;
-            quoted++;
-        }
-        for (cp = value; *cp; cp++) {
-            if (quoted) {
-                if (*cp == '"' && cp[-1] != '\\') {
-                    break;
-                }
-            } else {
-                if ((*cp == ',' || *cp == ';') && cp[-1] != '\\') {
-                    break;
-                }
-            }
-        }
-        len = cp - value;
-        if ((cp = walloc(len + 1)) == 0) {
-            return 0;
-        }
-        strncpy(cp, value, len);
-        cp[len] = '\0';
-        return cp;
-    }
-    return 0;
+    parseCookies(wp);
+    return wp->sessionCookie;
 }
 
 
@@ -3610,6 +4345,9 @@ static void pruneCache()
         if (sp->expires <= when) {
             hashDelete(sessions, sp->id);
             sessionCount--;
+#if BIT_GOAHEAD_STATS
+            websStats.sessions = sessionCount;
+#endif
             freeSession(sp);
         }
     }
@@ -3677,6 +4415,10 @@ static void setFileLimits()
     }
     getrlimit(RLIMIT_NOFILE, &r);
     trace(6, "Max files soft %d, max %d", r.rlim_cur, r.rlim_max);
+    if (r.rlim_cur < MAXINT) {
+        limit = (int) r.rlim_cur;
+        fileHigh = limit - max(limit / 16, 16);
+    }
 #endif
 }
 
@@ -22,7 +22,9 @@ static int  jsMax = -1;     /* Maximum size of  */
 static Js       *jsPtr(int jid);
 static void     clearString(char **ptr);
 static void     setString(char **ptr, char *s);
-static void     appendString(char **ptr, char *s);
+static int      appendVar(Js *ep, char *var, char *value);
+static bool     isNumeric(char *s);
+static void     releaseAppend(Js *ep);
 static int      parse(Js *ep, int state, int flags);
 static int      parseStmt(Js *ep, int state, int flags);
 static int      parseDeclaration(Js *ep, int state, int flags);
@@ -102,6 +104,7 @@ PUBLIC void jsCloseEngine(int jid)
     ep->result = NULL;
 
     jsLexClose(ep);
+    releaseAppend(ep);
 
     for (i = ep->variableMax - 1; i >= 0; i--) {
         if (ep->flags & FLAGS_VARIABLES) {
@@ -193,6 +196,7 @@ PUBLIC int jsCloseBlock(int jid, int vid)
     if((ep = jsPtr(jid)) == NULL) {
         return -1;
     }
+    releaseAppend(ep);
     hashFree(ep->variables[vid] - JS_OFFSET);
     ep->variableMax = wfreeHandle(&ep->variables, vid);
     return 0;
@@ -377,7 +381,7 @@ static int parseStmt(Js *ep, int state, int flags)
     JsInput     condScript, endScript, bodyScript, incrScript;
     char      *value, *identifier;
     int         done, expectSemi, thenFlags, elseFlags, tid, cond, forFlags;
-    int         jsVarType;
+    int         jsVarType, append;
 
     assert(ep);
 
@@ -435,12 +439,23 @@ static int parseStmt(Js *ep, int state, int flags)
              */
             tid = jsLexGetToken(ep, state);
             if (tid == TOK_ASSIGNMENT) {
+                append = (*ep->token == EXPR_PLUS);
+                if (append && state == STATE_DEC) {
+                    jsError(ep, "Syntax error");
+                    clearString(&identifier);
+                    goto error;
+                }
                 if (parse(ep, STATE_RELEXP, flags) != STATE_RELEXP_DONE) {
                     clearString(&identifier);
                     goto error;
                 }
                 if (flags & FLAGS_EXE) {
-                    if ( state == STATE_DEC ) {
+                    if (append) {
+                        if (appendVar(ep, identifier, ep->result) < 0) {
+                            clearString(&identifier);
+                            goto error;
+                        }
+                    } else if ( state == STATE_DEC ) {
                         jsSetLocalVar(ep->jid, identifier, ep->result);
                     } else {
                         jsVarType = jsGetVar(ep->jid, identifier, &value);
@@ -1084,8 +1099,9 @@ static int evalCond(Js *ep, char *lhs, int rel, char *rhs)
  */
 static int evalExpr(Js *ep, char *lhs, int rel, char *rhs)
 {
-    char  *cp, buf[16];
-    int     numeric, l, r, lval;
+    char    *cp, buf[16];
+    ssize   llen, rlen;
+    int     l, r, lval;
 
     assert(lhs);
     assert(rhs);
@@ -1094,22 +1110,7 @@ static int evalExpr(Js *ep, char *lhs, int rel, char *rhs)
     /*
         All of the characters in the lhs and rhs must be numeric
      */
-    numeric = 1;
-    for (cp = lhs; *cp; cp++) {
-        if (!isdigit((uchar) *cp)) {
-            numeric = 0;
-            break;
-        }
-    }
-    if (numeric) {
-        for (cp = rhs; *cp; cp++) {
-            if (!isdigit((uchar) *cp)) {
-                numeric = 0;
-                break;
-            }
-        }
-    }
-    if (numeric) {
+    if (isNumeric(lhs) && isNumeric(rhs)) {
         l = atoi(lhs);
         r = atoi(rhs);
         switch (rel) {
@@ -1176,9 +1177,17 @@ static int evalExpr(Js *ep, char *lhs, int rel, char *rhs)
     } else {
         switch (rel) {
         case EXPR_PLUS:
+            /* Concatenate with one allocation */
+            llen = slen(lhs);
+            rlen = slen(rhs);
+            if ((cp = walloc(llen + rlen + 1)) == NULL) {
+                jsError(ep, "Memory allocation error");
+                return -1;
+            }
+            memcpy(cp, lhs, llen);
+            memcpy(&cp[llen], rhs, rlen + 1);
             clearString(&ep->result);
-            appendString(&ep->result, lhs);
-            appendString(&ep->result, rhs);
+            ep->result = cp;
             return 0;
         case EXPR_LESS:
             lval = strcmp(lhs, rhs) < 0;
@@ -1285,21 +1294,105 @@ static void setString(char **ptr, char *s)
 }
 
 
-static void appendString(char **ptr, char *s)
+static bool isNumeric(char *s)
 {
-    ssize   len, oldlen, size;
+    for (; *s; s++) {
+        if (!isdigit((uchar) *s)) {
+            return 0;
+        }
+    }
+    return 1;
+}
 
-    assert(ptr);
 
-    if (*ptr) {
-        len = strlen(s);
-        oldlen = strlen(*ptr);
-        size = (len + oldlen + 1) * sizeof(char);
-        *ptr = wrealloc(*ptr, size);
-        strcpy(&(*ptr)[oldlen], s);
+/*
+    Evaluate "var += value". String values are appended in place. The variable string is kept in a buffer owned by
+    the engine that grows by doubling, so building a string with repeated appends is linear rather than quadratic.
+    The buffer is given to the variable table by releaseAppend when another variable is appended or the variable
+    scope is closed.
+ */
+static int appendVar(Js *ep, char *var, char *value)
+{
+    JsBuilder   *bp;
+    WebsKey     *sp;
+    WebsHash    table;
+    char        *buf, *cur;
+    ssize       len, size;
+
+    assert(var && *var);
+    assert(value);
+
+    bp = &ep->append;
+    table = ep->variables[ep->variableMax - 1] - JS_OFFSET;
+    if ((sp = hashLookup(table, var)) == NULL) {
+        table = ep->variables[0] - JS_OFFSET;
+        if ((sp = hashLookup(table, var)) == NULL) {
+            jsError(ep, "Undefined variable %s\n", var);
+            return -1;
+        }
+    }
+    cur = sp->content.value.string ? sp->content.value.string : "";
+    if (isNumeric(cur) && isNumeric(value)) {
+        if (evalExpr(ep, cur, EXPR_PLUS, value) < 0) {
+            return -1;
+        }
+        if (cur == bp->buf) {
+            releaseAppend(ep);
+        }
+        hashEnter(table, var, valueString(ep->result, VALUE_ALLOCATE), 0);
+        return 0;
+    }
+    len = slen(value);
+    if (bp->buf == NULL || cur != bp->buf) {
+        /* Start a new builder with a copy of the current value */
+        releaseAppend(ep);
+        bp->len = slen(cur);
+        bp->size = max(bp->len + len + 1, 64);
+        if ((bp->buf = walloc(bp->size)) == NULL) {
+            jsError(ep, "Memory allocation error");
+            return -1;
+        }
+        memcpy(bp->buf, cur, bp->len + 1);
+        bp->var = sclone(var);
+        bp->table = table;
+        valueFree(&sp->content);
+        sp->content = valueString(bp->buf, 0);
+    }
+    if ((bp->len + len + 1) > bp->size) {
+        size = max(bp->size * 2, bp->len + len + 1);
+        if ((buf = wrealloc(bp->buf, size)) == NULL) {
+            jsError(ep, "Memory allocation error");
+            return -1;
+        }
+        bp->buf = sp->content.value.string = buf;
+        bp->size = size;
+    }
+    memcpy(&bp->buf[bp->len], value, len + 1);
+    bp->len += len;
+    return 0;
+}
+
+
+/*
+    Give the builder string to the variable that uses it. If the variable has since been assigned another value or
+    removed, the string is freed.
+ */
+static void releaseAppend(Js *ep)
+{
+    JsBuilder   *bp;
+    WebsKey     *sp;
+
+    bp = &ep->append;
+    if (bp->buf == NULL) {
+        return;
+    }
+    if ((sp = hashLookup(bp->table, bp->var)) != NULL && sp->content.value.string == bp->buf) {
+        sp->content.allocated = 1;
     } else {
-        *ptr = sclone(s);
+        wfree(bp->buf);
     }
+    wfree(bp->var);
+    memset(bp, 0, sizeof(JsBuilder));
 }
 
 
@@ -1826,6 +1919,11 @@ static int getLexicalToken(Js *ep, int state)
                 jsError(ep, "Syntax Error");
                 return TOK_ERR;
             }
+            if (c == '=') {
+                /* "+=" is an assignment with the EXPR_PLUS token */
+                tokenAddChar(ep, EXPR_PLUS);
+                return TOK_ASSIGNMENT;
+            }
             if (c != '+' ) {
                 inputPutback(ep, c);
                 tokenAddChar(ep, EXPR_PLUS);
@@ -127,6 +127,17 @@ typedef struct JsInput {
     int         lineColumn;                     /* Column in line */
 } JsInput;
 
+/*
+    Growable string value for a variable that is appended to with "+="
+ */
+typedef struct JsBuilder {
+    char        *buf;                           /* String storage. Owned by the builder, not the variable table */
+    char        *var;                           /* Name of the variable using buf as its value */
+    WebsHash    table;                          /* Variable table containing var */
+    ssize       len;                            /* Length of the string in buf */
+    ssize       size;                           /* Allocated size of buf */
+} JsBuilder;
+
 
 /**
     Javascript engine structure
@@ -145,6 +156,7 @@ typedef struct Js {
     int         jid;                            /* Halloc handle */
     int         flags;                          /* Flags */
     void        *userHandle;                    /* User defined handle */
+    JsBuilder   append;                         /* Variable being appended to */
 } Js;
 
 
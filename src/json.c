@@ -0,0 +1,1131 @@
+/*
+    json.c -- Streaming JSON response writer and incremental JSON parser
+
+    Actions emit JSON by calling the websJson routines with a WebsJson context that lives on the caller's stack.
+    Punctuation and numbers are staged in the context and passed to websWriteBlock in blocks, so no heap memory is
+    allocated. Strings are escaped by websWriteEscapedJson directly into the response. The staged output is written
+    when the top level value is complete. For example:
+
+        WebsJson    json;
+
+        websJsonOpen(&json, wp);
+        websJsonBeginObject(&json);
+        websJsonKey(&json, "name");
+        websJsonString(&json, name);
+        websJsonKey(&json, "count");
+        websJsonInt(&json, count);
+        websJsonEndObject(&json);
+
+    The parser issues an event for each token as input is supplied. Tokens reference the input buffer and a partial
+    token at the end of the input is left unconsumed for the next call. Request bodies with an "application/json"
+    content type are parsed as they are received by actions defined via websDefineJsonAction, which receive the
+    events, and by routes with the "json" option. For those routes, the body is parsed into a document of nodes
+    allocated in blocks owned by the request and freed with the request. Other request bodies are not parsed.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#include    "goahead.h"
+
+/*********************************** Defines **********************************/
+
+#define JSON_EXACT      9007199254740992.0  /* 2^53. Larger integers are not exact as doubles */
+#define JSON_FRACTION   6                   /* Maximum decimal places written without printf */
+
+#if BIT_GOAHEAD_JSON
+#define JSON_BLOCK      4096                /* Document allocation block size */
+
+/*
+    Parser states. Each is the token expected next.
+ */
+#define JSON_VALUE          0               /* Any value */
+#define JSON_VALUE_OR_END   1               /* Array element or end of array */
+#define JSON_KEY            2               /* Object member name */
+#define JSON_KEY_OR_END     3               /* Object member name or end of object */
+#define JSON_COLON          4               /* Colon after a member name */
+#define JSON_NEXT           5               /* Comma or end of the current object or array */
+#define JSON_DONE           6               /* Top level value complete */
+
+/*
+    JSON request body state
+ */
+typedef struct JsonState {
+    WebsJsonParser  parser;                 /* Parser for actions receiving events */
+    WebsJsonDoc     *doc;                   /* Parsed document for other requests */
+    Offset          received;               /* Body bytes parsed */
+} JsonState;
+
+static char jsonTooBig[] = "JSON document is too big";
+#endif
+
+/**************************** Forward Declarations ****************************/
+
+static int beginValue(WebsJson *jp);
+static int begin(WebsJson *jp, int object, char *open);
+static int end(WebsJson *jp, int object, char *close);
+static int endValue(WebsJson *jp);
+static int flush(WebsJson *jp);
+static char *formatNumber(char *end, uint64 n, int places, int negative);
+static void put(WebsJson *jp, char *buf, ssize len);
+static void putString(WebsJson *jp, char *str);
+#if BIT_GOAHEAD_JSON
+static int closeContainer(WebsJsonParser *parser, int c);
+static void *docAlloc(WebsJsonDoc *doc, ssize size);
+static int docEvent(void *data, int event, char *token, ssize len);
+static char *docString(WebsJsonDoc *doc, int event, char *token, ssize len);
+static int emit(WebsJsonParser *parser, int event, char *token, ssize len);
+static int hex4(char *cp, char *end);
+static int parseError(WebsJsonParser *parser, char *msg);
+static int parseLiteral(WebsJsonParser *parser, char **cpp, char *end, bool eof);
+static int parseNumber(WebsJsonParser *parser, char **cpp, char *end, bool eof);
+static int parseString(WebsJsonParser *parser, char **cpp, char *end, bool eof, int event);
+static char *utf8Encode(char *op, int c);
+static int utf8Length(int c);
+static bool validNumber(char *cp, char *end);
+#endif
+
+/************************************* Code ***********************************/
+
+PUBLIC void websJsonOpen(WebsJson *jp, Webs *wp)
+{
+    assert(jp);
+    assert(websValid(wp));
+
+    jp->wp = wp;
+    jp->comma = 0;
+    jp->objects = 0;
+    jp->depth = 0;
+    jp->key = 0;
+    jp->error = 0;
+    jp->len = 0;
+}
+
+
+PUBLIC int websJsonBeginObject(WebsJson *jp)
+{
+    return begin(jp, 1, "{");
+}
+
+
+PUBLIC int websJsonEndObject(WebsJson *jp)
+{
+    return end(jp, 1, "}");
+}
+
+
+PUBLIC int websJsonBeginArray(WebsJson *jp)
+{
+    return begin(jp, 0, "[");
+}
+
+
+PUBLIC int websJsonEndArray(WebsJson *jp)
+{
+    return end(jp, 0, "]");
+}
+
+
+/*
+    Write an object member name. The next call must write the member value.
+ */
+PUBLIC int websJsonKey(WebsJson *jp, char *key)
+{
+    uint    bit;
+
+    assert(jp);
+    assert(key);
+
+    bit = 1U << jp->depth;
+    if (jp->error || jp->key || jp->depth == 0 || !(jp->objects & bit)) {
+        jp->error = 1;
+        return -1;
+    }
+    if (jp->comma & bit) {
+        put(jp, ",", 1);
+    }
+    jp->comma |= bit;
+    putString(jp, key);
+    put(jp, ":", 1);
+    jp->key = 1;
+    return jp->error ? -1 : 0;
+}
+
+
+PUBLIC int websJsonString(WebsJson *jp, char *value)
+{
+    if (!value) {
+        return websJsonNull(jp);
+    }
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    putString(jp, value);
+    return endValue(jp);
+}
+
+
+PUBLIC int websJsonInt(WebsJson *jp, int64 value)
+{
+    char    buf[32], *cp;
+
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    cp = formatNumber(&buf[sizeof(buf)], (value < 0) ? -(uint64) value : (uint64) value, 0, value < 0);
+    put(jp, cp, &buf[sizeof(buf)] - cp);
+    return endValue(jp);
+}
+
+
+#if BIT_FLOAT
+/*
+    Values with up to JSON_FRACTION decimal places are written exactly as a scaled integer. Otherwise write the
+    fewest of 15, 16 or 17 significant digits that reads back as the same value. Infinity and NaN have no JSON
+    representation and are written as null.
+ */
+PUBLIC int websJsonDouble(WebsJson *jp, double value)
+{
+    char    buf[32], *cp;
+    double  scale, scaled;
+    int64   n;
+    int     places;
+
+    if (!(value - value == 0)) {
+        return websJsonNull(jp);
+    }
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    for (places = 0, scale = 1; places <= JSON_FRACTION; places++, scale *= 10) {
+        scaled = value * scale;
+        if (scaled >= JSON_EXACT || scaled <= -JSON_EXACT) {
+            break;
+        }
+        n = (int64) (scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        if ((double) n / scale == value) {
+            /* The division is correctly rounded, so the decimal n / 10^places reads back as value */
+            cp = formatNumber(&buf[sizeof(buf)], (n < 0) ? -(uint64) n : (uint64) n, places, n < 0);
+            put(jp, cp, &buf[sizeof(buf)] - cp);
+            return endValue(jp);
+        }
+    }
+    for (places = 15; places <= 17; places++) {
+        snprintf(buf, sizeof(buf), "%.*g", places, value);
+        if (strtod(buf, 0) == value) {
+            break;
+        }
+    }
+    put(jp, buf, slen(buf));
+    return endValue(jp);
+}
+#endif
+
+
+PUBLIC int websJsonBool(WebsJson *jp, bool value)
+{
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    if (value) {
+        put(jp, "true", 4);
+    } else {
+        put(jp, "false", 5);
+    }
+    return endValue(jp);
+}
+
+
+PUBLIC int websJsonNull(WebsJson *jp)
+{
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    put(jp, "null", 4);
+    return endValue(jp);
+}
+
+
+/*
+    Check a value may be written here and write the separating comma
+ */
+static int beginValue(WebsJson *jp)
+{
+    uint    bit;
+
+    assert(jp);
+
+    if (jp->error) {
+        return -1;
+    }
+    bit = 1U << jp->depth;
+    if (jp->objects & bit) {
+        if (!jp->key) {
+            jp->error = 1;
+            return -1;
+        }
+        jp->key = 0;
+    } else {
+        if (jp->depth == 0 && jp->comma) {
+            /* Only one top level value */
+            jp->error = 1;
+            return -1;
+        }
+        if (jp->comma & bit) {
+            put(jp, ",", 1);
+        }
+        jp->comma |= bit;
+    }
+    return 0;
+}
+
+
+/*
+    Write the staged output once the top level value is complete
+ */
+static int endValue(WebsJson *jp)
+{
+    if (jp->depth == 0) {
+        flush(jp);
+    }
+    return jp->error ? -1 : 0;
+}
+
+
+static int begin(WebsJson *jp, int object, char *open)
+{
+    uint    bit;
+
+    if (beginValue(jp) < 0) {
+        return -1;
+    }
+    if (jp->depth + 1 >= WEBS_JSON_DEPTH) {
+        jp->error = 1;
+        return -1;
+    }
+    jp->depth++;
+    bit = 1U << jp->depth;
+    jp->comma &= ~bit;
+    if (object) {
+        jp->objects |= bit;
+    } else {
+        jp->objects &= ~bit;
+    }
+    put(jp, open, 1);
+    return jp->error ? -1 : 0;
+}
+
+
+static int end(WebsJson *jp, int object, char *close)
+{
+    uint    bit;
+
+    assert(jp);
+
+    bit = 1U << jp->depth;
+    if (jp->error || jp->key || jp->depth == 0 || ((jp->objects & bit) != 0) != object) {
+        jp->error = 1;
+        return -1;
+    }
+    jp->depth--;
+    put(jp, close, 1);
+    return endValue(jp);
+}
+
+
+static int flush(WebsJson *jp)
+{
+    if (jp->len > 0 && !jp->error) {
+        if (websWriteBlock(jp->wp, jp->buf, jp->len) != jp->len) {
+            jp->error = 1;
+        }
+    }
+    jp->len = 0;
+    return jp->error ? -1 : 0;
+}
+
+
+/*
+    Format n backwards from end with a decimal point before the last "places" digits. Returns the start.
+ */
+static char *formatNumber(char *end, uint64 n, int places, int negative)
+{
+    char    *cp;
+
+    cp = end;
+    if (places > 0) {
+        for (; places > 0; places--) {
+            *--cp = (char) ('0' + (n % 10));
+            n /= 10;
+        }
+        *--cp = '.';
+    }
+    do {
+        *--cp = (char) ('0' + (n % 10));
+        n /= 10;
+    } while (n > 0);
+    if (negative) {
+        *--cp = '-';
+    }
+    return cp;
+}
+
+
+static void put(WebsJson *jp, char *buf, ssize len)
+{
+    if (jp->len + len > (ssize) sizeof(jp->buf)) {
+        flush(jp);
+        if (len > (ssize) sizeof(jp->buf)) {
+            if (!jp->error && websWriteBlock(jp->wp, buf, len) != len) {
+                jp->error = 1;
+            }
+            return;
+        }
+    }
+    memcpy(&jp->buf[jp->len], buf, len);
+    jp->len += len;
+}
+
+
+/*
+    Write a quoted string escaped by websWriteEscapedJson. Staged output is flushed first to preserve the order.
+ */
+static void putString(WebsJson *jp, char *str)
+{
+    put(jp, "\"", 1);
+    flush(jp);
+    if (!jp->error && websWriteEscapedJson(jp->wp, str, -1) < 0) {
+        jp->error = 1;
+    }
+    put(jp, "\"", 1);
+}
+
+
+#if BIT_GOAHEAD_JSON
+/*********************************** Parser ***********************************/
+
+PUBLIC void websJsonParserOpen(WebsJsonParser *parser, WebsJsonEvent event, void *data)
+{
+    assert(parser);
+    assert(event);
+
+    parser->event = event;
+    parser->data = data;
+    parser->error = 0;
+    parser->pending = 0;
+    parser->escaped = 0;
+    parser->state = JSON_VALUE;
+    parser->depth = 0;
+    parser->maxDepth = BIT_GOAHEAD_LIMIT_JSON_DEPTH;
+}
+
+
+/*
+    Parse as much input as possible. A token is only consumed once it is complete, so the caller must supply the
+    unconsumed bytes again with the next input.
+ */
+PUBLIC ssize websJsonParse(WebsJsonParser *parser, char *buf, ssize len, bool eof)
+{
+    char    *cp, *end, *start;
+    int     c, rc;
+
+    assert(parser);
+    assert(buf || len == 0);
+
+    if (parser->error) {
+        return -1;
+    }
+    end = &buf[len];
+    for (cp = buf; ; ) {
+        while (cp < end && (*cp == ' ' || *cp == '\t' || *cp == '\n' || *cp == '\r')) {
+            cp++;
+        }
+        if (cp >= end) {
+            break;
+        }
+        c = *cp;
+        start = cp;
+        switch (parser->state) {
+        case JSON_DONE:
+            return parseError(parser, "Unexpected data after the JSON value");
+
+        case JSON_COLON:
+            if (c != ':') {
+                return parseError(parser, "Expected a colon");
+            }
+            cp++;
+            parser->state = JSON_VALUE;
+            continue;
+
+        case JSON_NEXT:
+            if (c == ',') {
+                cp++;
+                parser->state = (parser->stack[parser->depth] == '{') ? JSON_KEY : JSON_VALUE;
+                continue;
+            }
+            if ((c == '}' || c == ']') && parser->stack[parser->depth] == c - 2) {
+                if (closeContainer(parser, c) < 0) {
+                    return -1;
+                }
+                cp++;
+                continue;
+            }
+            return parseError(parser, "Expected a comma or the end of an object or array");
+
+        case JSON_KEY_OR_END:
+            if (c == '}') {
+                if (closeContainer(parser, c) < 0) {
+                    return -1;
+                }
+                cp++;
+                continue;
+            }
+            /* Fall through */
+
+        case JSON_KEY:
+            if (c != '"') {
+                return parseError(parser, "Expected an object member name");
+            }
+            if ((rc = parseString(parser, &cp, end, eof, WEBS_JSON_KEY)) <= 0) {
+                return (rc < 0) ? -1 : start - buf;
+            }
+            parser->state = JSON_COLON;
+            continue;
+
+        case JSON_VALUE_OR_END:
+            if (c == ']') {
+                if (closeContainer(parser, c) < 0) {
+                    return -1;
+                }
+                cp++;
+                continue;
+            }
+            /* Fall through */
+
+        case JSON_VALUE:
+            if (c == '{' || c == '[') {
+                if (parser->depth >= parser->maxDepth) {
+                    return parseError(parser, "JSON nesting is too deep");
+                }
+                parser->stack[++parser->depth] = (char) c;
+                if (emit(parser, (c == '{') ? WEBS_JSON_OBJECT : WEBS_JSON_ARRAY, 0, 0) < 0) {
+                    return -1;
+                }
+                parser->state = (c == '{') ? JSON_KEY_OR_END : JSON_VALUE_OR_END;
+                cp++;
+                continue;
+            }
+            if (c == '"') {
+                rc = parseString(parser, &cp, end, eof, WEBS_JSON_STRING);
+            } else if (c == '-' || isdigit(c)) {
+                rc = parseNumber(parser, &cp, end, eof);
+            } else {
+                rc = parseLiteral(parser, &cp, end, eof);
+            }
+            if (rc <= 0) {
+                return (rc < 0) ? -1 : start - buf;
+            }
+            parser->state = (parser->depth == 0) ? JSON_DONE : JSON_NEXT;
+            continue;
+        }
+    }
+    if (eof && parser->state != JSON_DONE) {
+        return parseError(parser, "Incomplete JSON value");
+    }
+    return cp - buf;
+}
+
+
+/*
+    Decode a key or string token. The output is never longer than the token, so decoding may be done in place.
+ */
+PUBLIC ssize websJsonDecode(char *buf, ssize size, char *token, ssize len)
+{
+    char    *ip, *op, *end, *limit;
+    int     c, c2;
+
+    assert(buf);
+    assert(token || len == 0);
+
+    if (size <= 0) {
+        return -1;
+    }
+    op = buf;
+    limit = &buf[size - 1];
+    end = &token[len];
+    for (ip = token; ip < end; ) {
+        if (op >= limit) {
+            return -1;
+        }
+        if (*ip != '\\') {
+            *op++ = *ip++;
+            continue;
+        }
+        if (++ip >= end) {
+            return -1;
+        }
+        switch (*ip++) {
+        case '"':  *op++ = '"'; break;
+        case '\\': *op++ = '\\'; break;
+        case '/':  *op++ = '/'; break;
+        case 'b':  *op++ = '\b'; break;
+        case 'f':  *op++ = '\f'; break;
+        case 'n':  *op++ = '\n'; break;
+        case 'r':  *op++ = '\r'; break;
+        case 't':  *op++ = '\t'; break;
+        case 'u':
+            if ((c = hex4(ip, end)) < 0) {
+                return -1;
+            }
+            ip += 4;
+            if (c >= 0xD800 && c <= 0xDBFF && (end - ip) >= 6 && ip[0] == '\\' && ip[1] == 'u' &&
+                    (c2 = hex4(&ip[2], end)) >= 0xDC00 && c2 <= 0xDFFF) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+                ip += 6;
+            }
+            if ((op + 4) > limit && (op + utf8Length(c)) > limit) {
+                return -1;
+            }
+            op = utf8Encode(op, c);
+            break;
+        default:
+            return -1;
+        }
+    }
+    *op = '\0';
+    return op - buf;
+}
+
+
+/*
+    Return the value of a 4 digit hex escape or -1
+ */
+static int hex4(char *cp, char *end)
+{
+    int     i, c, value;
+
+    if ((end - cp) < 4) {
+        return -1;
+    }
+    for (value = 0, i = 0; i < 4; i++) {
+        c = (uchar) cp[i];
+        if (!isxdigit(c)) {
+            return -1;
+        }
+        value = (value << 4) | (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+    }
+    return value;
+}
+
+
+static int utf8Length(int c)
+{
+    return (c < 0x80) ? 1 : (c < 0x800) ? 2 : (c < 0x10000) ? 3 : 4;
+}
+
+
+static char *utf8Encode(char *op, int c)
+{
+    if (c < 0x80) {
+        *op++ = (char) c;
+    } else if (c < 0x800) {
+        *op++ = (char) (0xC0 | (c >> 6));
+        *op++ = (char) (0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        *op++ = (char) (0xE0 | (c >> 12));
+        *op++ = (char) (0x80 | ((c >> 6) & 0x3F));
+        *op++ = (char) (0x80 | (c & 0x3F));
+    } else {
+        *op++ = (char) (0xF0 | (c >> 18));
+        *op++ = (char) (0x80 | ((c >> 12) & 0x3F));
+        *op++ = (char) (0x80 | ((c >> 6) & 0x3F));
+        *op++ = (char) (0x80 | (c & 0x3F));
+    }
+    return op;
+}
+
+
+/*
+    Parse a key or string token starting at the opening quote. Returns 1 if complete, zero if more input is required
+    and -1 on errors. Scanning of an incomplete string resumes where it stopped when more input is supplied.
+ */
+static int parseString(WebsJsonParser *parser, char **cpp, char *end, bool eof, int event)
+{
+    char    *start, *cp;
+    int     c;
+
+    start = *cpp + 1;
+    for (cp = start + parser->pending; cp < end; cp++) {
+        c = (uchar) *cp;
+        if (c == '"') {
+            if (parser->escaped) {
+                event |= WEBS_JSON_ESCAPED;
+            }
+            parser->pending = 0;
+            parser->escaped = 0;
+            *cpp = cp + 1;
+            return emit(parser, event, start, cp - start) < 0 ? -1 : 1;
+        }
+        if (c < 0x20) {
+            return parseError(parser, "Control character in string");
+        }
+        if (c == '\\') {
+            if ((end - cp) < 2 || (cp[1] == 'u' && (end - cp) < 6)) {
+                break;
+            }
+            if (!strchr("\"\\/bfnrtu", cp[1]) || (cp[1] == 'u' && hex4(&cp[2], end) < 0)) {
+                return parseError(parser, "Bad escape in string");
+            }
+            parser->escaped = 1;
+            cp += (cp[1] == 'u') ? 5 : 1;
+        }
+    }
+    if (eof) {
+        return parseError(parser, "Unterminated string");
+    }
+    parser->pending = cp - start;
+    return 0;
+}
+
+
+/*
+    Parse a number. Returns 1 if complete, zero if more input is required and -1 on errors.
+ */
+static int parseNumber(WebsJsonParser *parser, char **cpp, char *end, bool eof)
+{
+    char    *start, *cp;
+
+    start = cp = *cpp;
+    while (cp < end && (isdigit((uchar) *cp) || *cp == '-' || *cp == '+' || *cp == '.' || *cp == 'e' || *cp == 'E')) {
+        cp++;
+    }
+    if (cp == end && !eof) {
+        /* The number may continue in the next input */
+        return 0;
+    }
+    if (!validNumber(start, cp)) {
+        return parseError(parser, "Bad number");
+    }
+    *cpp = cp;
+    return emit(parser, WEBS_JSON_NUMBER, start, cp - start) < 0 ? -1 : 1;
+}
+
+
+/*
+    Validate a number: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+static bool validNumber(char *cp, char *end)
+{
+    char    *digits;
+
+    if (cp < end && *cp == '-') {
+        cp++;
+    }
+    if (cp < end && *cp == '0') {
+        cp++;
+    } else {
+        for (digits = cp; cp < end && isdigit((uchar) *cp); cp++) ;
+        if (cp == digits) {
+            return 0;
+        }
+    }
+    if (cp < end && *cp == '.') {
+        for (digits = ++cp; cp < end && isdigit((uchar) *cp); cp++) ;
+        if (cp == digits) {
+            return 0;
+        }
+    }
+    if (cp < end && (*cp == 'e' || *cp == 'E')) {
+        cp++;
+        if (cp < end && (*cp == '+' || *cp == '-')) {
+            cp++;
+        }
+        for (digits = cp; cp < end && isdigit((uchar) *cp); cp++) ;
+        if (cp == digits) {
+            return 0;
+        }
+    }
+    return cp == end;
+}
+
+
+/*
+    Parse true, false or null. Returns 1 if complete, zero if more input is required and -1 on errors.
+ */
+static int parseLiteral(WebsJsonParser *parser, char **cpp, char *end, bool eof)
+{
+    char    *literal, *cp;
+    ssize   len, avail;
+    int     event;
+
+    cp = *cpp;
+    if (*cp == 't') {
+        literal = "true";
+        event = WEBS_JSON_TRUE;
+    } else if (*cp == 'f') {
+        literal = "false";
+        event = WEBS_JSON_FALSE;
+    } else if (*cp == 'n') {
+        literal = "null";
+        event = WEBS_JSON_NULL;
+    } else {
+        return parseError(parser, "Unexpected character");
+    }
+    len = slen(literal);
+    avail = end - cp;
+    if (avail < len) {
+        if (!eof && strncmp(cp, literal, avail) == 0) {
+            return 0;
+        }
+        return parseError(parser, "Unexpected character");
+    }
+    if (strncmp(cp, literal, len) != 0) {
+        return parseError(parser, "Unexpected character");
+    }
+    *cpp = cp + len;
+    return emit(parser, event, cp, len) < 0 ? -1 : 1;
+}
+
+
+static int closeContainer(WebsJsonParser *parser, int c)
+{
+    parser->depth--;
+    parser->state = (parser->depth == 0) ? JSON_DONE : JSON_NEXT;
+    return emit(parser, (c == '}') ? WEBS_JSON_END_OBJECT : WEBS_JSON_END_ARRAY, 0, 0);
+}
+
+
+static int emit(WebsJsonParser *parser, int event, char *token, ssize len)
+{
+    if ((parser->event)(parser->data, event, token, len) < 0) {
+        if (!parser->error) {
+            parser->error = "JSON parsing aborted";
+        }
+        return -1;
+    }
+    return 0;
+}
+
+
+static int parseError(WebsJsonParser *parser, char *msg)
+{
+    parser->error = msg;
+    return -1;
+}
+
+/********************************** Documents *********************************/
+
+PUBLIC WebsJsonDoc *websJsonOpenDoc(ssize maxMemory)
+{
+    WebsJsonDoc     *doc;
+
+    if ((doc = walloc(sizeof(WebsJsonDoc))) == 0) {
+        return 0;
+    }
+    memset(doc, 0, sizeof(WebsJsonDoc));
+    websJsonParserOpen(&doc->parser, docEvent, doc);
+    doc->maxMemory = (maxMemory > 0) ? maxMemory : BIT_GOAHEAD_LIMIT_JSON;
+    return doc;
+}
+
+
+PUBLIC void websJsonCloseDoc(WebsJsonDoc *doc)
+{
+    void    *block, *next;
+
+    if (doc) {
+        for (block = doc->blocks; block; block = next) {
+            next = *(void**) block;
+            wfree(block);
+        }
+        wfree(doc);
+    }
+}
+
+
+PUBLIC ssize websJsonParseDoc(WebsJsonDoc *doc, char *buf, ssize len, bool eof)
+{
+    assert(doc);
+    return websJsonParse(&doc->parser, buf, len, eof);
+}
+
+
+PUBLIC WebsJsonNode *websJsonGet(WebsJsonNode *node, char *name)
+{
+    WebsJsonNode    *np;
+
+    if (node == 0 || node->type != WEBS_JSON_OBJECT || name == 0) {
+        return 0;
+    }
+    for (np = node->children; np; np = np->next) {
+        if (strcmp(np->name, name) == 0) {
+            return np;
+        }
+    }
+    return 0;
+}
+
+
+PUBLIC WebsJsonNode *websJsonGetItem(WebsJsonNode *node, int index)
+{
+    WebsJsonNode    *np;
+
+    if (node == 0 || node->type != WEBS_JSON_ARRAY || index < 0 || index >= node->len) {
+        return 0;
+    }
+    for (np = node->children; np && index > 0; np = np->next, index--) ;
+    return np;
+}
+
+
+/*
+    Build the document from parser events
+ */
+static int docEvent(void *data, int event, char *token, ssize len)
+{
+    WebsJsonDoc     *doc;
+    WebsJsonNode    *np, *parent;
+    int             type, depth;
+
+    doc = data;
+    depth = doc->parser.depth;
+    type = event & WEBS_JSON_EVENT_MASK;
+
+    if (type == WEBS_JSON_END_OBJECT || type == WEBS_JSON_END_ARRAY) {
+        /* The parser depth has already been decremented */
+        return 0;
+    }
+    if (type == WEBS_JSON_KEY) {
+        if ((doc->name = docString(doc, event, token, len)) == 0) {
+            return -1;
+        }
+        return 0;
+    }
+    if ((np = docAlloc(doc, sizeof(WebsJsonNode))) == 0) {
+        return -1;
+    }
+    memset(np, 0, sizeof(WebsJsonNode));
+    np->type = type;
+
+    if (type == WEBS_JSON_OBJECT || type == WEBS_JSON_ARRAY) {
+        /* The parser depth has been incremented for the new container */
+        doc->parents[depth] = np;
+        doc->last[depth] = 0;
+        depth--;
+    } else if (type == WEBS_JSON_STRING) {
+        if ((np->value = docString(doc, event, token, len)) == 0) {
+            return -1;
+        }
+        np->len = slen(np->value);
+    } else {
+        if ((np->value = docString(doc, event, token, len)) == 0) {
+            return -1;
+        }
+        np->len = len;
+    }
+    if (depth == 0) {
+        doc->root = np;
+        return 0;
+    }
+    parent = doc->parents[depth];
+    if (parent->type == WEBS_JSON_OBJECT) {
+        np->name = doc->name;
+        doc->name = 0;
+    }
+    if (doc->last[depth]) {
+        doc->last[depth]->next = np;
+    } else {
+        parent->children = np;
+    }
+    doc->last[depth] = np;
+    parent->len++;
+    return 0;
+}
+
+
+/*
+    Copy a token into the document and decode escapes
+ */
+static char *docString(WebsJsonDoc *doc, int event, char *token, ssize len)
+{
+    char    *str;
+
+    if ((str = docAlloc(doc, len + 1)) == 0) {
+        return 0;
+    }
+    if (event & WEBS_JSON_ESCAPED) {
+        if (websJsonDecode(str, len + 1, token, len) < 0) {
+            doc->parser.error = "Bad escape in string";
+            return 0;
+        }
+    } else {
+        memcpy(str, token, len);
+        str[len] = '\0';
+    }
+    return str;
+}
+
+
+/*
+    Allocate memory from the document blocks
+ */
+static void *docAlloc(WebsJsonDoc *doc, ssize size)
+{
+    char    *block;
+    ssize   blockSize;
+
+    size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    if ((doc->end - doc->next) < size) {
+        blockSize = max(JSON_BLOCK, size + (ssize) sizeof(void*));
+        if ((doc->memory + blockSize) > doc->maxMemory) {
+            doc->parser.error = jsonTooBig;
+            return 0;
+        }
+        if ((block = walloc(blockSize)) == 0) {
+            doc->parser.error = "Memory allocation error";
+            return 0;
+        }
+        *(void**) block = doc->blocks;
+        doc->blocks = block;
+        doc->memory += blockSize;
+        doc->next = block + sizeof(void*);
+        doc->end = block + blockSize;
+    }
+    block = doc->next;
+    doc->next += size;
+    return block;
+}
+
+/******************************* Request Bodies *******************************/
+
+/*
+    Select how to parse a JSON request body. Only actions that receive parser events and routes that want a parsed
+    document parse the body. Otherwise the body is left for the handler, such as the PUT and proxy handlers.
+ */
+PUBLIC int websOpenJsonBody(Webs *wp)
+{
+    WebsRoute       *route;
+    WebsJsonEvent   event;
+    JsonState       *js;
+
+    assert(wp);
+
+    if ((route = websSelectRoute(wp)) == 0) {
+        return 0;
+    }
+    event = smatch(route->handler->name, "action") ? websGetActionJsonEvent(wp) : 0;
+    if (!event && !route->json) {
+        return 0;
+    }
+    if ((js = walloc(sizeof(JsonState))) == 0) {
+        return -1;
+    }
+    memset(js, 0, sizeof(JsonState));
+    wp->json = js;
+    if (event) {
+        websJsonParserOpen(&js->parser, event, wp);
+    } else if ((js->doc = websJsonOpenDoc(0)) == 0) {
+        return -1;
+    }
+    wp->flags |= WEBS_JSON;
+    return 0;
+}
+
+
+/*
+    Parse request body data as it is received. The parsed input is consumed so only an incomplete token is retained
+    in the input buffer.
+ */
+PUBLIC int websProcessJsonData(Webs *wp)
+{
+    JsonState       *js;
+    WebsJsonParser  *parser;
+    ssize           nbytes;
+
+    assert(wp);
+
+    if ((js = wp->json) == 0) {
+        return 0;
+    }
+    parser = js->doc ? &js->doc->parser : &js->parser;
+    nbytes = websJsonParse(parser, wp->input.servp, bufLen(&wp->input), wp->eof);
+    if (nbytes < 0) {
+        if (wp->state < WEBS_COMPLETE) {
+            if (parser->error == jsonTooBig) {
+                websError(wp, HTTP_CODE_REQUEST_TOO_LARGE | WEBS_CLOSE, "%s", parser->error);
+            } else {
+                websError(wp, HTTP_CODE_BAD_REQUEST, "Bad JSON request body: %s", parser->error);
+            }
+        }
+        return -1;
+    }
+    js->received += nbytes;
+    if (js->received > BIT_GOAHEAD_LIMIT_JSON) {
+        websError(wp, HTTP_CODE_REQUEST_TOO_LARGE | WEBS_CLOSE, "JSON request body is too big");
+        return -1;
+    }
+    websConsumeInput(wp, nbytes);
+    if (bufLen(&wp->input) > 0) {
+        /* Keep the incomplete token contiguous for the next parse */
+        bufCompact(&wp->input);
+    }
+    return 0;
+}
+
+
+PUBLIC WebsJsonNode *websGetJson(Webs *wp)
+{
+    JsonState   *js;
+
+    assert(wp);
+
+    if ((js = wp->json) == 0 || js->doc == 0 || js->doc->parser.state != JSON_DONE) {
+        return 0;
+    }
+    return js->doc->root;
+}
+
+
+PUBLIC char *websGetJsonVar(Webs *wp, char *name, char *defaultValue)
+{
+    WebsJsonNode    *np;
+
+    if ((np = websJsonGet(websGetJson(wp), name)) == 0 || np->value == 0) {
+        return defaultValue;
+    }
+    return np->value;
+}
+
+
+PUBLIC void websFreeJson(Webs *wp)
+{
+    JsonState   *js;
+
+    if ((js = wp->json) != 0) {
+        websJsonCloseDoc(js->doc);
+        wfree(js);
+        wp->json = 0;
+    }
+}
+#endif /* BIT_GOAHEAD_JSON */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+    vim: sw=4 ts=4 expandtab
+
+    @end
+ */
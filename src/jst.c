@@ -18,6 +18,21 @@ static WebsHash websJstFunctions = -1;  /* Symbol table of functions */
 
 static char *strtokcmp(char *s1, char *s2);
 static char *skipWhite(char *s);
+#if BIT_GOAHEAD_CACHE
+static int cacheGet(int jid, Webs *wp, int argc, char **argv);
+static int cacheSet(int jid, Webs *wp, int argc, char **argv);
+#endif
+static int writeHtml(int jid, Webs *wp, int argc, char **argv);
+static int writeJson(int jid, Webs *wp, int argc, char **argv);
+static int writeUri(int jid, Webs *wp, int argc, char **argv);
+static void renderPage(Webs *wp, char *buf);
+#if BIT_ROM
+static void renderTemplate(int jid, Webs *wp, WebsJstSegment *segments);
+#endif
+#if BIT_GOAHEAD_AIO
+static void jstLoaded(Webs *wp, WebsAio *aio);
+static void jstOpened(Webs *wp, WebsAio *aio);
+#endif
 
 /************************************* Code ***********************************/
 /*
@@ -27,25 +42,46 @@ static char *skipWhite(char *s);
 static bool jstHandler(Webs *wp)
 {
     WebsFileInfo    sbuf;
-    char            *token, *lang, *result, *ep, *cp, *buf, *nextp, *last;
+#if BIT_ROM
+    WebsRomIndex    *wip;
+#endif
+    char            *buf;
     ssize           len;
-    int             rc, jid;
 
     assert(websValid(wp));
     assert(wp->filename && *wp->filename);
     assert(wp->ext && *wp->ext);
 
-    buf = 0;
-    if ((jid = jsOpenEngine(wp->vars, websJstFunctions)) < 0) {
-        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't create JavaScript engine");
-        goto done;
+#if BIT_ROM
+    if ((wip = websLookupRom(wp->filename)) != 0 && wip->jst) {
+        renderPage(wp, 0);
+        return 1;
     }
-    jsSetUserHandle(jid, wp);
-
+#endif
+#if BIT_GOAHEAD_AIO
+    /*
+        Load the page using the I/O threads if on a slow mount
+     */
+    if (websAioWanted(wp, -1)) {
+        if (websAioOpenFile(wp, jstOpened) < 0) {
+            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't read %s", wp->filename);
+        }
+        return 1;
+    }
+#endif
+    buf = 0;
     if (websPageStat(wp, &sbuf) < 0) {
         websError(wp, HTTP_CODE_NOT_FOUND, "Can't stat %s", wp->filename);
         goto done;
     }
+#if BIT_GOAHEAD_AIO
+    if (websAioWanted(wp, sbuf.size)) {
+        if (websAioOpenFile(wp, jstOpened) < 0) {
+            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't read %s", wp->filename);
+        }
+        return 1;
+    }
+#endif
     if (websPageOpen(wp, O_RDONLY | O_BINARY, 0666) < 0) {
         websError(wp, HTTP_CODE_NOT_FOUND, "Cannot open URL: %s", wp->filename);
         goto done;
@@ -65,6 +101,77 @@ static bool jstHandler(Webs *wp)
         goto done;
     }
     websPageClose(wp);
+    renderPage(wp, buf);
+    wfree(buf);
+    return 1;
+
+done:
+    websPageClose(wp);
+    websDone(wp);
+    wfree(buf);
+    return 1;
+}
+
+
+#if BIT_GOAHEAD_AIO
+/*
+    Completion callback when the page has been opened by the I/O threads. Read the entire page.
+ */
+static void jstOpened(Webs *wp, WebsAio *aio)
+{
+    if (aio->error || aio->info.isDir) {
+        websError(wp, HTTP_CODE_NOT_FOUND, "Cannot open URL: %s", wp->filename);
+        return;
+    }
+    wp->docfd = aio->fd;
+    aio->fd = -1;
+    if (aio->info.size == 0) {
+        websPageClose(wp);
+        renderPage(wp, "");
+        return;
+    }
+    if (websAioRead(wp, wp->docfd, 0, aio->info.size, jstLoaded) < 0) {
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't get memory");
+    }
+}
+
+
+/*
+    Completion callback when the page has been read by the I/O threads
+ */
+static void jstLoaded(Webs *wp, WebsAio *aio)
+{
+    websPageClose(wp);
+    if (aio->error || aio->nbytes != (ssize) aio->info.size) {
+        websError(wp, HTTP_CODE_NOT_FOUND, "Cant read %s", wp->filename);
+        return;
+    }
+    renderPage(wp, aio->buf);
+}
+#endif
+
+
+/*
+    Write the page evaluating embedded scripts. The buffer is modified.
+ */
+static void renderPage(Webs *wp, char *buf)
+{
+    char    *token, *lang, *result, *ep, *cp, *nextp, *last;
+    int     rc, jid;
+
+    websParseVars(wp);
+    if ((jid = jsOpenEngine(wp->vars, websJstFunctions)) < 0) {
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't create JavaScript engine");
+        goto done;
+    }
+    jsSetUserHandle(jid, wp);
+
+#if BIT_ROM
+    if (buf == 0) {
+        renderTemplate(jid, wp, websLookupRom(wp->filename)->jst);
+        goto done;
+    }
+#endif
     websWriteHeaders(wp, (ssize) -1, 0);
     websWriteHeader(wp, "Pragma", "no-cache");
     websWriteHeader(wp, "Cache-Control", "no-cache");
@@ -151,18 +258,66 @@ static bool jstHandler(Webs *wp)
     Common exit and cleanup
  */
 done:
-    if (websValid(wp)) {
-        websPageClose(wp);
-        if (jid >= 0) {
-            jsCloseEngine(jid);
-        }
+    if (websValid(wp) && jid >= 0) {
+        jsCloseEngine(jid);
     }
     websDone(wp);
-    wfree(buf);
-    return 1;
 }
 
 
+#if BIT_ROM
+/*
+    Render a template precompiled by webcomp. Literal text is written directly from the compiled page and functions
+    are called without parsing.
+ */
+static void renderTemplate(int jid, Webs *wp, WebsJstSegment *segments)
+{
+    WebsJstSegment  *sp;
+    WebsKey         *key;
+    char            *args[WEBS_MAX_JST_ARGS], **argv;
+    int             i;
+
+    websWriteHeaders(wp, (ssize) -1, 0);
+    websWriteHeader(wp, "Pragma", "no-cache");
+    websWriteHeader(wp, "Cache-Control", "no-cache");
+    websWriteEndHeaders(wp);
+
+    for (sp = segments; sp->text; sp++) {
+        if (sp->len >= 0) {
+            websWriteBlock(wp, sp->text, sp->len);
+            continue;
+        }
+        if (!sp->fn) {
+            if ((key = hashLookup(websJstFunctions, sp->text)) == 0) {
+                websWrite(wp, "<h2><b>Javascript Error: Undefined procedure %s</b></h2>\n</body></html>\n", sp->text);
+                return;
+            }
+            sp->fn = key->content.value.symbol;
+        }
+        argv = sp->argv;
+        if (sp->vars) {
+            for (i = 0; i < sp->argc; i++) {
+                if (!(sp->vars & (1 << i))) {
+                    args[i] = sp->argv[i];
+                } else if ((args[i] = websGetVar(wp, sp->argv[i], 0)) == 0) {
+                    websWrite(wp, "<h2><b>Javascript Error: Undefined variable %s</b></h2>\n</body></html>\n", 
+                        sp->argv[i]);
+                    return;
+                }
+            }
+            argv = args;
+        }
+        if ((*(WebsJstProc) sp->fn)(jid, wp, sp->argc, argv) < 0) {
+            if (websValid(wp)) {
+                websWrite(wp, "<h2><b>Javascript Error</b></h2>\n%s\n</body></html>\n", sp->text);
+            }
+            return;
+        }
+    }
+}
+#endif
+
+
 static void closeJst()
 {
     if (websJstFunctions != -1) {
@@ -176,6 +331,13 @@ PUBLIC int websJstOpen()
 {
     websJstFunctions = hashCreate(WEBS_HASH_INIT * 2);
     websDefineJst("write", websJstWrite);
+    websDefineJst("writeHtml", writeHtml);
+    websDefineJst("writeJson", writeJson);
+    websDefineJst("writeUri", writeUri);
+#if BIT_GOAHEAD_CACHE
+    websDefineJst("cacheGet", cacheGet);
+    websDefineJst("cacheSet", cacheSet);
+#endif
     websDefineHandler("jst", jstHandler, closeJst, 0);
     return 0;
 }
@@ -214,6 +376,87 @@ PUBLIC int websJstWrite(int jid, Webs *wp, int argc, char **argv)
 }
 
 
+/*
+    Escaped writes. These implement <% writeHtml(value); %>, writeJson and writeUri. Arguments are concatenated.
+ */
+static int writeHtml(int jid, Webs *wp, int argc, char **argv)
+{
+    int     i;
+
+    for (i = 0; i < argc; i++) {
+        if (websWriteEscapedHtml(wp, argv[i], -1) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+static int writeJson(int jid, Webs *wp, int argc, char **argv)
+{
+    int     i;
+
+    for (i = 0; i < argc; i++) {
+        if (websWriteEscapedJson(wp, argv[i], -1) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+static int writeUri(int jid, Webs *wp, int argc, char **argv)
+{
+    int     i;
+
+    for (i = 0; i < argc; i++) {
+        if (websWriteEscapedUri(wp, argv[i], -1) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+#if BIT_GOAHEAD_CACHE
+/*
+    Value cache access. These implement <% value = cacheGet(key, [default]); %> and
+    <% cacheSet(key, value, [lifespan]); %>
+ */
+static int cacheGet(int jid, Webs *wp, int argc, char **argv)
+{
+    char    *key, *defaultValue, *value;
+
+    defaultValue = "";
+    if (jsArgs(argc, argv, "%s %s", &key, &defaultValue) < 1) {
+        websError(wp, HTTP_CODE_BAD_REQUEST, "Insufficient args");
+        return -1;
+    }
+    if ((value = websCacheGet(key, 0)) == 0) {
+        value = defaultValue;
+    }
+    jsSetResult(jid, value);
+    return 0;
+}
+
+
+static int cacheSet(int jid, Webs *wp, int argc, char **argv)
+{
+    char    *key, *value;
+    int     lifespan;
+
+    lifespan = 0;
+    if (jsArgs(argc, argv, "%s %s %d", &key, &value, &lifespan) < 2) {
+        websError(wp, HTTP_CODE_BAD_REQUEST, "Insufficient args");
+        return -1;
+    }
+    /* Caching is best effort, so a value too big to cache does not fail the page */
+    websCacheSet(key, value, -1, lifespan);
+    return 0;
+}
+#endif
+
+
 /*
     Find s2 in s1. We skip leading white space in s1.  Return a pointer to the location in s1 after s2 ends.
  */
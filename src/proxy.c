@@ -0,0 +1,1120 @@
+/*
+    proxy.c -- Reverse proxy handler
+
+    This module implements the "proxy" handler which forwards requests to an upstream HTTP server. The upstream is
+    defined per route via the "proxy" route keyword. For example:
+
+        route uri=/api/ handler=proxy proxy=http://127.0.0.1:9000 methods=GET|POST|PUT|DELETE
+
+    If the proxy URL includes a path, the route prefix is replaced by that path. Otherwise the request URI is forwarded
+    unchanged. Upstream connections are non-blocking and are kept in a pool for reuse by subsequent requests when
+    the upstream permits keep-alive. Request bodies are streamed to the upstream as they are received and reading from
+    the client is paused while the upstream is not accepting data. Response bodies are streamed to the client as they
+    arrive and reading from the upstream is paused while the client output buffer is full. Hop-by-hop headers are not
+    forwarded in either direction.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#include    "goahead.h"
+
+#if BIT_GOAHEAD_PROXY
+/*********************************** Defines **********************************/
+
+#define PROXY_MAX_IDLE      16              /* Maximum idle upstream connections to keep */
+#define PROXY_IDLE_TIMEOUT  (30 * 1000)     /* Time to keep idle upstream connections in msec */
+#define PROXY_MAX_LINE      256             /* Maximum length of a chunk size line */
+#define PROXY_MAX_INPUT     (BIT_GOAHEAD_LIMIT_BUFFER * 8)  /* Request body to buffer before pausing the client */
+
+/*
+    Proxy request states
+ */
+#define PROXY_CONNECTING    1               /* Waiting for the upstream connect to complete */
+#define PROXY_SENDING       2               /* Writing the request to the upstream */
+#define PROXY_HEADERS       3               /* Reading the response headers */
+#define PROXY_BODY          4               /* Streaming the response body to the client */
+#define PROXY_COMPLETE      5               /* Response complete */
+
+/*
+    Response body chunk decoding states
+ */
+#define PROXY_CHUNK_SIZE    1               /* Expecting a chunk size line */
+#define PROXY_CHUNK_DATA    2               /* Reading chunk data */
+#define PROXY_CHUNK_END     3               /* Expecting the "\r\n" after chunk data */
+#define PROXY_CHUNK_TRAILER 4               /* Reading trailer lines after the last chunk */
+
+/*
+    Idle pooled upstream connection
+ */
+typedef struct Upstream {
+    char        *key;                       /* Upstream "ip:port" */
+    int         sid;                        /* Upstream socket */
+    WebsTime    idle;                       /* Time the connection was returned to the pool */
+} Upstream;
+
+/*
+    Per-request proxy state
+ */
+typedef struct Proxy {
+    Webs        *wp;                        /* Client request */
+    char        *key;                       /* Upstream "ip:port" */
+    char        *ip;                        /* Upstream IP address or hostname */
+    int         port;                       /* Upstream port */
+    int         sid;                        /* Upstream socket */
+    int         state;                      /* Request state */
+    int         chunkState;                 /* Response chunk decoding state */
+    int         reused;                     /* Upstream connection came from the pool */
+    int         keepAlive;                  /* Upstream connection may be pooled after the response */
+    int         pushing;                    /* Writing response data to the client */
+    int         fd;                         /* PUT body file to forward */
+    int         chunked;                    /* Request body is chunk encoded to the upstream */
+    int         bodyDone;                   /* Request body has been fully received */
+    int         resend;                     /* Request can be resent if a pooled connection fails */
+    ssize       chunkLeft;                  /* Request body data remaining in the current upstream chunk */
+    Offset      remaining;                  /* Remaining response body or chunk data. -1 if read till close */
+    WebsBuf     tx;                         /* Request headers and body chunk framing to write to the upstream */
+    WebsBuf     rx;                         /* Response data read from the upstream */
+} Proxy;
+
+/************************************ Locals **********************************/
+
+static Upstream **pool;                     /* Idle upstream connections */
+static int      poolMax;
+static int      poolCount;
+static int      pruneId = -1;
+static int      proxyRoutes;                /* Number of proxy routes */
+static int      nested;                     /* Running inside websPump or the client writable event */
+
+/*
+    Headers that apply only to a single connection and must not be forwarded. Headers named by the Connection header
+    are also not forwarded.
+ */
+static char *hopHeaders[] = {
+    "connection", "keep-alive", "proxy-authenticate", "proxy-authorization", "proxy-connection", "te", "trailer",
+    "trailers", "transfer-encoding", "upgrade", 0
+};
+
+/********************************** Forwards **********************************/
+
+static void abortProxy(Proxy *p, int status, char *msg);
+static int connectUpstream(Proxy *p);
+static void finishProxy(Proxy *p);
+static void freeProxy(Proxy *p);
+static char *getConnectionTokens(char *headers);
+static int getIdle(char *key);
+static void idleEvent(int sid, int mask, void *data);
+static bool isHopHeader(char *key, char *connection);
+static int parseResponse(Proxy *p);
+static void proxyEvent(int sid, int mask, void *data);
+static void pruneIdle(void *data, int id);
+static int pushResponse(Proxy *p);
+static void putIdle(char *key, int sid);
+static void readUpstream(Proxy *p);
+static void releaseUpstream(Proxy *p, int reuse);
+static void removeIdle(int index, int close);
+static void resumeProxy(Webs *wp);
+static int startProxy(Webs *wp, WebsRoute *route, bool streaming);
+static int writeUpstream(Proxy *p);
+
+/************************************* Code ***********************************/
+/*
+    Forward the request to the route's upstream server. Returns 1 always to indicate it handled the URL.
+ */
+static bool proxyHandler(Webs *wp)
+{
+    Proxy   *p;
+
+    assert(websValid(wp));
+
+    if ((p = wp->proxy) != 0) {
+        /* Started by websOpenProxyBody and the body has now been received. The caller pumps the request. */
+        p->bodyDone = 1;
+        websPauseInput(wp, 0);
+        if (p->state == PROXY_SENDING) {
+            nested = 1;
+            writeUpstream(p);
+            nested = 0;
+        }
+        return 1;
+    }
+    if (!wp->route || !wp->route->proxy) {
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Missing proxy target for route");
+        return 1;
+    }
+    startProxy(wp, wp->route, 0);
+    return 1;
+}
+
+
+PUBLIC int websOpenProxyBody(Webs *wp, WebsRoute *route)
+{
+    assert(websValid(wp));
+    assert(route);
+
+    if (route->handler->service != proxyHandler) {
+        return 0;
+    }
+#if BIT_GOAHEAD_AUTH
+    if (route->authType || route->abilities >= 0) {
+        if (wp->route != route || !(wp->flags & WEBS_AUTHORIZED)) {
+            /* Authorized for an earlier route only. Receive the body and authorize when routed. */
+            return 0;
+        }
+    }
+#endif
+    return startProxy(wp, route, 1) < 0 ? -1 : 1;
+}
+
+
+/*
+    Create the proxy state, compose the upstream request headers and connect to the upstream. If streaming, the
+    request body has not been received and is written to the upstream as it arrives. Returns -1 on errors after
+    responding to the client.
+ */
+static int startProxy(Webs *wp, WebsRoute *route, bool streaming)
+{
+    Proxy       *p;
+    char        *address, *path, *cp, *key, *value, *line, *tok, *uri, *forwarded, *connection;
+    Offset      len;
+    int         secure, closing;
+
+    /* A rejected streamed request leaves the body unread, so the connection can't be reused */
+    closing = streaming ? WEBS_CLOSE : 0;
+
+    /*
+        Split the target into the upstream address and an optional path that replaces the route prefix
+     */
+    address = sclone(route->proxy);
+    cp = (cp = strstr(address, "://")) != 0 ? &cp[3] : address;
+    path = 0;
+    if ((cp = strchr(cp, '/')) != 0) {
+        path = sclone(cp);
+        *cp = '\0';
+    }
+    if ((p = walloc(sizeof(Proxy))) == 0) {
+        wfree(address);
+        wfree(path);
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR | closing, "Can't allocate proxy");
+        return -1;
+    }
+    memset(p, 0, sizeof(Proxy));
+    p->wp = wp;
+    p->sid = -1;
+    p->fd = -1;
+    p->resend = 1;
+    socketParseAddress(address, &p->ip, &p->port, &secure, 80);
+    wfree(address);
+    if (secure || !p->ip) {
+        wfree(path);
+        freeProxy(p);
+        websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR | closing, "Unsupported proxy target %s", route->proxy);
+        return -1;
+    }
+    p->key = sfmt("%s:%d", p->ip, p->port);
+    wp->proxy = p;
+
+    if (path) {
+        uri = sfmt("%s%s", path, &wp->url[min(route->prefixLen, slen(wp->url))]);
+        wfree(path);
+    } else {
+        uri = sclone(wp->url);
+    }
+    bufCreate(&p->rx, BIT_GOAHEAD_LIMIT_BUFFER + 1, BIT_GOAHEAD_LIMIT_HEADERS + BIT_GOAHEAD_LIMIT_BUFFER + 1);
+    bufCreate(&p->tx, BIT_GOAHEAD_LIMIT_BUFFER + 1, BIT_GOAHEAD_LIMIT_HEADERS + BIT_GOAHEAD_LIMIT_BUFFER + 1);
+
+    /*
+        Create the upstream request. Forward end-to-end headers and add X-Forwarded headers.
+     */
+    bufPutStr(&p->tx, wp->method);
+    bufPutc(&p->tx, ' ');
+    bufPutStr(&p->tx, *uri ? uri : "/");
+    bufPutStr(&p->tx, " HTTP/1.1\r\n");
+    wfree(uri);
+    if (wp->headers) {
+        connection = getConnectionTokens(wp->headers);
+        for (line = stok(wp->headers, "\r\n", &tok); line; line = stok(NULL, "\r\n", &tok)) {
+            if ((value = strchr(line, ':')) == 0) {
+                continue;
+            }
+            key = line;
+            *value++ = '\0';
+            while (isspace((uchar) *value)) {
+                value++;
+            }
+            if (isHopHeader(key, connection) || scaselessmatch(key, "content-length") || scaselessmatch(key, "expect")) {
+                continue;
+            }
+            bufPutStr(&p->tx, key);
+            bufPutStr(&p->tx, ": ");
+            bufPutStr(&p->tx, value);
+            bufPutStr(&p->tx, "\r\n");
+        }
+        wfree(connection);
+        wfree(wp->headers);
+        wp->headers = 0;
+    }
+    if ((forwarded = websGetVar(wp, "HTTP_X_FORWARDED_FOR", 0)) != 0) {
+        value = sfmt("X-Forwarded-For: %s, %s\r\n", forwarded, wp->ipaddr);
+    } else {
+        value = sfmt("X-Forwarded-For: %s\r\n", wp->ipaddr);
+    }
+    bufPutStr(&p->tx, value);
+    wfree(value);
+    bufPutStr(&p->tx, (wp->flags & WEBS_SECURE) ? "X-Forwarded-Proto: https\r\n" : "X-Forwarded-Proto: http\r\n");
+    bufPutStr(&p->tx, "Connection: keep-alive\r\n");
+
+    /*
+        A streamed body has the client's length or is chunk encoded if the client length is not known. Otherwise the
+        body has already been received. PUT bodies are in a temp file, others are in the input buffer.
+     */
+    if (streaming) {
+        len = wp->rxLen;
+        p->chunked = (wp->rxChunkState != WEBS_CHUNK_UNCHUNKED);
+    } else {
+        len = bufLen(&wp->input);
+        p->bodyDone = 1;
+#if !BIT_ROM
+        if (wp->putfd >= 0) {
+            close(wp->putfd);
+            wp->putfd = -1;
+            if ((p->fd = open(wp->putname, O_RDONLY | O_BINARY, 0)) < 0) {
+                freeProxy(p);
+                websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't open PUT body");
+                return -1;
+            }
+            /* Prevent the PUT body from being renamed into the documents */
+            unlink(wp->putname);
+            len = wp->putLen;
+        }
+#endif
+    }
+    if (p->chunked) {
+        bufPutStr(&p->tx, "Transfer-Encoding: chunked\r\n");
+    } else if (len > 0 || !(smatch(wp->method, "GET") || smatch(wp->method, "HEAD"))) {
+        value = sfmt("Content-Length: %Ld\r\n", len);
+        bufPutStr(&p->tx, value);
+        wfree(value);
+    }
+    bufPutStr(&p->tx, "\r\n");
+    bufAddNull(&p->tx);
+    if (connectUpstream(p) < 0) {
+        freeProxy(p);
+        websError(wp, HTTP_CODE_BAD_GATEWAY | closing, "Can't connect to upstream server");
+        return -1;
+    }
+    return 0;
+}
+
+
+/*
+    Forward request body data received from the client. Called by websPump as body data is added to the input buffer
+    before the request is routed. Reading from the client is paused while too much of the body is waiting for the
+    upstream. Returns -1 if the proxy was aborted.
+ */
+PUBLIC int websProcessProxyData(Webs *wp)
+{
+    Proxy   *p;
+    int     rc;
+
+    if ((p = wp->proxy) == 0) {
+        return 0;
+    }
+    if (p->state == PROXY_SENDING) {
+        nested = 1;
+        rc = writeUpstream(p);
+        nested = 0;
+        if (rc < 0) {
+            return -1;
+        }
+    }
+    if (bufLen(&wp->input) >= PROXY_MAX_INPUT) {
+        websPauseInput(wp, 1);
+    }
+    return 0;
+}
+
+
+/*
+    Use a pooled connection to the upstream if available, otherwise initiate a new connection
+ */
+static int connectUpstream(Proxy *p)
+{
+    if ((p->sid = getIdle(p->key)) >= 0) {
+        p->reused = 1;
+        p->state = PROXY_SENDING;
+    } else {
+        p->reused = 0;
+        if ((p->sid = socketConnect(p->ip, p->port, 0)) < 0) {
+            return -1;
+        }
+        p->state = (socketPtr(p->sid)->flags & SOCKET_CONNECTING) ? PROXY_CONNECTING : PROXY_SENDING;
+    }
+    trace(5, "proxy: %s connection to %s", p->reused ? "reuse" : "new", p->key);
+    socketCreateHandler(p->sid, SOCKET_WRITABLE, proxyEvent, p);
+    return 0;
+}
+
+
+static void proxyEvent(int sid, int mask, void *data)
+{
+    Proxy   *p;
+
+    p = (Proxy*) data;
+    assert(p && p->sid == sid);
+
+    websNoteRequestActivity(p->wp);
+    if (p->state == PROXY_CONNECTING && (mask & SOCKET_WRITABLE)) {
+        if (socketConnected(sid) != 0) {
+            abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Can't connect to upstream server");
+            return;
+        }
+        p->state = PROXY_SENDING;
+    }
+    if (p->state == PROXY_SENDING && (mask & SOCKET_WRITABLE)) {
+        if (writeUpstream(p) < 0) {
+            return;
+        }
+    }
+    if (p->state >= PROXY_HEADERS && (mask & SOCKET_READABLE)) {
+        readUpstream(p);
+    }
+}
+
+
+/*
+    Write the request to the upstream. Request body data is written directly from the client input buffer as it is
+    received. If the upstream is not accepting data, wait for it to become writable. Reading from the client resumes
+    once the buffered body has drained. Return -1 if the proxy was aborted.
+ */
+static int writeUpstream(Proxy *p)
+{
+    Webs        *wp;
+    WebsBuf     *tx, *input;
+    char        *buf, header[24];
+    ssize       len, nbytes;
+
+    wp = p->wp;
+    tx = &p->tx;
+    input = &wp->input;
+
+    while (1) {
+        if (bufLen(tx) > 0) {
+            buf = tx->servp;
+            len = bufLen(tx);
+        } else if (bufLen(input) > 0) {
+            if (p->chunked && p->chunkLeft == 0) {
+                fmt(header, sizeof(header), "%x\r\n", (int) bufLen(input));
+                bufFlush(tx);
+                bufPutStr(tx, header);
+                p->chunkLeft = bufLen(input);
+                p->resend = 0;
+                continue;
+            }
+            buf = input->servp;
+            len = p->chunked ? min(bufLen(input), p->chunkLeft) : bufLen(input);
+#if !BIT_ROM
+        } else if (p->fd >= 0) {
+            bufFlush(tx);
+            p->resend = 0;
+            if ((nbytes = read(p->fd, tx->endp, (uint) bufRoom(tx))) < 0) {
+                abortProxy(p, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't read PUT body");
+                return -1;
+            } else if (nbytes > 0) {
+                bufAdjustEnd(tx, nbytes);
+            } else {
+                close(p->fd);
+                p->fd = -1;
+            }
+            continue;
+#endif
+        } else if (!p->bodyDone) {
+            /* Wait for more of the body */
+            socketRegisterInterest(p->sid, 0);
+            websPauseInput(wp, 0);
+            return 0;
+        } else if (p->chunked) {
+            bufFlush(tx);
+            bufPutStr(tx, "0\r\n\r\n");
+            p->chunked = 0;
+            p->resend = 0;
+            continue;
+        } else {
+            p->state = PROXY_HEADERS;
+            socketRegisterInterest(p->sid, SOCKET_READABLE);
+            return 0;
+        }
+        if ((nbytes = socketWrite(p->sid, buf, len)) < 0) {
+            if (p->reused && p->resend) {
+                /* The pooled connection was closed by the upstream. Retry once with a new connection. */
+                releaseUpstream(p, 0);
+                tx->servp = tx->buf;
+                if (connectUpstream(p) == 0) {
+                    return 0;
+                }
+            }
+            abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Can't write to upstream server");
+            return -1;
+        }
+        if (buf == tx->servp) {
+            /* Don't compact so the headers can be resent if a pooled connection fails */
+            tx->servp += nbytes;
+        } else if (nbytes > 0) {
+            websConsumeInput(wp, nbytes);
+            p->resend = 0;
+            if (p->chunked && (p->chunkLeft -= nbytes) == 0) {
+                bufFlush(tx);
+                bufPutStr(tx, "\r\n");
+            }
+        }
+        if (nbytes < len) {
+            /* Upstream is not accepting more data. Resume when writable. */
+            socketRegisterInterest(p->sid, SOCKET_WRITABLE);
+            return 0;
+        }
+    }
+}
+
+
+static void readUpstream(Proxy *p)
+{
+    WebsBuf     *rx;
+    ssize       nbytes;
+    int         rc;
+
+    rx = &p->rx;
+    while (p->state < PROXY_COMPLETE) {
+        if (bufRoom(rx) < BIT_GOAHEAD_LIMIT_BUFFER) {
+            bufCompact(rx);
+            if (bufRoom(rx) < BIT_GOAHEAD_LIMIT_BUFFER && !bufGrow(rx, 0)) {
+                if (p->state == PROXY_HEADERS) {
+                    abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Upstream response headers too large");
+                    return;
+                }
+                /* Buffer full. Wait for the client to consume data */
+                break;
+            }
+        }
+        if ((nbytes = socketRead(p->sid, rx->endp, bufRoom(rx) - 1)) < 0) {
+            if (p->state == PROXY_HEADERS && bufLen(rx) == 0 && p->reused && p->resend) {
+                /* Pooled connection closed by the upstream before responding. Retry with a new connection. */
+                releaseUpstream(p, 0);
+                p->tx.servp = p->tx.buf;
+                if (connectUpstream(p) == 0) {
+                    return;
+                }
+                abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Can't connect to upstream server");
+
+            } else if (p->state == PROXY_BODY && p->remaining < 0 && !p->chunkState) {
+                /* Response body delimited by the connection close */
+                p->keepAlive = 0;
+                p->state = PROXY_COMPLETE;
+                break;
+            } else {
+                abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Upstream connection lost");
+            }
+            return;
+
+        } else if (nbytes == 0) {
+            break;
+        }
+        bufAdjustEnd(rx, nbytes);
+        bufAddNull(rx);
+
+        if (p->state == PROXY_HEADERS) {
+            if (parseResponse(p) < 0) {
+                return;
+            }
+        }
+        if (p->state == PROXY_BODY) {
+            if ((rc = pushResponse(p)) < 0) {
+                return;
+            } else if (rc == 0 && p->state != PROXY_COMPLETE) {
+                /* Paused until the client output drains */
+                return;
+            }
+        }
+    }
+    if (p->state == PROXY_COMPLETE) {
+        finishProxy(p);
+    }
+}
+
+
+/*
+    Parse the upstream response status and headers and write the response headers to the client.
+    Returns -1 if the proxy was aborted.
+ */
+static int parseResponse(Proxy *p)
+{
+    Webs        *wp;
+    WebsBuf     *rx, headers;
+    char        *end, *line, *key, *value, *tok, *proto, *connection;
+    ssize       length;
+    int         status;
+
+    wp = p->wp;
+    rx = &p->rx;
+
+    if ((end = strstr(rx->servp, "\r\n\r\n")) == 0) {
+        return 0;
+    }
+    *end = '\0';
+    trace(3 | WEBS_RAW_MSG, "\n<<< Proxy response\n%s\n", rx->servp);
+    line = stok(rx->servp, "\r\n", &tok);
+    proto = stok(line, " \t", &value);
+    status = value ? atoi(value) : 0;
+    if (!proto || sncaselesscmp(proto, "HTTP/1.", 7) != 0 || status < 100) {
+        abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Bad upstream response");
+        return -1;
+    }
+    p->keepAlive = scaselessmatch(proto, "HTTP/1.1");
+    p->remaining = -1;
+    p->chunkState = 0;
+    bufCreate(&headers, BIT_GOAHEAD_LIMIT_BUFFER, BIT_GOAHEAD_LIMIT_HEADERS);
+    connection = getConnectionTokens(tok);
+
+    for (line = stok(NULL, "\r\n", &tok); line; line = stok(NULL, "\r\n", &tok)) {
+        if ((value = strchr(line, ':')) == 0) {
+            continue;
+        }
+        key = line;
+        *value++ = '\0';
+        while (isspace((uchar) *value)) {
+            value++;
+        }
+        if (scaselessmatch(key, "content-length")) {
+            p->remaining = stoi(value);
+        } else if (scaselessmatch(key, "transfer-encoding")) {
+            if (scaselessmatch(value, "chunked")) {
+                p->chunkState = PROXY_CHUNK_SIZE;
+            }
+        } else if (scaselessmatch(key, "connection")) {
+            if (scaselessmatch(value, "close")) {
+                p->keepAlive = 0;
+            } else if (scaselessmatch(value, "keep-alive")) {
+                p->keepAlive = 1;
+            }
+        } else if (!isHopHeader(key, connection) && !scaselessmatch(key, "server") && !scaselessmatch(key, "date")) {
+            bufPutStr(&headers, key);
+            bufPutStr(&headers, ": ");
+            bufPutStr(&headers, value);
+            bufPutStr(&headers, "\r\n");
+        }
+    }
+    wfree(connection);
+    bufAdjustStart(rx, end - rx->servp + 4);
+
+    if (status < 200) {
+        /* Ignore interim responses */
+        bufFree(&headers);
+        return bufLen(rx) > 0 ? parseResponse(p) : 0;
+    }
+    if (p->chunkState) {
+        p->remaining = 0;
+    }
+    if (smatch(wp->method, "HEAD") || status == HTTP_CODE_NO_CONTENT || status == HTTP_CODE_NOT_MODIFIED) {
+        length = max(p->remaining, 0);
+        p->remaining = 0;
+        p->chunkState = 0;
+    } else {
+        length = p->chunkState ? -1 : p->remaining;
+        if (length < 0 && !p->chunkState) {
+            /* Body is delimited by the upstream closing the connection */
+            p->keepAlive = 0;
+        }
+    }
+    /*
+        The mime type is defined by the upstream, so clear the extension to prevent a default Content-Type
+     */
+    wfree(wp->ext);
+    wp->ext = 0;
+    websSetStatus(wp, status);
+    websWriteHeaders(wp, length, 0);
+    websWriteBlock(wp, bufStart(&headers), bufLen(&headers));
+    websWriteEndHeaders(wp);
+    bufFree(&headers);
+
+    p->state = (p->remaining == 0 && !p->chunkState) ? PROXY_COMPLETE : PROXY_BODY;
+    return 0;
+}
+
+
+/*
+    Write buffered response data to the client. Pause reading from the upstream if the client is not keeping up.
+    Returns 1 if more data can be read from the upstream, 0 if paused or complete and -1 if the proxy was aborted.
+ */
+static int pushResponse(Proxy *p)
+{
+    Webs        *wp;
+    WebsBuf     *rx;
+    WebsSocket  *sp;
+    char        *cp;
+    ssize       len, written;
+
+    wp = p->wp;
+    rx = &p->rx;
+    p->pushing = 1;
+
+    while (bufLen(rx) > 0 && p->state == PROXY_BODY && wp->state < WEBS_COMPLETE) {
+        if (p->chunkState == PROXY_CHUNK_SIZE || p->chunkState == PROXY_CHUNK_TRAILER) {
+            if ((cp = strstr(rx->servp, "\r\n")) == 0) {
+                if (bufLen(rx) > PROXY_MAX_LINE) {
+                    abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Bad upstream chunk");
+                    return -1;
+                }
+                break;
+            }
+            if (p->chunkState == PROXY_CHUNK_SIZE) {
+                if (!isxdigit((uchar) *rx->servp)) {
+                    abortProxy(p, HTTP_CODE_BAD_GATEWAY, "Bad upstream chunk");
+                    return -1;
+                }
+                p->remaining = hextoi(rx->servp);
+                p->chunkState = (p->remaining > 0) ? PROXY_CHUNK_DATA : PROXY_CHUNK_TRAILER;
+            } else if (cp == rx->servp) {
+                /* Empty line terminates the trailer */
+                p->state = PROXY_COMPLETE;
+            }
+            bufAdjustStart(rx, cp - rx->servp + 2);
+
+        } else if (p->chunkState == PROXY_CHUNK_END) {
+            if (bufLen(rx) < 2) {
+                break;
+            }
+            bufAdjustStart(rx, 2);
+            p->chunkState = PROXY_CHUNK_SIZE;
+
+        } else {
+            len = bufLen(rx);
+            if (p->remaining >= 0) {
+                len = min(len, p->remaining);
+            }
+            written = websWriteBlock(wp, rx->servp, len);
+            bufAdjustStart(rx, written);
+            if (p->remaining >= 0) {
+                p->remaining -= written;
+                if (p->remaining == 0) {
+                    if (p->chunkState) {
+                        p->chunkState = PROXY_CHUNK_END;
+                    } else {
+                        p->state = PROXY_COMPLETE;
+                    }
+                }
+            }
+            if (written < len) {
+                break;
+            }
+        }
+    }
+    if (wp->state >= WEBS_COMPLETE) {
+        /* Client connection failed */
+        abortProxy(p, 0, 0);
+        return -1;
+    }
+    if (p->state == PROXY_COMPLETE) {
+        p->pushing = 0;
+        if (bufLen(rx) > 0) {
+            /* Unexpected extra data. Don't reuse the connection. */
+            p->keepAlive = 0;
+        }
+        return 0;
+    }
+    if (bufLen(rx) > 0 || !websFlush(wp)) {
+        /*
+            Apply backpressure. Stop reading from the upstream until the client output has drained.
+            The pushing flag prevents websSetBackgroundWriter from recursing into resumeProxy.
+         */
+        socketRegisterInterest(p->sid, 0);
+        if (wp->writeData != resumeProxy) {
+            websSetBackgroundWriter(wp, resumeProxy);
+        }
+        p->pushing = 0;
+        return 0;
+    }
+    p->pushing = 0;
+    socketRegisterInterest(p->sid, SOCKET_READABLE);
+    if (wp->writeData == resumeProxy && (sp = socketPtr(wp->sid)) != 0) {
+        wp->writeData = 0;
+        socketRegisterInterest(wp->sid, sp->handlerMask & ~SOCKET_WRITABLE);
+    }
+    return 1;
+}
+
+
+/*
+    Client output has drained. Push pending response data and resume reading from the upstream.
+ */
+static void resumeProxy(Webs *wp)
+{
+    Proxy   *p;
+
+    if ((p = wp->proxy) == 0 || p->pushing) {
+        return;
+    }
+    /* The client writable event will pump and free the request as required */
+    nested = 1;
+    if (pushResponse(p) >= 0 && p->state == PROXY_COMPLETE) {
+        finishProxy(p);
+    }
+    nested = 0;
+}
+
+
+/*
+    The response has been fully received. Return the upstream connection to the pool and complete the request.
+ */
+static void finishProxy(Proxy *p)
+{
+    Webs    *wp;
+
+    wp = p->wp;
+    releaseUpstream(p, p->keepAlive && bufLen(&p->rx) == 0);
+    freeProxy(p);
+    websDone(wp);
+    if (!nested) {
+        websPump(wp);
+        if (wp->flags & WEBS_CLOSED) {
+            websFree(wp);
+        }
+    }
+}
+
+
+/*
+    Abort the proxy request. If the response headers have not been written, respond with an error status. Otherwise,
+    close the client connection so the client can detect the truncated response.
+ */
+static void abortProxy(Proxy *p, int status, char *msg)
+{
+    Webs    *wp;
+
+    wp = p->wp;
+    if (msg) {
+        trace(2, "proxy: %s, upstream %s", msg, p->key);
+    }
+    if (!p->bodyDone) {
+        /* The rest of the request body will not be read */
+        wp->flags &= ~WEBS_KEEP_ALIVE;
+    }
+    releaseUpstream(p, 0);
+    freeProxy(p);
+    if (status && !(wp->flags & WEBS_HEADERS_CREATED)) {
+        websError(wp, status, "%s", msg);
+    } else {
+        wp->flags &= ~WEBS_KEEP_ALIVE;
+        wp->flags |= WEBS_FINALIZED;
+        bufFlush(&wp->output);
+        bufFlush(&wp->chunkbuf);
+        wp->state = WEBS_COMPLETE;
+    }
+    if (!nested) {
+        websPump(wp);
+        if (wp->flags & WEBS_CLOSED) {
+            websFree(wp);
+        }
+    }
+}
+
+
+static void releaseUpstream(Proxy *p, int reuse)
+{
+    if (p->sid >= 0) {
+        if (reuse) {
+            putIdle(p->key, p->sid);
+        } else {
+            socketDeleteHandler(p->sid);
+            socketCloseConnection(p->sid);
+        }
+        p->sid = -1;
+    }
+}
+
+
+static void freeProxy(Proxy *p)
+{
+    Webs    *wp;
+
+    wp = p->wp;
+    if (wp->proxy == p) {
+        wp->proxy = 0;
+        if (wp->writeData == resumeProxy) {
+            wp->writeData = 0;
+        }
+    }
+    if (p->fd >= 0) {
+        close(p->fd);
+    }
+    bufFree(&p->rx);
+    bufFree(&p->tx);
+    wfree(p->key);
+    wfree(p->ip);
+    wfree(p);
+}
+
+
+/*
+    Called when a request is freed. Close any upstream connection as the response is incomplete.
+ */
+PUBLIC void websFreeProxy(Webs *wp)
+{
+    Proxy   *p;
+
+    if ((p = wp->proxy) != 0) {
+        releaseUpstream(p, 0);
+        freeProxy(p);
+    }
+    wfree(wp->headers);
+    wp->headers = 0;
+}
+
+
+/*
+    Return the tokens of all Connection headers as a comma separated list. Returns null if there are none.
+    Caller must free.
+ */
+static char *getConnectionTokens(char *headers)
+{
+    WebsBuf     buf;
+    char        *line, *next, *tokens;
+
+    if (headers == 0) {
+        return 0;
+    }
+    bufCreate(&buf, BIT_GOAHEAD_LIMIT_BUFFER, BIT_GOAHEAD_LIMIT_HEADERS);
+    for (line = headers; *line; line = next) {
+        if ((next = strchr(line, '\n')) != 0) {
+            next++;
+        } else {
+            next = &line[slen(line)];
+        }
+        if (sncaselesscmp(line, "connection:", 11) == 0) {
+            bufPutBlk(&buf, &line[11], next - &line[11]);
+            bufPutc(&buf, ',');
+        }
+    }
+    bufAddNull(&buf);
+    tokens = bufLen(&buf) > 0 ? sclone(buf.servp) : 0;
+    bufFree(&buf);
+    return tokens;
+}
+
+
+/*
+    Test if a header applies only to a single connection. The connection argument holds the Connection header tokens.
+ */
+static bool isHopHeader(char *key, char *connection)
+{
+    char    **hp, *cp, *end;
+    ssize   len;
+
+    for (hp = hopHeaders; *hp; hp++) {
+        if (scaselessmatch(key, *hp)) {
+            return 1;
+        }
+    }
+    if (connection) {
+        len = slen(key);
+        for (cp = connection; *cp; cp = end) {
+            while (*cp == ',' || isspace((uchar) *cp)) {
+                cp++;
+            }
+            for (end = cp; *end && *end != ',' && !isspace((uchar) *end); end++) { }
+            if ((end - cp) == len && sncaselesscmp(cp, key, len) == 0) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Take an idle connection to the upstream from the pool. Connections closed by the upstream are discarded.
+    Entries are removed after the walk as removing an entry may free the pool.
+ */
+static int getIdle(char *key)
+{
+    Upstream    *up;
+    int         closed[PROXY_MAX_IDLE], i, index, nclosed, sid;
+
+    index = sid = -1;
+    nclosed = 0;
+    for (i = 0; i < poolMax && index < 0; i++) {
+        if ((up = pool[i]) != 0 && smatch(up->key, key)) {
+            if (socketEof(up->sid)) {
+                closed[nclosed++] = i;
+            } else {
+                index = i;
+                sid = up->sid;
+            }
+        }
+    }
+    for (i = 0; i < nclosed; i++) {
+        removeIdle(closed[i], 1);
+    }
+    if (index >= 0) {
+        removeIdle(index, 0);
+    }
+    return sid;
+}
+
+
+/*
+    Return a connection to the pool. Idle connections are monitored for the upstream closing the connection.
+ */
+static void putIdle(char *key, int sid)
+{
+    Upstream    *up;
+    int         id;
+
+    if (poolCount >= PROXY_MAX_IDLE || (id = wallocObject(&pool, &poolMax, sizeof(Upstream))) < 0) {
+        socketDeleteHandler(sid);
+        socketCloseConnection(sid);
+        return;
+    }
+    up = pool[id];
+    up->key = sclone(key);
+    up->sid = sid;
+    up->idle = time(0);
+    poolCount++;
+    socketCreateHandler(sid, SOCKET_READABLE, idleEvent, up);
+    if (pruneId < 0) {
+        pruneId = websStartEvent(PROXY_IDLE_TIMEOUT, pruneIdle, 0);
+    }
+}
+
+
+static void removeIdle(int index, int close)
+{
+    Upstream    *up;
+
+    up = pool[index];
+    socketDeleteHandler(up->sid);
+    if (close) {
+        socketCloseConnection(up->sid);
+    }
+    wfree(up->key);
+    wfree(up);
+    poolMax = wfreeHandle(&pool, index);
+    poolCount--;
+}
+
+
+/*
+    An idle upstream connection is readable. The upstream has closed the connection or sent unsolicited data.
+ */
+static void idleEvent(int sid, int mask, void *data)
+{
+    int     i;
+
+    for (i = 0; i < poolMax; i++) {
+        if (pool[i] == data) {
+            removeIdle(i, 1);
+            break;
+        }
+    }
+}
+
+
+static void pruneIdle(void *data, int id)
+{
+    Upstream    *up;
+    WebsTime    when;
+    int         expired[PROXY_MAX_IDLE], i, nexpired;
+
+    when = time(0) - (PROXY_IDLE_TIMEOUT / 1000);
+    nexpired = 0;
+    for (i = 0; i < poolMax; i++) {
+        if ((up = pool[i]) != 0 && up->idle <= when) {
+            expired[nexpired++] = i;
+        }
+    }
+    for (i = 0; i < nexpired; i++) {
+        removeIdle(expired[i], 1);
+    }
+    if (poolCount > 0) {
+        websRestartEvent(id, PROXY_IDLE_TIMEOUT);
+    } else {
+        websStopEvent(id);
+        pruneId = -1;
+    }
+}
+
+
+/*
+    Set the upstream target for a proxy route
+ */
+PUBLIC int websSetRouteProxy(WebsRoute *route, char *target)
+{
+    assert(route);
+    assert(target && *target);
+
+    if (strncmp(target, "http://", 7) != 0) {
+        error("Proxy target must be an http:// URL: %s", target);
+        return -1;
+    }
+    wfree(route->proxy);
+    route->proxy = sclone(target);
+    proxyRoutes++;
+    return 0;
+}
+
+
+/*
+    Return true if any routes use the proxy handler. Request headers are only preserved for forwarding if so.
+ */
+PUBLIC bool websProxyEnabled()
+{
+    return proxyRoutes > 0;
+}
+
+
+static void closeProxy()
+{
+    int     active[PROXY_MAX_IDLE], i, nactive;
+
+    nactive = 0;
+    for (i = 0; i < poolMax; i++) {
+        if (pool[i]) {
+            active[nactive++] = i;
+        }
+    }
+    for (i = 0; i < nactive; i++) {
+        removeIdle(active[i], 1);
+    }
+    if (pruneId >= 0) {
+        websStopEvent(pruneId);
+        pruneId = -1;
+    }
+    wfree(pool);
+    pool = 0;
+    poolMax = poolCount = proxyRoutes = 0;
+}
+
+
+PUBLIC int websProxyOpen()
+{
+    websDefineHandler("proxy", proxyHandler, closeProxy, 0);
+    return 0;
+}
+
+#endif /* BIT_GOAHEAD_PROXY */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+ */
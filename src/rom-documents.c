@@ -9,6 +9,12 @@
 WebsRomIndex websRomIndex[] = {
 	{ 0, 0, 0 }
 };
+
+int websRomHashSize = 0;
+int websRomHashBuckets = 0;
+
+ushort websRomHashSeeds[] = { 0 };
+short websRomHash[] = { -1 };
 #else
 WebsRomIndex websRomIndex[] = {
 	{ 0, 0, 0 }
@@ -27,10 +27,17 @@ static int routeMax = 0;
 
 /********************************** Forwards **********************************/
 
+#if BIT_GOAHEAD_AUTH
+static bool authorizeRoute(Webs *wp, WebsRoute *route);
+#endif
 static bool continueHandler(Webs *wp);
 static void freeRoute(WebsRoute *route);
 static void growRoutes();
 static int lookupRoute(char *uri);
+static bool matchRoute(Webs *wp, WebsRoute *route, ssize plen, bool safeMethod);
+#if BIT_GOAHEAD_CACHE
+static int parseLifespan(char *value);
+#endif
 static bool redirectHandler(Webs *wp);
 
 /************************************ Code ************************************/
@@ -38,7 +45,7 @@ static bool redirectHandler(Webs *wp);
 PUBLIC void websRouteRequest(Webs *wp)
 {
     WebsRoute   *route;
-    ssize       plen, len;
+    ssize       plen;
     bool        safeMethod;
     char        *documents;
     int         i, count;
@@ -55,52 +62,23 @@ PUBLIC void websRouteRequest(Webs *wp)
 
     for (count = 0, i = 0; i < routeCount; i++) {
         route = routes[i];
-        assert(route->prefix && route->prefixLen > 0);
-
-        if (plen < route->prefixLen) continue;
-        len = min(route->prefixLen, plen);
-        trace(5, "Examine route %s", route->prefix);
-        /*
-            Match route
-         */
-        if (route->protocol && !smatch(route->protocol, wp->protocol)) {
-            trace(5, "Route %s does not match protocol %s", route->prefix, wp->protocol);
-            continue;
-        }
-        if (route->methods >= 0) {
-            if (!hashLookup(route->methods, wp->method)) {
-                trace(5, "Route %s doesnt match method %s", route->prefix, wp->method);
-                continue;
-            }
-        } else if (!safeMethod) {
-            continue;
-        }
-        if (route->extensions >= 0 && (wp->ext == 0 || !hashLookup(route->extensions, &wp->ext[1]))) {
-            trace(5, "Route %s doesn match extension %s", route->prefix, wp->ext ? wp->ext : "");
-            continue;
-        }
-        if (strncmp(wp->path, route->prefix, len) == 0) {
-            wp->route = route;
+        if (matchRoute(wp, route, plen, safeMethod)) {
 #if BIT_GOAHEAD_AUTH
-            if (route->authType && !websAuthenticate(wp)) {
-                return;
-            }
-            if (route->abilities >= 0 && !websCan(wp, route->abilities)) {
+            if (!authorizeRoute(wp, route)) {
                 return;
             }
 #endif
+            wp->route = route;
             if (!wp->filename || route->dir) {
                 wfree(wp->filename);
                 wp->filename = sfmt("%s%s", route->dir ? route->dir : documents, wp->path);
+#if BIT_GOAHEAD_OPENAT
+                wp->docdir = websGetDirFd(route->dir ? route->dir : documents);
+#endif
             }
             if (!(wp->flags & WEBS_VARS_ADDED)) {
-                if (wp->query && *wp->query) {
-                    websSetQueryVars(wp);
-                }
-                if (wp->flags & WEBS_FORM) {
-                    websSetFormVars(wp);
-                }
-                wp->flags |= WEBS_VARS_ADDED;
+                /* Decoded on first use by websParseVars */
+                wp->flags |= WEBS_VARS_ADDED | WEBS_VARS_PENDING;
             }
 #if BIT_GOAHEAD_LEGACY
             if (route->handler->flags & WEBS_LEGACY_HANDLER) {
@@ -112,6 +90,12 @@ PUBLIC void websRouteRequest(Webs *wp)
             assert(route->handler);
             trace(5, "Route %s calls handler %s", route->prefix, route->handler->name);
             wp->state = WEBS_RUNNING;
+#if BIT_GOAHEAD_CACHE
+            if (route->lifespan > 0 && websCacheRequest(wp)) {
+                /* Served from the cache or waiting for another request to fill the cache */
+                return;
+            }
+#endif
             if ((*route->handler->service)(wp)) {                                        
                 /* Handled */
                 return;
@@ -122,7 +106,9 @@ PUBLIC void websRouteRequest(Webs *wp)
                 if (++count >= WEBS_MAX_ROUTE) {
                     break;
                 }
-                i = 0;
+                /* Restart matching from the first route */
+                plen = slen(wp->path);
+                i = -1;
             }
             if (!websValid(wp)) {
                 trace(5, "handler %s called websDone, but didn't return 1", route->handler->name);
@@ -137,6 +123,115 @@ PUBLIC void websRouteRequest(Webs *wp)
 }
 
 
+/*
+    Select and authorize the route for a request without running the handler. This is used to accept or reject a
+    request before the request body is received.
+ */
+PUBLIC bool websCheckRoute(Webs *wp)
+{
+    WebsRoute   *route;
+    ssize       plen;
+    bool        safeMethod;
+    int         i;
+
+    assert(wp);
+    assert(wp->path);
+    assert(wp->method);
+
+    safeMethod = smatch(wp->method, "POST") || smatch(wp->method, "GET") || smatch(wp->method, "HEAD");
+    plen = slen(wp->path);
+
+    for (i = 0; i < routeCount; i++) {
+        route = routes[i];
+        if (matchRoute(wp, route, plen, safeMethod)) {
+#if BIT_GOAHEAD_AUTH
+            return authorizeRoute(wp, route);
+#else
+            return 1;
+#endif
+        }
+    }
+    websError(wp, HTTP_CODE_NOT_ACCEPTABLE, "Can't find suitable route for request.");
+    return 0;
+}
+
+
+PUBLIC WebsRoute *websSelectRoute(Webs *wp)
+{
+    WebsRoute   *route;
+    ssize       plen;
+    bool        safeMethod;
+    int         i;
+
+    assert(wp);
+    assert(wp->path);
+    assert(wp->method);
+
+    safeMethod = smatch(wp->method, "POST") || smatch(wp->method, "GET") || smatch(wp->method, "HEAD");
+    plen = slen(wp->path);
+
+    for (i = 0; i < routeCount; i++) {
+        route = routes[i];
+        if (route->handler->service != continueHandler && matchRoute(wp, route, plen, safeMethod)) {
+            return route;
+        }
+    }
+    return 0;
+}
+
+
+static bool matchRoute(Webs *wp, WebsRoute *route, ssize plen, bool safeMethod)
+{
+    assert(route->prefix && route->prefixLen > 0);
+
+    if (plen < route->prefixLen) {
+        return 0;
+    }
+    trace(5, "Examine route %s", route->prefix);
+    if (route->protocol && !smatch(route->protocol, wp->protocol)) {
+        trace(5, "Route %s does not match protocol %s", route->prefix, wp->protocol);
+        return 0;
+    }
+    if (route->methods >= 0) {
+        if (!hashLookup(route->methods, wp->method)) {
+            trace(5, "Route %s doesnt match method %s", route->prefix, wp->method);
+            return 0;
+        }
+    } else if (!safeMethod) {
+        return 0;
+    }
+    if (route->extensions >= 0 && (wp->ext == 0 || !hashLookup(route->extensions, &wp->ext[1]))) {
+        trace(5, "Route %s doesn match extension %s", route->prefix, wp->ext ? wp->ext : "");
+        return 0;
+    }
+    return strncmp(wp->path, route->prefix, route->prefixLen) == 0;
+}
+
+
+#if BIT_GOAHEAD_AUTH
+/*
+    Authenticate the user and check abilities for a route. Authorization is done once per route so a request checked
+    by websCheckRoute before receiving the body is not authenticated again when routed.
+ */
+static bool authorizeRoute(Webs *wp, WebsRoute *route)
+{
+    if (route == wp->route && (wp->flags & WEBS_AUTHORIZED)) {
+        return 1;
+    }
+    wp->route = route;
+    wp->flags &= ~WEBS_AUTHORIZED;
+    if (route->authType && !websAuthenticate(wp)) {
+        return 0;
+    }
+    if (route->abilities >= 0 && !websCan(wp, route->abilities)) {
+        return 0;
+    }
+    wp->flags |= WEBS_AUTHORIZED;
+    return 1;
+}
+#endif
+
+
 #if BIT_GOAHEAD_AUTH
 static bool can(Webs *wp, char *ability)
 {
@@ -341,6 +436,9 @@ static void freeRoute(WebsRoute *route)
     wfree(route->dir);
     wfree(route->protocol);
     wfree(route->authType);
+#if BIT_GOAHEAD_PROXY
+    wfree(route->proxy);
+#endif
     wfree(route->handler);
     wfree(route);
 }
@@ -441,6 +539,36 @@ static void addOption(WebsHash *hash, char *keys, char *value)
 }
 
 
+#if BIT_GOAHEAD_CACHE
+/*
+    Parse a cache lifespan in seconds with an optional "s", "m" or "h" unit suffix. Returns -1 if invalid.
+ */
+static int parseLifespan(char *value)
+{
+    char    *end;
+    long    lifespan;
+
+    if (value == 0 || !isdigit((uchar) *value)) {
+        return -1;
+    }
+    lifespan = strtol(value, &end, 10);
+    if (*end == 'm') {
+        lifespan *= 60;
+        end++;
+    } else if (*end == 'h') {
+        lifespan *= 60 * 60;
+        end++;
+    } else if (*end == 's') {
+        end++;
+    }
+    if (*end || lifespan < 0 || lifespan > MAXINT) {
+        return -1;
+    }
+    return (int) lifespan;
+}
+#endif
+
+
 /*
     Load route and authentication configuration files
  */
@@ -449,8 +577,11 @@ PUBLIC int websLoad(char *path)
     WebsRoute   *route;
     WebsHash    abilities, extensions, methods, redirects;
     char        *buf, *line, *kind, *next, *auth, *dir, *handler, *protocol, *uri, *option, *key, *value, *status;
-    char        *redirectUri, *token;
-    int         rc;
+    char        *redirectUri, *token, *proxy;
+    int         rc, json, aio;
+#if BIT_GOAHEAD_CACHE
+    int         lifespan;
+#endif
     
     assert(path && *path);
 
@@ -465,20 +596,35 @@ PUBLIC int websLoad(char *path)
             continue;
         }
         if (smatch(kind, "route")) {
-            auth = dir = handler = protocol = uri = 0;
+            auth = dir = handler = protocol = uri = proxy = 0;
+            json = aio = 0;
             abilities = extensions = methods = redirects = -1;
+#if BIT_GOAHEAD_CACHE
+            lifespan = 0;
+#endif
             while ((option = stok(NULL, " \t\r\n", &next)) != 0) {
                 key = stok(option, "=", &value);
                 if (smatch(key, "abilities")) {
                     addOption(&abilities, value, 0);
+                } else if (smatch(key, "aio")) {
+                    aio = smatch(value, "true");
                 } else if (smatch(key, "auth")) {
                     auth = value;
+#if BIT_GOAHEAD_CACHE
+                } else if (smatch(key, "cache")) {
+                    if ((lifespan = parseLifespan(value)) < 0) {
+                        error("Bad route cache lifespan %s", value);
+                        lifespan = 0;
+                    }
+#endif
                 } else if (smatch(key, "dir")) {
                     dir = value;
                 } else if (smatch(key, "extensions")) {
                     addOption(&extensions, value, 0);
                 } else if (smatch(key, "handler")) {
                     handler = value;
+                } else if (smatch(key, "json")) {
+                    json = smatch(value, "true");
                 } else if (smatch(key, "methods")) {
                     addOption(&methods, value, 0);
                 } else if (smatch(key, "redirect")) {
@@ -496,6 +642,10 @@ PUBLIC int websLoad(char *path)
                     addOption(&redirects, status, redirectUri);
                 } else if (smatch(key, "protocol")) {
                     protocol = value;
+#if BIT_GOAHEAD_PROXY
+                } else if (smatch(key, "proxy")) {
+                    proxy = value;
+#endif
                 } else if (smatch(key, "uri")) {
                     uri = value;
                 } else {
@@ -508,6 +658,24 @@ PUBLIC int websLoad(char *path)
                 break;
             }
             websSetRouteMatch(route, dir, protocol, methods, extensions, abilities, redirects);
+#if BIT_GOAHEAD_JSON
+            route->json = json;
+#endif
+#if BIT_GOAHEAD_AIO
+            route->aio = aio;
+#endif
+#if BIT_GOAHEAD_CACHE
+            if (lifespan && websSetRouteCache(route, lifespan) < 0) {
+                rc = -1;
+                break;
+            }
+#endif
+#if BIT_GOAHEAD_PROXY
+            if (proxy && websSetRouteProxy(route, proxy) < 0) {
+                rc = -1;
+                break;
+            }
+#endif
 #if BIT_GOAHEAD_AUTH
             if (auth && websSetRouteAuth(route, auth) < 0) {
                 rc = -1;
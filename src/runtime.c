@@ -2376,6 +2376,33 @@ uint strtoi(char *s)
 }
 
 
+/*
+    Convert a decimal string to a 64 bit integer. Used for content lengths which may exceed 2GB.
+ */
+PUBLIC int64 stoi(char *s)
+{
+    int64   value;
+    int     negative;
+
+    value = 0;
+    negative = 0;
+    while (isspace((uchar) *s)) {
+        s++;
+    }
+    if (*s == '-' || *s == '+') {
+        negative = (*s++ == '-');
+    }
+    for (; isdigit((uchar) *s); s++) {
+        if (value > (MAXINT64 - (*s - '0')) / 10) {
+            value = MAXINT64;
+            break;
+        }
+        value = value * 10 + (*s - '0');
+    }
+    return negative ? -value : value;
+}
+
+
 PUBLIC int scaselesscmp(char *s1, char *s2)
 {
     if (s1 == 0 || s2 == 0) {
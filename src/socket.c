@@ -8,6 +8,13 @@
 
 #include    "goahead.h"
 
+#if BIT_GOAHEAD_IO_URING
+    #include    <linux/io_uring.h>
+    #include    <sys/mman.h>
+    #include    <sys/syscall.h>
+    #include    <poll.h>
+#endif
+
 /************************************ Locals **********************************/
 
 WebsSocket      **socketList;           /* List of open sockets */
@@ -16,11 +23,72 @@ PUBLIC Socket   socketHighestFd = -1;   /* Highest socket fd opened */
 PUBLIC int      socketOpenCount = 0;    /* Number of task using sockets */
 static int      hasIPv6;                /* System supports IPv6 */
 
+/*
+    Socket structures are allocated in slabs of SOCKET_SLAB entries indexed by socket ID. Slabs are not moved or freed
+    while sockets are open, so socketList[sid] pointers remain valid and the event loop scans adjacent memory rather
+    than chasing a separately allocated structure per socket. Free slots have a sid of -1.
+
+    Each slab has a word in socketReady with a bit set for every socket that has received events since the last call
+    to socketProcess. socketProcess only visits those sockets rather than scanning every slot.
+ */
+#define SOCKET_SLAB     64
+
+static WebsSocket **socketSlabs;        /* Slabs of socket structures */
+static uint64   *socketReady;           /* Per-slab bitmap of sockets with pending events */
+static int      socketSlabCount;        /* Number of slabs allocated */
+
+#define socketSlot(sid)     (&socketSlabs[(sid) / SOCKET_SLAB][(sid) % SOCKET_SLAB])
+#define socketSetReady(sid) (socketReady[(sid) / SOCKET_SLAB] |= ((uint64) 1) << ((sid) % SOCKET_SLAB))
+
+#if BIT_GOAHEAD_IO_URING
+/*
+    Size of the submission queue. Polls are batched and submitted in one system call per loop iteration.
+ */
+#define RING_ENTRIES    256
+#define RING_IGNORE     ((uint64) -1)   /* User data for poll removal requests whose completion is ignored */
+
+/*
+    An io_uring instance used to monitor socket readiness. Each socket of interest has a single-shot poll request armed
+    in the ring. Idle sockets remain armed across loop iterations, so unlike select() only sockets whose interest changed
+    or which have fired require work. The ring memory is shared with the kernel.
+ */
+typedef struct Ring {
+    int                 fd;             /* Ring file descriptor or -1 if using select() */
+    uint                seq;            /* Sequence to detect stale completions */
+    uint                queued;         /* Submission entries queued but not yet submitted */
+    uint                *sqHead;
+    uint                *sqTail;
+    uint                *sqMask;
+    uint                *sqArray;
+    uint                *cqHead;
+    uint                *cqTail;
+    uint                *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sqRing;
+    void                *cqRing;
+    size_t              sqRingSize;
+    size_t              cqRingSize;
+    size_t              sqesSize;
+} Ring;
+
+static Ring ring = { -1 };
+#endif
+
 /***************************** Forward Declarations ***************************/
 
+static void freeSlabs();
+static int growSlabs(int sid);
 static int ipv6(char *ip);
 static void socketAccept(WebsSocket *sp);
 static void socketDoEvent(WebsSocket *sp);
+static int tryAlternateConnect(int sock, struct sockaddr *sockaddr);
+#if BIT_GOAHEAD_IO_URING
+static void ringArm(WebsSocket *sp, int mask);
+static void ringClose();
+static int ringOpen();
+static int ringSelect(WebsTime timeout);
+#endif
 
 /*********************************** Code *************************************/
 
@@ -53,6 +121,11 @@ PUBLIC int socketOpen()
     } else {
         trace(1, "This system does not have IPv6 support");
     }
+#if BIT_GOAHEAD_IO_URING
+    if (ringOpen() < 0) {
+        trace(1, "io_uring is not available, using select");
+    }
+#endif
     return 0;
 }
 
@@ -67,6 +140,10 @@ PUBLIC void socketClose()
                 socketCloseConnection(i);
             }
         }
+        freeSlabs();
+#if BIT_GOAHEAD_IO_URING
+        ringClose();
+#endif
         socketOpenCount = 0;
     }
 }
@@ -178,13 +255,12 @@ PUBLIC int socketListen(char *ip, int port, SocketAccept accept, int flags)
 }
 
 
-#if KEEP
 PUBLIC int socketConnect(char *ip, int port, int flags)
 {
-    WebsSocket                *sp;
+    WebsSocket              *sp;
     struct sockaddr_storage addr;
-    socklen_t               addrlen;
-    int                     family, protocol, sid, rc;
+    Socklen                 addrlen;
+    int                     family, protocol, sid, rc, err;
 
     if (port > SOCKET_PORT_MAX) {
         return -1;
@@ -196,9 +272,10 @@ PUBLIC int socketConnect(char *ip, int port, int flags)
     assert(sp);
 
     if (socketInfo(ip, port, &family, &protocol, &addr, &addrlen) < 0) {
+        socketFree(sid);
         return -1;       
     }
-    if ((sp->sock = socket(AF_INET, SOCK_STREAM, 0)) == SOCKET_ERROR) {
+    if ((sp->sock = socket(family, SOCK_STREAM, protocol)) == SOCKET_ERROR) {
         socketFree(sid);
         return -1;
     }
@@ -207,43 +284,58 @@ PUBLIC int socketConnect(char *ip, int port, int flags)
 #if BIT_HAS_FCNTL
     fcntl(sp->sock, F_SETFD, FD_CLOEXEC);
 #endif
-
     /*
-        Connect to the remote server in blocking mode, then go into non-blocking mode if desired.
+        For non-blocking sockets, the connect completes in the background. The socket becomes writable when connected.
      */
-    if (!(sp->flags & SOCKET_BLOCK)) {
+    socketSetBlock(sid, (flags & SOCKET_BLOCK));
+    if ((rc = connect(sp->sock, (struct sockaddr*) &addr, addrlen)) < 0 && 
+        (rc = tryAlternateConnect(sp->sock, (struct sockaddr*) &addr)) < 0) {
+        err = socketGetError();
 #if BIT_WIN_LIKE
-        /*
-            Set to non-blocking for an async connect
-         */
-        int flag = 1;
-        if (ioctlsocket(sp->sock, FIONBIO, &flag) == SOCKET_ERROR) {
-            socketFree(sid);
-            return -1;
-        }
-        sp->flags |= SOCKET_ASYNC;
+        if (err == EWOULDBLOCK) {
 #else
-        socketSetBlock(sid, 1);
+        if (err == EINPROGRESS || err == EWOULDBLOCK) {
 #endif
-    }
-    if ((rc = connect(sp->sock, (struct sockaddr*) &addr, sizeof(addr))) < 0 && 
-        (rc = tryAlternateConnect(sp->sock, (struct sockaddr*) &addr)) < 0) {
-#if BIT_WIN_LIKE
-        if (socketGetError() != EWOULDBLOCK) {
+            sp->flags |= SOCKET_CONNECTING;
+        } else {
             socketFree(sid);
             return -1;
         }
-#else
-        socketFree(sid);
-        return -1;
-
-#endif
     }
-    socketSetBlock(sid, (flags & SOCKET_BLOCK));
+    if (sp->flags & SOCKET_NODELAY) {
+        socketSetNoDelay(sid, 1);
+    }
     return sid;
 }
 
 
+/*
+    Return zero if a non-blocking connect has completed successfully, otherwise return the connect error code.
+ */
+PUBLIC int socketConnected(int sid)
+{
+    WebsSocket  *sp;
+    Socklen     len;
+    int         err;
+
+    if ((sp = socketPtr(sid)) == NULL) {
+        return EBADF;
+    }
+    if (!(sp->flags & SOCKET_CONNECTING)) {
+        return 0;
+    }
+    err = 0;
+    len = sizeof(err);
+    if (getsockopt(sp->sock, SOL_SOCKET, SO_ERROR, (char*) &err, &len) < 0) {
+        return socketGetError();
+    }
+    if (err == 0) {
+        sp->flags &= ~SOCKET_CONNECTING;
+    }
+    return err;
+}
+
+
 /*
     If the connection failed, swap the first two bytes in the sockaddr structure.  This is a kludge due to a change in
     VxWorks between versions 5.3 and 5.4, but we want the product to run on either.
@@ -261,7 +353,6 @@ static int tryAlternateConnect(int sock, struct sockaddr *sockaddr)
     return -1;
 #endif
 }
-#endif
 
 
 PUBLIC void socketCloseConnection(int sid)
@@ -306,11 +397,11 @@ static void socketAccept(WebsSocket *sp)
     /*
         Create a socket structure and insert into the socket list
      */
-    nid = socketAlloc(sp->ip, sp->port, sp->accept, sp->flags);
-    if ((nsp = socketList[nid]) == 0) {
+    if ((nid = socketAlloc(sp->ip, sp->port, sp->accept, sp->flags)) < 0) {
+        closesocket(newSock);
         return;
     }
-    assert(nsp);
+    nsp = socketSlot(nid);
     nsp->sock = newSock;
     nsp->flags &= ~SOCKET_LISTENING;
     socketSetBlock(nid, (nsp->flags & SOCKET_BLOCK));
@@ -417,10 +508,9 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
     }
 
     for (; sid < socketMax; sid++) {
-        if ((sp = socketList[sid]) == NULL) {
+        if ((sp = socketSlot(sid))->sid < 0) {
             continue;
         }
-        assert(sp);
         /*
             Set the appropriate bit in the ready masks for the sp->sock.
          */
@@ -461,7 +551,7 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
         sid = 0;
     }
     for (; sid < socketMax; sid++) {
-        if ((sp = socketList[sid]) == NULL) {
+        if ((sp = socketSlot(sid))->sid < 0) {
             continue;
         }
         if (sp->flags & SOCKET_RESERVICE) {
@@ -482,6 +572,9 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
         if (FD_ISSET(sp->sock, &exceptFds)) {
             sp->currentEvents |= SOCKET_EXCEPTION;
         }
+        if (sp->currentEvents) {
+            socketSetReady(sid);
+        }
         if (! all) {
             break;
         }
@@ -496,9 +589,14 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
 {
     WebsSocket      *sp;
     struct timeval  tv;
-    fd_mask         *readFds, *writeFds, *exceptFds;
-    int             all, len, nwords, index, bit, nEvents;
+    fd_mask         *readFds, *writeFds, *exceptFds, bit;
+    int             all, len, nwords, index, nEvents;
 
+#if BIT_GOAHEAD_IO_URING
+    if (sid < 0 && ring.fd >= 0) {
+        return ringSelect(timeout);
+    }
+#endif
     /*
         Allocate and zero the select masks
      */
@@ -526,19 +624,18 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
     }
 
     for (; sid < socketMax; sid++) {
-        if ((sp = socketList[sid]) == NULL) {
+        if ((sp = socketSlot(sid))->sid < 0) {
             if (all == 0) {
                 break;
             } else {
                 continue;
             }
         }
-        assert(sp);
         /*
             Initialize the ready masks and compute the mask offsets.
          */
         index = sp->sock / (NBBY * sizeof(fd_mask));
-        bit = 1 << (sp->sock % (NBBY * sizeof(fd_mask)));
+        bit = ((fd_mask) 1) << (sp->sock % (NBBY * sizeof(fd_mask)));
         /*
             Set the appropriate bit in the ready masks for the sp->sock.
          */
@@ -571,7 +668,7 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
             sid = 0;
         }
         for (; sid < socketMax; sid++) {
-            if ((sp = socketList[sid]) == NULL) {
+            if ((sp = socketSlot(sid))->sid < 0) {
                 if (all == 0) {
                     break;
                 } else {
@@ -579,7 +676,7 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
                 }
             }
             index = sp->sock / (NBBY * sizeof(fd_mask));
-            bit = 1 << (sp->sock % (NBBY * sizeof(fd_mask)));
+            bit = ((fd_mask) 1) << (sp->sock % (NBBY * sizeof(fd_mask)));
 
             if (sp->flags & SOCKET_RESERVICE) {
                 if (sp->handlerMask & SOCKET_READABLE) {
@@ -599,6 +696,9 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
             if (exceptFds[index] & bit) {
                 sp->currentEvents |= SOCKET_EXCEPTION;
             }
+            if (sp->currentEvents) {
+                socketSetReady(sid);
+            }
             if (! all) {
                 break;
             }
@@ -611,16 +711,256 @@ PUBLIC int socketSelect(int sid, WebsTime timeout)
 }
 #endif /* WINDOWS || CE */
 
+#if BIT_GOAHEAD_IO_URING
+/*
+    Create the io_uring instance and map the submission and completion queues. Requires a kernel that supports
+    IORING_FEAT_EXT_ARG (5.11) so that waiting for completions can specify a timeout without a timeout request.
+ */
+static int ringOpen()
+{
+    struct io_uring_params  params;
+    char                    *sq, *cq;
+    int                     fd;
 
-PUBLIC void socketProcess()
+    memset(&params, 0, sizeof(params));
+    if ((fd = (int) syscall(__NR_io_uring_setup, RING_ENTRIES, &params)) < 0) {
+        return -1;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        close(fd);
+        return -1;
+    }
+    ring.fd = fd;
+    ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint);
+    ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring.sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring.sqRing = mmap(0, ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring.cqRing = mmap(0, ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring.sqes = mmap(0, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring.sqRing == MAP_FAILED || ring.cqRing == MAP_FAILED || ring.sqes == MAP_FAILED) {
+        ringClose();
+        return -1;
+    }
+    sq = ring.sqRing;
+    cq = ring.cqRing;
+    ring.sqHead = (uint*) (sq + params.sq_off.head);
+    ring.sqTail = (uint*) (sq + params.sq_off.tail);
+    ring.sqMask = (uint*) (sq + params.sq_off.ring_mask);
+    ring.sqArray = (uint*) (sq + params.sq_off.array);
+    ring.cqHead = (uint*) (cq + params.cq_off.head);
+    ring.cqTail = (uint*) (cq + params.cq_off.tail);
+    ring.cqMask = (uint*) (cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    ring.queued = 0;
+    trace(2, "Using io_uring for socket events");
+    return 0;
+}
+
+
+static void ringClose()
 {
-    WebsSocket    *sp;
-    int         sid;
+    if (ring.sqRing && ring.sqRing != MAP_FAILED) {
+        munmap(ring.sqRing, ring.sqRingSize);
+    }
+    if (ring.cqRing && ring.cqRing != MAP_FAILED) {
+        munmap(ring.cqRing, ring.cqRingSize);
+    }
+    if (ring.sqes && ring.sqes != MAP_FAILED) {
+        munmap(ring.sqes, ring.sqesSize);
+    }
+    if (ring.fd >= 0) {
+        close(ring.fd);
+    }
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+}
+
+
+/*
+    Submit queued requests and optionally wait for at least one completion or the timeout (msec).
+ */
+static int ringEnter(int wait, WebsTime timeout)
+{
+    struct io_uring_getevents_arg   arg;
+    struct __kernel_timespec        ts;
+    uint                            flags;
+    int                             rc;
+
+    flags = 0;
+    memset(&arg, 0, sizeof(arg));
+    if (wait) {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        arg.ts = (uint64) (size_t) &ts;
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    }
+    do {
+        rc = (int) syscall(__NR_io_uring_enter, ring.fd, ring.queued, wait ? 1 : 0, flags, &arg, sizeof(arg));
+    } while (rc < 0 && errno == EINTR);
+    if (rc >= 0) {
+        ring.queued -= min((uint) rc, ring.queued);
+    } else if (errno == ETIME) {
+        ring.queued = 0;
+        rc = 0;
+    }
+    return rc;
+}
+
+
+static struct io_uring_sqe *ringGetEntry()
+{
+    struct io_uring_sqe     *sqe;
+    uint                    tail, index;
+
+    tail = *ring.sqTail;
+    if ((tail - __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE)) > *ring.sqMask) {
+        /* Submission queue is full */
+        if (ringEnter(0, 0) < 0) {
+            return 0;
+        }
+    }
+    index = tail & *ring.sqMask;
+    sqe = &ring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring.sqArray[index] = index;
+    __atomic_store_n(ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+    ring.queued++;
+    return sqe;
+}
+
 
+/*
+    Change the poll events armed for a socket. A mask of zero removes any armed poll.
+ */
+static void ringArm(WebsSocket *sp, int mask)
+{
+    struct io_uring_sqe     *sqe;
+
+    if (ring.fd < 0 || mask == sp->ringMask) {
+        return;
+    }
+    if (sp->ringMask) {
+        if ((sqe = ringGetEntry()) != 0) {
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = ((uint64) sp->ringSeq << 32) | (uint) sp->sid;
+            sqe->user_data = RING_IGNORE;
+        }
+        sp->ringMask = 0;
+        if (mask == 0) {
+            /* Submit now as the socket is about to be closed */
+            ringEnter(0, 0);
+        }
+    }
+    if (mask && sp->sock >= 0) {
+        if ((sqe = ringGetEntry()) != 0) {
+            sp->ringSeq = ++ring.seq;
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = sp->sock;
+            sqe->poll32_events = ((mask & SOCKET_READABLE) ? POLLIN : 0) | ((mask & SOCKET_WRITABLE) ? POLLOUT : 0) |
+                ((mask & SOCKET_EXCEPTION) ? POLLPRI : 0);
+            sqe->user_data = ((uint64) sp->ringSeq << 32) | (uint) sp->sid;
+            sp->ringMask = mask;
+        }
+    }
+}
+
+
+/*
+    Equivalent of socketSelect for all sockets. Arm polls for sockets whose interest has changed, submit and wait in a
+    single system call, then harvest the completions into sp->currentEvents.
+ */
+static int ringSelect(WebsTime timeout)
+{
+    WebsSocket          *sp;
+    struct io_uring_cqe *cqe;
+    uint                head, tail, seq;
+    int                 sid, nEvents, mask, events;
+
+    nEvents = 0;
     for (sid = 0; sid < socketMax; sid++) {
-        if ((sp = socketList[sid]) != NULL) {
-            if (sp->currentEvents & sp->handlerMask) {
-                socketDoEvent(sp);
+        if ((sp = socketSlot(sid))->sid < 0) {
+            continue;
+        }
+        mask = sp->handlerMask & (SOCKET_READABLE | SOCKET_WRITABLE | SOCKET_EXCEPTION);
+        ringArm(sp, mask);
+        if (sp->flags & SOCKET_RESERVICE) {
+            if (sp->handlerMask & SOCKET_READABLE) {
+                sp->currentEvents |= SOCKET_READABLE;
+            }
+            if (sp->handlerMask & SOCKET_WRITABLE) {
+                sp->currentEvents |= SOCKET_WRITABLE;
+            }
+            sp->flags &= ~SOCKET_RESERVICE;
+            socketSetReady(sid);
+            nEvents++;
+        }
+    }
+    /*
+        Check for prior completions before blocking
+     */
+    if (ringEnter(nEvents == 0 && *ring.cqHead == __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE), timeout) < 0) {
+        return -1;
+    }
+    head = *ring.cqHead;
+    tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        cqe = &ring.cqes[head & *ring.cqMask];
+        if (cqe->user_data == RING_IGNORE) {
+            continue;
+        }
+        sid = (int) (cqe->user_data & 0xFFFFFFFF);
+        seq = (uint) (cqe->user_data >> 32);
+        if (sid >= socketMax || (sp = socketSlot(sid))->sid < 0 || sp->ringSeq != seq || sp->ringMask == 0) {
+            /* Stale completion for a socket that has since been freed or re-armed */
+            continue;
+        }
+        /* Polls are single-shot. The socket is re-armed on the next select if it still has interest */
+        sp->ringMask = 0;
+        if (cqe->res < 0) {
+            continue;
+        }
+        events = cqe->res;
+        if (events & (POLLIN | POLLHUP | POLLERR)) {
+            sp->currentEvents |= SOCKET_READABLE;
+        }
+        if (events & (POLLOUT | POLLHUP | POLLERR)) {
+            sp->currentEvents |= SOCKET_WRITABLE;
+        }
+        if (events & POLLPRI) {
+            sp->currentEvents |= SOCKET_EXCEPTION;
+        }
+        socketSetReady(sid);
+        nEvents++;
+    }
+    __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    return nEvents;
+}
+#endif /* BIT_GOAHEAD_IO_URING */
+
+
+/*
+    Invoke handlers for sockets marked ready by socketSelect. Handlers may allocate sockets and grow the slabs, so the
+    bitmap is re-read for each slab.
+ */
+PUBLIC void socketProcess()
+{
+    WebsSocket  *sp;
+    uint64      ready;
+    int         slab, sid;
+
+    for (slab = 0; slab < socketSlabCount; slab++) {
+        if ((ready = socketReady[slab]) == 0) {
+            continue;
+        }
+        socketReady[slab] = 0;
+        for (sid = slab * SOCKET_SLAB; ready; sid++, ready >>= 1) {
+            if (ready & 1) {
+                sp = socketSlot(sid);
+                if (sp->sid >= 0 && (sp->currentEvents & sp->handlerMask)) {
+                    socketDoEvent(sp);
+                }
             }
         }
     }
@@ -648,9 +988,10 @@ static void socketDoEvent(WebsSocket *sp)
     if (sp->handler && (sp->handlerMask & sp->currentEvents)) {
         (sp->handler)(sid, sp->handlerMask & sp->currentEvents, sp->handler_data);
         /*
-            Make sure socket pointer is still valid, then reset the currentEvents.
+            Make sure the socket was not freed by the handler, then reset the currentEvents. Slots are not moved so
+            sp is still addressable.
          */ 
-        if (socketList && sid < socketMax && socketList[sid] == sp) {
+        if (sp->sid == sid) {
             sp->currentEvents = 0;
         }
     }
@@ -774,7 +1115,8 @@ PUBLIC ssize socketWrite(int sid, void *buf, ssize bufsize)
     len = bufsize;
     sofar = 0;
     while (len > 0) {
-        if ((written = send(sp->sock, (char*) buf + sofar, (int) len, 0)) < 0) {
+        /* send() takes an int length on some platforms. Clamp rather than truncate. */
+        if ((written = send(sp->sock, (char*) buf + sofar, (int) min(len, MAXINT), 0)) < 0) {
             errCode = socketGetError();
             if (errCode == EINTR) {
                 continue;
@@ -810,7 +1152,7 @@ PUBLIC ssize socketRead(int sid, void *buf, ssize bufsize)
     if (sp->flags & SOCKET_EOF) {
         return -1;
     }
-    if ((bytes = recv(sp->sock, buf, (int) bufsize, 0)) < 0) {
+    if ((bytes = recv(sp->sock, buf, (int) min(bufsize, MAXINT), 0)) < 0) {
         errCode = socketGetError();
         if (errCode == EAGAIN || errCode == EWOULDBLOCK) {
             bytes = 0;
@@ -887,13 +1229,22 @@ PUBLIC void socketDeleteHandler(int sid)
  */
 PUBLIC int socketAlloc(char *ip, int port, SocketAccept accept, int flags)
 {
-    WebsSocket    *sp;
+    WebsSocket  *sp;
     int         sid;
 
-    if ((sid = wallocObject(&socketList, &socketMax, sizeof(WebsSocket))) < 0) {
+    if ((sid = wallocHandle(&socketList)) < 0) {
         return -1;
     }
-    sp = socketList[sid];
+    if (sid >= socketSlabCount * SOCKET_SLAB && growSlabs(sid) < 0) {
+        wfreeHandle(&socketList, sid);
+        return -1;
+    }
+    if (sid >= socketMax) {
+        socketMax = sid + 1;
+    }
+    sp = socketSlot(sid);
+    memset(sp, 0, sizeof(WebsSocket));
+    socketList[sid] = sp;
     sp->sid = sid;
     sp->accept = accept;
     sp->port = port;
@@ -913,6 +1264,7 @@ PUBLIC int socketAlloc(char *ip, int port, SocketAccept accept, int flags)
 PUBLIC void socketFree(int sid)
 {
     WebsSocket  *sp;
+    Socket      sock;
     char        buf[256];
     int         i;
 
@@ -926,7 +1278,13 @@ PUBLIC void socketFree(int sid)
         other end causing problems.
      */
     socketRegisterInterest(sid, 0);
-    if (sp->sock >= 0) {
+#if BIT_GOAHEAD_IO_URING
+    /*
+        The ring holds a reference to the socket while a poll is armed, so the poll must be removed before closing
+     */
+    ringArm(sp, 0);
+#endif
+    if (sp->sock >= 0 && !(sp->flags & SOCKET_BORROWED)) {
         socketSetBlock(sid, 0);
         while (recv(sp->sock, buf, sizeof(buf), 0) > 0) {}
         if (shutdown(sp->sock, SHUT_RDWR) >= 0) {
@@ -935,33 +1293,85 @@ PUBLIC void socketFree(int sid)
         closesocket(sp->sock);
     }
     wfree(sp->ip);
-    wfree(sp);
+    sock = sp->sock;
+    memset(sp, 0, sizeof(WebsSocket));
+    sp->sid = -1;
     socketMax = wfreeHandle(&socketList, sid);
     /*
-        Calculate the new highest socket number
+        Calculate the new highest socket number if this socket held it
      */
-    socketHighestFd = -1;
-    for (i = 0; i < socketMax; i++) {
-        if ((sp = socketList[i]) == NULL) {
-            continue;
-        } 
-        socketHighestFd = max(socketHighestFd, sp->sock);
+    if (sock >= socketHighestFd) {
+        socketHighestFd = -1;
+        for (i = 0; i < socketMax; i++) {
+            if ((sp = socketSlot(i))->sid >= 0) {
+                socketHighestFd = max(socketHighestFd, sp->sock);
+            }
+        }
     }
 }
 
 
+/*
+    Allocate slabs so that the given socket ID has a slot
+ */
+static int growSlabs(int sid)
+{
+    WebsSocket  **slabs, *slab;
+    uint64      *ready;
+    int         count, i;
+
+    count = sid / SOCKET_SLAB + 1;
+    if ((slabs = wrealloc(socketSlabs, count * sizeof(WebsSocket*))) == NULL) {
+        return -1;
+    }
+    socketSlabs = slabs;
+    if ((ready = wrealloc(socketReady, count * sizeof(uint64))) == NULL) {
+        return -1;
+    }
+    socketReady = ready;
+    while (socketSlabCount < count) {
+        if ((slab = walloc(SOCKET_SLAB * sizeof(WebsSocket))) == NULL) {
+            return -1;
+        }
+        memset(slab, 0, SOCKET_SLAB * sizeof(WebsSocket));
+        for (i = 0; i < SOCKET_SLAB; i++) {
+            slab[i].sid = -1;
+        }
+        socketReady[socketSlabCount] = 0;
+        socketSlabs[socketSlabCount++] = slab;
+    }
+    return 0;
+}
+
+
+static void freeSlabs()
+{
+    int     i;
+
+    for (i = 0; i < socketSlabCount; i++) {
+        wfree(socketSlabs[i]);
+    }
+    wfree(socketSlabs);
+    wfree(socketReady);
+    socketSlabs = NULL;
+    socketReady = NULL;
+    socketSlabCount = 0;
+}
+
+
 /*
     Return the socket object reference
  */
 WebsSocket *socketPtr(int sid)
 {
-    if (sid < 0 || sid >= socketMax || socketList[sid] == NULL) {
+    WebsSocket  *sp;
+
+    if (sid < 0 || sid >= socketMax || (sp = socketSlot(sid))->sid != sid) {
         assert(NULL);
         errno = EBADF;
         return NULL;
     }
-    assert(socketList[sid]);
-    return socketList[sid];
+    return sp;
 }
 
 
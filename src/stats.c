@@ -0,0 +1,270 @@
+/*
+    stats.c -- Server statistics published via shared memory
+
+    The server updates counters in websStats as it runs. When a statistics file is opened via websOpenStats, the
+    counters are copied into the memory mapped file after each pass of the event loop. Monitoring programs map the
+    same file and read the counters via websReadStats. Reading the counters costs the server nothing and continues to
+    work while the event loop is stalled, in which case the "updated" time stops advancing.
+
+    Updates are protected by a sequence lock. The server makes the sequence odd before changing the counters and
+    even afterwards. Readers retry if the sequence was odd or changed while they copied the counters.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/*********************************** Includes *********************************/
+
+#include    "goahead.h"
+
+#if BIT_GOAHEAD_STATS && !BIT_GOAHEAD_REPLACE_MALLOC
+#if __GLIBC__
+    #include    <malloc.h>
+#elif MACOSX
+    #include    <malloc/malloc.h>
+#endif
+#endif
+
+#if BIT_GOAHEAD_STATS
+/*********************************** Defines **********************************/
+
+#define STATS_RETRIES   1000                /* Read attempts before giving up on an update in progress */
+#define STATS_PERIOD    1000                /* Update period in msec while the server is idle */
+
+#if __GNUC__
+    #define statsBarrier() __sync_synchronize()
+#else
+    #define statsBarrier()
+#endif
+
+/************************************ Locals **********************************/
+
+PUBLIC WebsStats    websStats;
+
+#if BIT_UNIX_LIKE
+static WebsStats    *statsMap;              /* Memory mapped statistics file */
+static char         *statsPath;             /* Statistics file path */
+static int64        loopStart;              /* Time the current event loop pass started */
+static int64        lagSecond;              /* Second of the current loop lag period */
+static int64        lagMax;                 /* Longest loop pass in the current second */
+static int          statsEvent = -1;        /* Idle update event */
+
+/********************************** Forwards **********************************/
+
+static int64 getTicks();
+static void sampleMemory();
+static void statsTick(void *data, int id);
+
+/************************************* Code ***********************************/
+
+PUBLIC int websOpenStats(char *path)
+{
+    WebsStats   *map;
+    int         fd;
+
+    assert(path && *path);
+
+    websCloseStats();
+    if ((fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+        error("Can't open statistics file %s, errno %d", path, errno);
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(WebsStats)) < 0) {
+        error("Can't size statistics file %s, errno %d", path, errno);
+        close(fd);
+        return -1;
+    }
+    map = mmap(0, sizeof(WebsStats), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        error("Can't map statistics file %s, errno %d", path, errno);
+        return -1;
+    }
+    websStats.magic = WEBS_STATS_MAGIC;
+    websStats.version = WEBS_STATS_VERSION;
+    websStats.size = sizeof(WebsStats);
+    websStats.seq = 0;
+    websStats.pid = getpid();
+    websStats.started = time(0);
+    websStats.updated = getTicks();
+    sampleMemory();
+    memcpy(map, &websStats, sizeof(WebsStats));
+    statsMap = map;
+    statsPath = sclone(path);
+    statsEvent = websStartEvent(STATS_PERIOD, statsTick, 0);
+    return 0;
+}
+
+
+PUBLIC void websCloseStats()
+{
+    if (statsEvent >= 0) {
+        websStopEvent(statsEvent);
+        statsEvent = -1;
+    }
+    if (statsMap) {
+        munmap(statsMap, sizeof(WebsStats));
+        statsMap = 0;
+    }
+    if (statsPath) {
+        unlink(statsPath);
+        wfree(statsPath);
+        statsPath = 0;
+    }
+}
+
+
+PUBLIC void websStatsLoopStart()
+{
+    if (statsMap) {
+        loopStart = getTicks();
+    }
+}
+
+
+/*
+    Measure the event loop pass and publish the counters
+ */
+PUBLIC void websStatsLoopEnd()
+{
+    WebsStats   *map;
+    int64       now, lag;
+
+    if ((map = statsMap) == 0) {
+        return;
+    }
+    now = getTicks();
+    if (loopStart) {
+        lag = now - loopStart;
+        loopStart = 0;
+        if ((now / 1000) != lagSecond) {
+            lagSecond = now / 1000;
+            lagMax = 0;
+            sampleMemory();
+        }
+        lagMax = max(lagMax, lag);
+        websStats.loopLag = lagMax;
+        websStats.maxLoopLag = max(websStats.maxLoopLag, lag);
+    }
+    websStats.updated = now;
+
+    map->seq++;
+    statsBarrier();
+    /* The header fields including the sequence are not copied */
+    memcpy(&map->pid, &websStats.pid, sizeof(WebsStats) - ((char*) &websStats.pid - (char*) &websStats));
+    statsBarrier();
+    map->seq++;
+}
+
+
+PUBLIC int websReadStats(char *path, WebsStats *stats)
+{
+    volatile WebsStats  *map;
+    uint                seq;
+    int                 fd, i, rc;
+
+    assert(path);
+    assert(stats);
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return -1;
+    }
+    map = mmap(0, sizeof(WebsStats), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    rc = -1;
+    if (map->magic == WEBS_STATS_MAGIC && map->version == WEBS_STATS_VERSION && map->size == sizeof(WebsStats)) {
+        for (i = 0; i < STATS_RETRIES; i++) {
+            seq = map->seq;
+            statsBarrier();
+            memcpy(stats, (void*) map, sizeof(WebsStats));
+            statsBarrier();
+            if (!(seq & 1) && seq == map->seq) {
+                rc = 0;
+                break;
+            }
+        }
+    }
+    munmap((void*) map, sizeof(WebsStats));
+    return rc;
+}
+
+
+/*
+    Wake the event loop periodically so an idle server is not reported as stalled
+ */
+static void statsTick(void *data, int id)
+{
+    websRestartEvent(id, STATS_PERIOD);
+}
+
+
+/*
+    Without replaceMalloc, walloc is the system malloc and does not count. Sample the system allocator instead.
+    This walks the allocator arenas, so it is only done once per second. The counts are not available and are -1.
+ */
+static void sampleMemory()
+{
+#if !BIT_GOAHEAD_REPLACE_MALLOC
+#if __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2    info = mallinfo2();
+#else
+    struct mallinfo     info = mallinfo();
+#endif
+    websStats.allocMemory = (int64) info.uordblks + (int64) info.hblkhd;
+#elif MACOSX
+    websStats.allocMemory = (int64) mstats().bytes_used;
+#else
+    websStats.allocMemory = -1;
+#endif
+    websStats.allocCount = -1;
+    websStats.allocFailures = -1;
+#endif
+}
+
+
+/*
+    Return the time in milliseconds since 1970
+ */
+static int64 getTicks()
+{
+    struct timeval  tv;
+
+    gettimeofday(&tv, 0);
+    return (int64) tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+#else /* !BIT_UNIX_LIKE */
+
+PUBLIC int websOpenStats(char *path)
+{
+    error("Statistics files are only supported on Unix");
+    return -1;
+}
+
+PUBLIC void websCloseStats() { }
+PUBLIC void websStatsLoopStart() { }
+PUBLIC void websStatsLoopEnd() { }
+PUBLIC int websReadStats(char *path, WebsStats *stats) { return -1; }
+
+#endif /* BIT_UNIX_LIKE */
+#endif /* BIT_GOAHEAD_STATS */
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+ */
@@ -47,16 +47,26 @@ static bool uploadHandler(Webs *wp)
 
 static int initUpload(Webs *wp)
 {
-    char    *boundary;
+    WebsUploadState *upload;
+    char            *boundary;
     
-    if (wp->uploadState == 0) {
-        wp->uploadState = UPLOAD_BOUNDARY;
+    if ((upload = wp->upload) == 0) {
+        if ((upload = walloc(sizeof(WebsUploadState))) == 0) {
+            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't allocate upload state");
+            return -1;
+        }
+        memset(upload, 0, sizeof(WebsUploadState));
+        upload->upfd = -1;
+        wp->upload = upload;
+    }
+    if (upload->uploadState == 0) {
+        upload->uploadState = UPLOAD_BOUNDARY;
         if ((boundary = strstr(wp->contentType, "boundary=")) != 0) {
             boundary += 9;
-            wp->boundary = sfmt("--%s", boundary);
-            wp->boundaryLen = strlen(wp->boundary);
+            upload->boundary = sfmt("--%s", boundary);
+            upload->boundaryLen = strlen(upload->boundary);
         }
-        if (wp->boundaryLen == 0 || *wp->boundary == '\0') {
+        if (upload->boundaryLen == 0 || *upload->boundary == '\0') {
             websError(wp, HTTP_CODE_BAD_REQUEST, "Bad boundary");
             return -1;
         }
@@ -81,36 +91,52 @@ static void freeUploadFile(WebsUpload *up)
 
 PUBLIC void websFreeUpload(Webs *wp)
 {
-    WebsUpload  *up;
-    WebsKey     *s;
-
-    for (s = hashFirst(wp->files); s; s = hashNext(wp->files, s)) {
-        up = s->content.value.symbol;
-        freeUploadFile(up);
-        if (up == wp->currentFile) {
-            wp->currentFile = 0;
+    WebsUploadState *upload;
+    WebsUpload      *up;
+    WebsKey         *s;
+
+    if ((upload = wp->upload) == 0) {
+        return;
+    }
+    if (wp->files) {
+        for (s = hashFirst(wp->files); s; s = hashNext(wp->files, s)) {
+            up = s->content.value.symbol;
+            freeUploadFile(up);
+            if (up == upload->currentFile) {
+                upload->currentFile = 0;
+            }
         }
+        hashFree(wp->files);
+        wp->files = 0;
     }
-    hashFree(wp->files);
-    if (wp->currentFile) {
-        freeUploadFile(wp->currentFile);
-        wp->currentFile = 0;
+    if (upload->currentFile) {
+        freeUploadFile(upload->currentFile);
     }
-    if (wp->upfd >= 0) {
-        close(wp->upfd);
-        wp->upfd = -1;
+    if (upload->upfd >= 0) {
+        close(upload->upfd);
     }
+    wfree(upload->boundary);
+    wfree(upload->clientFilename);
+    wfree(upload->uploadTmp);
+    wfree(upload->uploadVar);
+    wfree(upload);
+    wp->upload = 0;
 }
 
 
 PUBLIC int websProcessUploadData(Webs *wp) 
 {
-    char    *line, *nextTok;
-    ssize   len, nbytes;
-    int     done, rc;
+    WebsUploadState *upload;
+    char            *line, *nextTok;
+    ssize           len, nbytes;
+    int             done, rc;
     
+    if (wp->upload == 0 && initUpload(wp) < 0) {
+        return -1;
+    }
+    upload = wp->upload;
     for (done = 0, line = 0; !done; ) {
-        if  (wp->uploadState == UPLOAD_BOUNDARY || wp->uploadState == UPLOAD_CONTENT_HEADER) {
+        if  (upload->uploadState == UPLOAD_BOUNDARY || upload->uploadState == UPLOAD_CONTENT_HEADER) {
             /*
                 Parse the next input line
              */
@@ -128,7 +154,7 @@ PUBLIC int websProcessUploadData(Webs *wp)
                 line[len - 1] = '\0';
             }
         }
-        switch (wp->uploadState) {
+        switch (upload->uploadState) {
         case 0:
             if (initUpload(wp) < 0) {
                 done++;
@@ -151,7 +177,7 @@ PUBLIC int websProcessUploadData(Webs *wp)
             if ((rc = processContentData(wp)) < 0) {
                 done++;
             }
-            if (bufLen(&wp->input) < wp->boundaryLen) {
+            if (bufLen(&wp->input) < upload->boundaryLen) {
                 /*  Incomplete boundary - return to get more data */
                 done++;
             }
@@ -172,17 +198,21 @@ PUBLIC int websProcessUploadData(Webs *wp)
 
 static int processContentBoundary(Webs *wp, char *line)
 {
+    WebsUploadState *upload;
+
+    upload = wp->upload;
+
     /*
         Expecting a multipart boundary string
      */
-    if (strncmp(wp->boundary, line, wp->boundaryLen) != 0) {
+    if (strncmp(upload->boundary, line, upload->boundaryLen) != 0) {
         websError(wp, HTTP_CODE_BAD_REQUEST, "Bad upload state. Incomplete boundary");
         return -1;
     }
-    if (line[wp->boundaryLen] && strcmp(&line[wp->boundaryLen], "--") == 0) {
-        wp->uploadState = UPLOAD_CONTENT_END;
+    if (line[upload->boundaryLen] && strcmp(&line[upload->boundaryLen], "--") == 0) {
+        upload->uploadState = UPLOAD_CONTENT_END;
     } else {
-        wp->uploadState = UPLOAD_CONTENT_HEADER;
+        upload->uploadState = UPLOAD_CONTENT_HEADER;
     }
     return 0;
 }
@@ -190,11 +220,13 @@ static int processContentBoundary(Webs *wp, char *line)
 
 static int processUploadHeader(Webs *wp, char *line)
 {
-    WebsUpload  *file;
+    WebsUploadState *upload;
+    WebsUpload      *file;
     char            *key, *headerTok, *rest, *nextPair, *value;
 
+    upload = wp->upload;
     if (line[0] == '\0') {
-        wp->uploadState = UPLOAD_CONTENT_DATA;
+        upload->uploadState = UPLOAD_CONTENT_DATA;
         return 0;
     }
     trace(7, "Header line: %s", line);
@@ -217,7 +249,7 @@ static int processUploadHeader(Webs *wp, char *line)
             ---boundary
          */
         key = rest;
-        wp->uploadVar = wp->clientFilename = 0;
+        upload->uploadVar = upload->clientFilename = 0;
         while (key && stok(key, ";\r\n", &nextPair)) {
 
             key = strim(key, " ", WEBS_TRIM_BOTH);
@@ -228,43 +260,43 @@ static int processUploadHeader(Webs *wp, char *line)
                 /* Nothing to do */
 
             } else if (scaselesscmp(key, "name") == 0) {
-                wp->uploadVar = sclone(value);
+                upload->uploadVar = sclone(value);
 
             } else if (scaselesscmp(key, "filename") == 0) {
-                if (wp->uploadVar == 0) {
+                if (upload->uploadVar == 0) {
                     websError(wp, HTTP_CODE_BAD_REQUEST, "Bad upload state. Missing name field");
                     return -1;
                 }
-                wp->clientFilename = sclone(value);
+                upload->clientFilename = sclone(value);
                 /*  
                     Create the file to hold the uploaded data
                  */
-                if ((wp->uploadTmp = websTempFile(uploadDir, "tmp")) == 0) {
+                if ((upload->uploadTmp = websTempFile(uploadDir, "tmp")) == 0) {
                     websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, 
-                        "Can't create upload temp file %s. Check upload temp dir %s", wp->uploadTmp, uploadDir);
+                        "Can't create upload temp file %s. Check upload temp dir %s", upload->uploadTmp, uploadDir);
                     return -1;
                 }
-                trace(5, "File upload of: %s stored as %s", wp->clientFilename, wp->uploadTmp);
+                trace(5, "File upload of: %s stored as %s", upload->clientFilename, upload->uploadTmp);
 
-                if ((wp->upfd = open(wp->uploadTmp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0600)) < 0) {
-                    websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't open upload temp file %s", wp->uploadTmp);
+                if ((upload->upfd = open(upload->uploadTmp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0600)) < 0) {
+                    websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't open upload temp file %s", upload->uploadTmp);
                     return -1;
                 }
                 /*  
                     Create the files[id]
                  */
-                file = wp->currentFile = walloc(sizeof(WebsUpload));
+                file = upload->currentFile = walloc(sizeof(WebsUpload));
                 memset(file, 0, sizeof(WebsUpload));
-                file->clientFilename = sclone(wp->clientFilename);
-                file->filename = sclone(wp->uploadTmp);
+                file->clientFilename = sclone(upload->clientFilename);
+                file->filename = sclone(upload->uploadTmp);
             }
             key = nextPair;
         }
 
     } else if (scaselesscmp(headerTok, "Content-Type") == 0) {
-        if (wp->clientFilename) {
-            trace(5, "Set files[%s][CONTENT_TYPE] = %s", wp->uploadVar, rest);
-            wp->currentFile->contentType = sclone(rest);
+        if (upload->clientFilename) {
+            trace(5, "Set files[%s][CONTENT_TYPE] = %s", upload->uploadVar, rest);
+            upload->currentFile->contentType = sclone(rest);
         }
     }
     return 0;
@@ -273,45 +305,50 @@ static int processUploadHeader(Webs *wp, char *line)
 
 static void defineUploadVars(Webs *wp)
 {
+    WebsUploadState *upload;
     WebsUpload      *file;
     char            key[64];
 
-    file = wp->currentFile;
-    fmt(key, sizeof(key), "FILE_CLIENT_FILENAME_%s", wp->uploadVar);
+    upload = wp->upload;
+    file = upload->currentFile;
+    fmt(key, sizeof(key), "FILE_CLIENT_FILENAME_%s", upload->uploadVar);
     websSetVar(wp, key, file->clientFilename);
 
-    fmt(key, sizeof(key), "FILE_CONTENT_TYPE_%s", wp->uploadVar);
+    fmt(key, sizeof(key), "FILE_CONTENT_TYPE_%s", upload->uploadVar);
     websSetVar(wp, key, file->contentType);
 
-    fmt(key, sizeof(key), "FILE_FILENAME_%s", wp->uploadVar);
+    fmt(key, sizeof(key), "FILE_FILENAME_%s", upload->uploadVar);
     websSetVar(wp, key, file->filename);
 
-    fmt(key, sizeof(key), "FILE_SIZE_%s", wp->uploadVar);
-    websSetVarFmt(wp, key, "%d", (int) file->size);
+    fmt(key, sizeof(key), "FILE_SIZE_%s", upload->uploadVar);
+    websSetVarFmt(wp, key, "%Ld", file->size);
 }
 
 
 static int writeToFile(Webs *wp, char *data, ssize len)
 {
+    WebsUploadState *upload;
     WebsUpload      *file;
     ssize           rc;
 
-    file = wp->currentFile;
+    upload = wp->upload;
+    file = upload->currentFile;
 
     if ((file->size + len) > BIT_GOAHEAD_LIMIT_UPLOAD) {
-        websError(wp, HTTP_CODE_REQUEST_TOO_LARGE, "Uploaded file exceeds maximum %d", (int) BIT_GOAHEAD_LIMIT_UPLOAD);
+        websError(wp, HTTP_CODE_REQUEST_TOO_LARGE, "Uploaded file exceeds maximum %Ld", (int64) BIT_GOAHEAD_LIMIT_UPLOAD);
         return -1;
     }
     if (len > 0) {
         /*  
             File upload. Write the file data.
          */
-        if ((rc = write(wp->upfd, data, (int) len)) != len) {
-            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't write to upload temp file %s, rc %d", wp->uploadTmp, rc);
+        if ((rc = write(upload->upfd, data, (int) len)) != len) {
+            websError(wp, HTTP_CODE_INTERNAL_SERVER_ERROR, "Can't write to upload temp file %s, rc %d",
+                upload->uploadTmp, rc);
             return -1;
         }
         file->size += len;
-        trace(7, "uploadFilter: Wrote %d bytes to %s", len, wp->uploadTmp);
+        trace(7, "uploadFilter: Wrote %d bytes to %s", len, upload->uploadTmp);
     }
     return 0;
 }
@@ -319,27 +356,29 @@ static int writeToFile(Webs *wp, char *data, ssize len)
 
 static int processContentData(Webs *wp)
 {
-    WebsUpload  *file;
+    WebsUploadState *upload;
+    WebsUpload      *file;
     WebsBuf         *content;
     ssize           size, nbytes;
     char            *data, *bp;
 
+    upload = wp->upload;
     content = &wp->input;
-    file = wp->currentFile;
+    file = upload->currentFile;
 
     size = bufLen(content);
-    if (size < wp->boundaryLen) {
+    if (size < upload->boundaryLen) {
         /*  Incomplete boundary. Return and get more data */
         return 0;
     }
     if ((bp = getBoundary(wp, content->servp, size)) == 0) {
-        trace(7, "uploadFilter: Got boundary filename %x", wp->clientFilename);
-        if (wp->clientFilename) {
+        trace(7, "uploadFilter: Got boundary filename %x", upload->clientFilename);
+        if (upload->clientFilename) {
             /*  
                 No signature found yet. probably more data to come. Must handle split boundaries.
              */
             data = content->servp;
-            nbytes = ((int) (content->endp - data)) - (wp->boundaryLen - 1);
+            nbytes = ((int) (content->endp - data)) - (upload->boundaryLen - 1);
             if (nbytes > 0 && writeToFile(wp, content->servp, nbytes) < 0) {
                 return -1;
             }
@@ -359,14 +398,14 @@ static int processContentData(Webs *wp)
         if (nbytes >= 2 && data[nbytes - 2] == '\r' && data[nbytes - 1] == '\n') {
             nbytes -= 2;
         }
-        if (wp->clientFilename) {
+        if (upload->clientFilename) {
             /*  
                 Write the last bit of file data and add to the list of files and define environment variables
              */
             if (writeToFile(wp, data, nbytes) < 0) {
                 return -1;
             }
-            hashEnter(wp->files, wp->uploadVar, valueSymbol(file), 0);
+            hashEnter(wp->files, upload->uploadVar, valueSymbol(file), 0);
             defineUploadVars(wp);
 
         } else {
@@ -374,23 +413,23 @@ static int processContentData(Webs *wp)
                 Normal string form data variables
              */
             data[nbytes] = '\0'; 
-            trace(5, "uploadFilter: form[%s] = %s", wp->uploadVar, data);
-            websDecodeUrl(wp->uploadVar, wp->uploadVar, -1);
+            trace(5, "uploadFilter: form[%s] = %s", upload->uploadVar, data);
+            websDecodeUrl(upload->uploadVar, upload->uploadVar, -1);
             websDecodeUrl(data, data, -1);
-            websSetVar(wp, wp->uploadVar, data);
+            websSetVar(wp, upload->uploadVar, data);
         }
     }
-    if (wp->clientFilename) {
+    if (upload->clientFilename) {
         /*  
             Now have all the data (we've seen the boundary)
          */
-        close(wp->upfd);
-        wp->upfd = -1;
-        wp->clientFilename = 0;
-        wfree(wp->uploadTmp);
-        wp->uploadTmp = 0;
+        close(upload->upfd);
+        upload->upfd = -1;
+        upload->clientFilename = 0;
+        wfree(upload->uploadTmp);
+        upload->uploadTmp = 0;
     }
-    wp->uploadState = UPLOAD_BOUNDARY;
+    upload->uploadState = UPLOAD_BOUNDARY;
     return 0;
 }
 
@@ -400,23 +439,25 @@ static int processContentData(Webs *wp)
  */ 
 static char *getBoundary(Webs *wp, char *buf, ssize bufLen)
 {
-    char    *cp, *endp;
-    char    first;
+    WebsUploadState *upload;
+    char            *cp, *endp;
+    char            first;
 
     assert(buf);
 
-    first = *wp->boundary;
+    upload = wp->upload;
+    first = *upload->boundary;
     cp = buf;
-    if (bufLen < wp->boundaryLen) {
+    if (bufLen < upload->boundaryLen) {
         return 0;
     }
-    endp = cp + (bufLen - wp->boundaryLen) + 1;
+    endp = cp + (bufLen - upload->boundaryLen) + 1;
     while (cp < endp) {
         cp = (char *) memchr(cp, first, endp - cp);
         if (!cp) {
             return 0;
         }
-        if (memcmp(cp, wp->boundary, wp->boundaryLen) == 0) {
+        if (memcmp(cp, upload->boundary, upload->boundaryLen) == 0) {
             return cp;
         }
         cp++;
@@ -0,0 +1,206 @@
+/*
+    goahead-stat.c -- Display the statistics published by a running GoAhead server
+
+    The server publishes its counters in a memory mapped file when run with "--stats file". This program maps the
+    file and reads the counters without communicating with the server, so it keeps working while the server is busy
+    or stalled. A stalled server is shown by the age of the last update.
+
+    usage: goahead-stat [--count n] [--interval seconds] [--json] [statsFile]
+ */
+
+/********************************* Includes ***********************************/
+
+#include    "goahead.h"
+
+/********************************** Locals ************************************/
+
+#define STATS_FILE      "goahead.stats"     /* Default statistics file */
+#define STATS_STALLED   2000                /* Update age in msec reported as a stalled server */
+
+/********************************* Forwards ***********************************/
+
+static int64 age(WebsStats *sp);
+static void printCounter(char *name, int64 value);
+static void printJson(WebsStats *sp);
+static void printRates(WebsStats *sp, WebsStats *prior, int interval, int header);
+static void printStats(WebsStats *sp);
+static void printUsage();
+
+/*********************************** Code *************************************/
+
+int main(int argc, char *argv[])
+{
+    WebsStats   stats, prior;
+    char        *path, *argp;
+    int         argind, count, interval, json, i;
+
+    count = 1;
+    interval = 0;
+    json = 0;
+    logSetPath("stderr:0");
+    logOpen();
+
+    for (argind = 1; argind < argc; argind++) {
+        argp = argv[argind];
+        if (*argp != '-') {
+            break;
+
+        } else if (smatch(argp, "--count") || smatch(argp, "-n")) {
+            if (++argind >= argc) {
+                printUsage();
+                exit(2);
+            }
+            count = atoi(argv[argind]);
+
+        } else if (smatch(argp, "--interval") || smatch(argp, "-i")) {
+            if (++argind >= argc) {
+                printUsage();
+                exit(2);
+            }
+            interval = atoi(argv[argind]);
+            if (count == 1) {
+                count = MAXINT;
+            }
+
+        } else if (smatch(argp, "--json") || smatch(argp, "-j")) {
+            json = 1;
+
+        } else {
+            printUsage();
+            exit(2);
+        }
+    }
+    if (argind < argc - 1) {
+        printUsage();
+        exit(2);
+    }
+    path = (argind < argc) ? argv[argind] : STATS_FILE;
+
+    for (i = 0; i < count; i++) {
+        if (i > 0) {
+            sleep(interval);
+        }
+        if (websReadStats(path, &stats) < 0) {
+            error("Can't read statistics from %s. Is the server running with --stats?", path);
+            exit(1);
+        }
+        if (json) {
+            printJson(&stats);
+        } else if (interval <= 0) {
+            printStats(&stats);
+        } else if (i > 0) {
+            printRates(&stats, &prior, interval, (i % 20) == 1);
+        }
+        fflush(stdout);
+        prior = stats;
+    }
+    return 0;
+}
+
+
+/*
+    Return the age of the last update in milliseconds
+ */
+static int64 age(WebsStats *sp)
+{
+    struct timeval  tv;
+
+    gettimeofday(&tv, 0);
+    return max((int64) tv.tv_sec * 1000 + tv.tv_usec / 1000 - sp->updated, 0);
+}
+
+
+static void printStats(WebsStats *sp)
+{
+    int64   updated;
+
+    updated = age(sp);
+    printf("Server           %lld%s\n", (long long) sp->pid,
+        (kill((pid_t) sp->pid, 0) < 0 && errno == ESRCH) ? " (not running)" : "");
+    printf("Uptime           %lld secs\n", (long long) (time(0) - sp->started));
+    printf("Updated          %lld msec ago%s\n", (long long) updated, updated > STATS_STALLED ? " (stalled)" : "");
+    printf("Requests         %lld\n", (long long) sp->requests);
+    printf("Errors           %lld\n", (long long) sp->errors);
+    printf("Bytes read       %lld\n", (long long) sp->bytesRead);
+    printf("Bytes written    %lld\n", (long long) sp->bytesWritten);
+    printf("Connections      %lld\n", (long long) sp->connections);
+    printf("Active           %lld\n", (long long) sp->activeConnections);
+    printf("Loop lag         %lld msec\n", (long long) sp->loopLag);
+    printf("Max loop lag     %lld msec\n", (long long) sp->maxLoopLag);
+    printf("Sessions         %lld\n", (long long) sp->sessions);
+    printCounter("Alloc memory", sp->allocMemory);
+    printCounter("Alloc count", sp->allocCount);
+    printCounter("Alloc failures", sp->allocFailures);
+}
+
+
+/*
+    Print a counter that may not be available in this build
+ */
+static void printCounter(char *name, int64 value)
+{
+    if (value < 0) {
+        printf("%-16s n/a\n", name);
+    } else {
+        printf("%-16s %lld\n", name, (long long) value);
+    }
+}
+
+
+/*
+    Print one line of rates per interval
+ */
+static void printRates(WebsStats *sp, WebsStats *prior, int interval, int header)
+{
+    if (header) {
+        printf("%10s %8s %10s %10s %7s %7s %8s %9s\n",
+            "req/s", "err/s", "read KB/s", "write KB/s", "active", "lag ms", "sessions", "age ms");
+    }
+    printf("%10.1f %8.1f %10.1f %10.1f %7lld %7lld %8lld %9lld\n",
+        (double) (sp->requests - prior->requests) / interval,
+        (double) (sp->errors - prior->errors) / interval,
+        (double) (sp->bytesRead - prior->bytesRead) / 1024 / interval,
+        (double) (sp->bytesWritten - prior->bytesWritten) / 1024 / interval,
+        (long long) sp->activeConnections, (long long) sp->loopLag, (long long) sp->sessions, (long long) age(sp));
+}
+
+
+static void printJson(WebsStats *sp)
+{
+    printf("{\"pid\":%lld,\"started\":%lld,\"updated\":%lld,\"age\":%lld,\"requests\":%lld,\"errors\":%lld,"
+        "\"bytesRead\":%lld,\"bytesWritten\":%lld,\"connections\":%lld,\"activeConnections\":%lld,"
+        "\"loopLag\":%lld,\"maxLoopLag\":%lld,\"sessions\":%lld,\"allocMemory\":%lld,\"allocCount\":%lld,"
+        "\"allocFailures\":%lld}\n",
+        (long long) sp->pid, (long long) sp->started, (long long) sp->updated, (long long) age(sp),
+        (long long) sp->requests, (long long) sp->errors, (long long) sp->bytesRead, (long long) sp->bytesWritten,
+        (long long) sp->connections, (long long) sp->activeConnections, (long long) sp->loopLag,
+        (long long) sp->maxLoopLag, (long long) sp->sessions, (long long) sp->allocMemory,
+        (long long) sp->allocCount, (long long) sp->allocFailures);
+}
+
+
+static void printUsage()
+{
+    error("usage: goahead-stat [options] [statsFile]\n"
+        "Options:\n"
+        "    --count n            # Number of reports to display\n"
+        "    --interval seconds   # Display rates every interval\n"
+        "    --json               # Display the counters as JSON\n");
+}
+
+/*
+    @copy   default
+
+    Copyright (c) Embedthis Software LLC, 2003-2013. All Rights Reserved.
+
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis GoAhead open source license or you may acquire
+    a commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+
+    Local variables:
+    tab-width: 4
+    c-basic-offset: 4
+    End:
+ */
@@ -1,8 +1,10 @@
 /*
     webcomp -- Compile web pages into C source
 
-    Usage: webcomp --prefix prefix filelist >webrom.c
+    Usage: webcomp [--gzip] [--jst] --prefix prefix filelist >webrom.c
     Where: 
+        --gzip also compiles a gzip compressed variant of each page
+        --jst translates Javascript templates into precompiled templates
         filelist is a file containing the pathnames of all web pages
         prefix is a path prefix to remove from all the web page pathnames
         webrom.c is the resulting C source file to compile and link.
@@ -14,9 +16,67 @@
 
 #include    "goahead.h"
 
+/*********************************** Defines **********************************/
+/*
+    Compiled document
+ */
+typedef struct RomFile {
+    char        *file;                      /* Source filename */
+    char        *path;                      /* Lookup path compiled into the index */
+    char        *mimeType;                  /* Mime type or null */
+    ssize       size;                       /* Document size */
+    ssize       gzsize;                     /* Size of the gzip variant or zero */
+    WebsTime    mtime;                      /* Document modification time */
+    int         isDir;                      /* Set if a directory */
+    int         page;                       /* Page number of the document data */
+    int         jst;                        /* Set if compiled as a Javascript template */
+} RomFile;
+
+/*
+    Javascript template segment being compiled
+ */
+typedef struct Segment {
+    char        *text;                      /* Function name. Null for literal text. */
+    ssize       offset;                     /* Offset of literal text in the page */
+    ssize       len;                        /* Length of literal text */
+    int         argc;                       /* Count of function arguments */
+    char        *argv[WEBS_MAX_JST_ARGS];   /* Function arguments */
+    int         vars;                       /* Bit mask of arguments that are variable names */
+} Segment;
+
+/*
+    Mime types for common web documents. Other types are resolved by extension at runtime.
+ */
+static char *mimeTypes[] = {
+    ".asp",     "text/html",
+    ".css",     "text/css",
+    ".gif",     "image/gif",
+    ".htm",     "text/html",
+    ".html",    "text/html",
+    ".ico",     "image/vnd.microsoft.icon",
+    ".jpg",     "image/jpeg",
+    ".js",      "application/x-javascript",
+    ".pdf",     "application/pdf",
+    ".png",     "image/png",
+    ".txt",     "text/plain",
+    ".xml",     "text/xml",
+    0,          0
+};
+
 /**************************** Forward Declarations ****************************/
 
-static int  compile(char *fileList, char *prefix);
+static int  compile(char *fileList, char *prefix, int gzip, int jst);
+static int  compileJst(RomFile *fp);
+static ssize compileGzip(RomFile *fp);
+static ssize compilePage(FILE *fp, char *name, int page);
+static void freeSegments(Segment *segments, int count);
+static int  parseArg(char **sp, Segment *seg);
+static int  parseScript(char *script, Segment *segments, int *count, int max);
+static void printBytes(uchar *buf, ssize len);
+static void printString(char *str);
+static char *getMimeType(char *path);
+static uint hashPath(char *path, uint seed);
+static int  outputHash(RomFile *files, int nFiles);
 static void usage();
 
 /*********************************** Code *************************************/
@@ -24,10 +84,11 @@ static void usage();
 int main(int argc, char* argv[])
 {
     char    *argp, *fileList, *prefix;
-    int     argind;
+    int     argind, gzip, jst;
 
     fileList = NULL;
     prefix = "";
+    gzip = jst = 0;
 
     for (argind = 1; argind < argc; argind++) {
         argp = argv[argind];
@@ -36,13 +97,17 @@ int main(int argc, char* argv[])
         } else if (strcmp(argp, "--prefix") == 0) {
             if (argind >= argc) usage();
             prefix = argv[++argind];
+        } else if (strcmp(argp, "--gzip") == 0) {
+            gzip = 1;
+        } else if (strcmp(argp, "--jst") == 0) {
+            jst = 1;
         }
     }
     if (argind >= argc) {
         usage();
     }
     fileList = argv[argind];
-    if (compile(fileList, prefix) < 0) {
+    if (compile(fileList, prefix, gzip, jst) < 0) {
         return -1;
     }
     return 0;
@@ -51,7 +116,9 @@ int main(int argc, char* argv[])
 
 static void usage()
 {
-    fprintf(stderr, "usage: webcomp [--prefix prefix] filelist >output.c\n\
+    fprintf(stderr, "usage: webcomp [--gzip] [--jst] [--prefix prefix] filelist >output.c\n\
+        --gzip also compiles a gzip compressed variant of each page when it is smaller\n\
+        --jst translates Javascript templates (*.jst) into precompiled templates\n\
         --prefix specifies is a path prefix to remove from all the web page pathnames\n\
         filelist is a file containing the pathnames of all web pages\n\
         output.c is the resulting C source file to compile and link.\n");
@@ -59,15 +126,15 @@ static void usage()
 }
 
 
-static int compile(char *fileList, char *prefix)
+static int compile(char *fileList, char *prefix, int gzip, int jst)
 {
     WebsStat        sbuf;
     WebsTime        now;
+    RomFile         *files, *fp;
     FILE            *lp;
-    char            buf[512], file[BIT_GOAHEAD_LIMIT_FILENAME], *cp, *sl;
-    uchar           *p;
+    char            file[BIT_GOAHEAD_LIMIT_FILENAME], *cp, *sl;
     ssize           len;
-    int             j, i, fd, nFile;
+    int             nFiles, maxFiles, nPages, i;
 
     if ((lp = fopen(fileList, "r")) == NULL) {
         fprintf(stderr, "Can't open file list %s\n", fileList);
@@ -82,58 +149,30 @@ static int compile(char *fileList, char *prefix)
     /*
         Open each input file and compile each web page
      */
-    nFile = 0;
+    nFiles = nPages = 0;
+    maxFiles = 64;
+    files = malloc(maxFiles * sizeof(RomFile));
     while (fgets(file, sizeof(file), lp) != NULL) {
-        if ((p = (uchar*) strchr(file, '\n')) || (p = (uchar*) strchr(file, '\r'))) {
-            *p = '\0';
+        if ((cp = strchr(file, '\n')) || (cp = strchr(file, '\r'))) {
+            *cp = '\0';
         }
         if (*file == '\0') {
             continue;
         }
-        if (stat(file, &sbuf) == 0 && sbuf.st_mode & S_IFDIR) {
-            continue;
-        } 
-        if ((fd = open(file, O_RDONLY | O_BINARY, 0644)) < 0) {
-            fprintf(stderr, "Can't open file %s\n", file);
+        if (stat(file, &sbuf) < 0) {
+            fprintf(stderr, "Can't stat file %s\n", file);
             return -1;
         }
-        fprintf(stdout, "/* %s */\n", file);
-        fprintf(stdout, "static uchar p%d[] = {\n", nFile);
-
-        while ((len = read(fd, buf, sizeof(buf))) > 0) {
-            p = (uchar*)buf;
-            for (i = 0; i < len; ) {
-                fprintf(stdout, "\t");
-                for (j = 0; p< (uchar*)(&buf[len]) && j < 16; j++, p++) {
-                    fprintf(stdout, "%4d,", *p);
-                }
-                i += j;
-                fprintf(stdout, "\n");
-            }
+        if (nFiles >= maxFiles) {
+            maxFiles *= 2;
+            files = realloc(files, maxFiles * sizeof(RomFile));
         }
-        fprintf(stdout, "\t   0\n};\n\n");
-        close(fd);
-        nFile++;
-    }
-    fclose(lp);
+        fp = &files[nFiles++];
+        memset(fp, 0, sizeof(RomFile));
+        fp->file = strdup(file);
+        fp->mtime = sbuf.st_mtime;
+        fp->isDir = (sbuf.st_mode & S_IFDIR) ? 1 : 0;
 
-    /*
-        Output the page index
-     */
-    fprintf(stdout, "WebsRomIndex websRomIndex[] = {\n");
-
-    if ((lp = fopen(fileList, "r")) == NULL) {
-        fprintf(stderr, "Can't open file list %s\n", fileList);
-        return -1;
-    }
-    nFile = 0;
-    while (fgets(file, sizeof(file), lp) != NULL) {
-        if ((p = (uchar*) strchr(file, '\n')) || (p = (uchar *) strchr(file, '\r'))) {
-            *p = '\0';
-        }
-        if (*file == '\0') {
-            continue;
-        }
         /*
             Remove the prefix and add a leading "/" when we print the path
          */
@@ -148,22 +187,542 @@ static int compile(char *fileList, char *prefix)
         if (*cp == '/') {
             cp++;
         }
+        len = strlen(cp);
+        if (len > 1 && cp[len - 1] == '/') {
+            cp[len - 1] = '\0';
+        }
+        fp->path = strdup(cp);
+        if (fp->isDir) {
+            continue;
+        }
+        fp->mimeType = getMimeType(fp->path);
+        fp->page = nPages++;
+        fprintf(stdout, "/* %s */\n", fp->file);
+        if ((fp->size = compilePage(fopen(fp->file, "rb"), "p", fp->page)) < 0) {
+            fprintf(stderr, "Can't open file %s\n", fp->file);
+            return -1;
+        }
+        if (gzip && (fp->gzsize = compileGzip(fp)) < 0) {
+            return -1;
+        }
+        if (jst && (cp = strrchr(fp->path, '.')) != 0 && strcmp(cp, ".jst") == 0) {
+            fp->jst = compileJst(fp) == 0;
+        }
+    }
+    fclose(lp);
 
-        if (stat(file, &sbuf) == 0 && sbuf.st_mode & S_IFDIR) {
-            fprintf(stdout, "\t{ \"%s\", 0, 0 },\n", cp);
+    /*
+        Output the page index
+     */
+    fprintf(stdout, "WebsRomIndex websRomIndex[] = {\n");
+    for (i = 0; i < nFiles; i++) {
+        fp = &files[i];
+        if (fp->isDir) {
+            fprintf(stdout, "\t{ \"%s\", 0, 0, 0, %ld },\n", fp->path, (long) fp->mtime);
             continue;
         }
-        fprintf(stdout, "\t{ \"%s\", p%d, %d },\n", cp, nFile, (int) sbuf.st_size);
-        nFile++;
+        fprintf(stdout, "\t{ \"%s\", p%d, %d, 0, %ld, \"\\\"%x-%lx\\\"\", ", fp->path, fp->page, (int) fp->size,
+            (long) fp->mtime, (int) fp->size, (long) fp->mtime);
+        if (fp->mimeType) {
+            fprintf(stdout, "\"%s\", ", fp->mimeType);
+        } else {
+            fprintf(stdout, "0, ");
+        }
+        if (fp->gzsize > 0) {
+            fprintf(stdout, "z%d, %d, ", fp->page, (int) fp->gzsize);
+        } else {
+            fprintf(stdout, "0, 0, ");
+        }
+        if (fp->jst) {
+            fprintf(stdout, "jst%d },\n", fp->page);
+        } else {
+            fprintf(stdout, "0 },\n");
+        }
     }
-    fclose(lp); 
     fprintf(stdout, "\t{ 0, 0, 0 }\n");
-    fprintf(stdout, "};\n");
+    fprintf(stdout, "};\n\n");
+    if (outputHash(files, nFiles) < 0) {
+        return -1;
+    }
     fprintf(stdout, "#else\n");
     fprintf(stdout, "WebsRomIndex websRomIndex[] = {\n");
     fprintf(stdout, "\t{ 0, 0, 0 }\n};\n");
     fprintf(stdout, "#endif\n");
     fflush(stdout);
+    for (i = 0; i < nFiles; i++) {
+        free(files[i].file);
+        free(files[i].path);
+    }
+    free(files);
+    return 0;
+}
+
+
+/*
+    Output the contents of a file as a C array. Closes the file and returns the number of bytes or -1.
+ */
+static ssize compilePage(FILE *fp, char *name, int page)
+{
+    uchar   buf[512];
+    ssize   len, total;
+
+    if (fp == NULL) {
+        return -1;
+    }
+    fprintf(stdout, "static uchar %s%d[] = {\n", name, page);
+    total = 0;
+    while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        printBytes(buf, len);
+        total += len;
+    }
+    fprintf(stdout, "\t   0\n};\n\n");
+    fclose(fp);
+    return total;
+}
+
+
+/*
+    Compress a page with gzip and output the compressed variant only if it is smaller. Returns the compressed size,
+    zero if the variant was not output, or -1 on errors.
+ */
+static ssize compileGzip(RomFile *fp)
+{
+    FILE    *pp;
+    uchar   *data;
+    char    cmd[BIT_GOAHEAD_LIMIT_FILENAME + 32];
+    ssize   len, size, max;
+
+    snprintf(cmd, sizeof(cmd), "gzip -9 -n -c '%s'", fp->file);
+    if ((pp = popen(cmd, "r")) == NULL) {
+        fprintf(stderr, "Can't run %s\n", cmd);
+        return -1;
+    }
+    max = 4096;
+    size = 0;
+    data = malloc(max);
+    while ((len = fread(&data[size], 1, max - size, pp)) > 0) {
+        size += len;
+        if (size == max) {
+            max *= 2;
+            data = realloc(data, max);
+        }
+    }
+    if (pclose(pp) != 0) {
+        fprintf(stderr, "Can't run %s\n", cmd);
+        free(data);
+        return -1;
+    }
+    if (size >= fp->size) {
+        free(data);
+        return 0;
+    }
+    fprintf(stdout, "/* %s gzip */\n", fp->file);
+    fprintf(stdout, "static uchar z%d[] = {\n", fp->page);
+    printBytes(data, size);
+    fprintf(stdout, "\t   0\n};\n\n");
+    free(data);
+    return size;
+}
+
+
+/*
+    Output bytes as array initializers, 16 per line
+ */
+static void printBytes(uchar *buf, ssize len)
+{
+    uchar   *p;
+    int     j;
+
+    for (p = buf; p < &buf[len]; ) {
+        fprintf(stdout, "\t");
+        for (j = 0; p < &buf[len] && j < 16; j++, p++) {
+            fprintf(stdout, "%4d,", *p);
+        }
+        fprintf(stdout, "\n");
+    }
+}
+
+
+/*
+    Translate a Javascript template into a table of segments. Literal text references the compiled page data and
+    script is reduced to function calls with literal or variable arguments. Pages using other script are left to be
+    interpreted at runtime. Returns zero if the template was compiled.
+ */
+static int compileJst(RomFile *fp)
+{
+    Segment     *segments, *seg;
+    FILE        *file;
+    char        *buf, *start, *script, *end, *cp;
+    int         count, max, i, j;
+
+    if ((file = fopen(fp->file, "rb")) == NULL) {
+        return -1;
+    }
+    buf = malloc(fp->size + 1);
+    if (fread(buf, 1, fp->size, file) != (size_t) fp->size) {
+        fclose(file);
+        free(buf);
+        return -1;
+    }
+    fclose(file);
+    buf[fp->size] = '\0';
+
+    max = 64;
+    count = 0;
+    segments = malloc(max * sizeof(Segment));
+    for (start = buf; (script = strstr(start, "<%")) != NULL; start = end + 2) {
+        if (script > start) {
+            seg = &segments[count++];
+            memset(seg, 0, sizeof(Segment));
+            seg->offset = start - buf;
+            seg->len = script - start;
+        }
+        for (script += 2; isspace((uchar) *script); script++) ;
+        if (strncasecmp(script, "language=javascript", 19) == 0) {
+            script += 19;
+        }
+        if ((end = strstr(script, "%>")) == NULL) {
+            fprintf(stderr, "webcomp: unterminated script in %s\n", fp->file);
+            freeSegments(segments, count);
+            free(buf);
+            return -1;
+        }
+        *end = '\0';
+        /* Backquoted newlines are white space */
+        for (cp = script; *cp; cp++) {
+            if (*cp == '\\' && (cp[1] == '\r' || cp[1] == '\n')) {
+                *cp = ' ';
+            }
+        }
+        if (parseScript(script, segments, &count, max - 1) < 0) {
+            fprintf(stderr, "webcomp: %s uses unsupported script and will be interpreted\n", fp->file);
+            freeSegments(segments, count);
+            free(buf);
+            return -1;
+        }
+        if (count >= max / 2) {
+            max *= 2;
+            segments = realloc(segments, max * sizeof(Segment));
+        }
+    }
+    if (*start) {
+        seg = &segments[count++];
+        memset(seg, 0, sizeof(Segment));
+        seg->offset = start - buf;
+        seg->len = strlen(start);
+    }
+
+    /*
+        Output the function arguments and then the template
+     */
+    for (i = 0; i < count; i++) {
+        seg = &segments[i];
+        if (seg->text && seg->argc > 0) {
+            fprintf(stdout, "static char *jst%dArgs%d[] = { ", fp->page, i);
+            for (j = 0; j < seg->argc; j++) {
+                printString(seg->argv[j]);
+                fprintf(stdout, ", ");
+            }
+            fprintf(stdout, "};\n");
+        }
+    }
+    fprintf(stdout, "static WebsJstSegment jst%d[] = {\n", fp->page);
+    for (i = 0; i < count; i++) {
+        seg = &segments[i];
+        if (seg->text) {
+            fprintf(stdout, "\t{ \"%s\", -1, %d, ", seg->text, seg->argc);
+            if (seg->argc > 0) {
+                fprintf(stdout, "jst%dArgs%d, %d },\n", fp->page, i, seg->vars);
+            } else {
+                fprintf(stdout, "0, 0 },\n");
+            }
+        } else {
+            fprintf(stdout, "\t{ (char*) &p%d[%d], %d },\n", fp->page, (int) seg->offset, (int) seg->len);
+        }
+    }
+    fprintf(stdout, "\t{ 0 }\n};\n\n");
+    freeSegments(segments, count);
+    free(buf);
+    return 0;
+}
+
+
+/*
+    Parse script consisting of function calls: name(arg, ...); Arguments may be string or numeric literals or
+    variable names.
+ */
+static int parseScript(char *script, Segment *segments, int *count, int max)
+{
+    Segment     *seg;
+    char        *cp, *name;
+
+    cp = script;
+    for (;;) {
+        while (isspace((uchar) *cp) || *cp == ';') {
+            cp++;
+        }
+        if (*cp == '\0') {
+            return 0;
+        }
+        if (!isalpha((uchar) *cp) && *cp != '_' && *cp != '$') {
+            return -1;
+        }
+        for (name = cp; isalnum((uchar) *cp) || *cp == '_' || *cp == '$'; cp++) ;
+        if (*count >= max) {
+            return -1;
+        }
+        seg = &segments[(*count)++];
+        memset(seg, 0, sizeof(Segment));
+        seg->text = strndup(name, cp - name);
+        while (isspace((uchar) *cp)) {
+            cp++;
+        }
+        if (*cp++ != '(') {
+            return -1;
+        }
+        while (isspace((uchar) *cp)) {
+            cp++;
+        }
+        if (*cp == ')') {
+            cp++;
+            continue;
+        }
+        for (;;) {
+            if (seg->argc >= WEBS_MAX_JST_ARGS || parseArg(&cp, seg) < 0) {
+                return -1;
+            }
+            while (isspace((uchar) *cp)) {
+                cp++;
+            }
+            if (*cp == ')') {
+                cp++;
+                break;
+            }
+            if (*cp++ != ',') {
+                return -1;
+            }
+        }
+    }
+}
+
+
+/*
+    Parse a string literal, number or variable name argument
+ */
+static int parseArg(char **sp, Segment *seg)
+{
+    char    *cp, *start, *arg, *dp, quote;
+
+    for (cp = *sp; isspace((uchar) *cp); cp++) ;
+    start = cp;
+    if (*cp == '"' || *cp == '\'') {
+        quote = *cp++;
+        arg = dp = malloc(strlen(cp) + 1);
+        for (; *cp && *cp != quote; cp++) {
+            if (*cp == '\\' && cp[1]) {
+                cp++;
+                switch (*cp) {
+                case 'n': *dp++ = '\n'; break;
+                case 'r': *dp++ = '\r'; break;
+                case 't': *dp++ = '\t'; break;
+                default: *dp++ = *cp; break;
+                }
+            } else {
+                *dp++ = *cp;
+            }
+        }
+        *dp = '\0';
+        if (*cp++ != quote) {
+            free(arg);
+            return -1;
+        }
+    } else if (isdigit((uchar) *cp) || *cp == '-') {
+        for (cp++; isalnum((uchar) *cp) || *cp == '.'; cp++) ;
+        arg = strndup(start, cp - start);
+    } else if (isalpha((uchar) *cp) || *cp == '_' || *cp == '$') {
+        for (; isalnum((uchar) *cp) || *cp == '_' || *cp == '$'; cp++) ;
+        arg = strndup(start, cp - start);
+        seg->vars |= (1 << seg->argc);
+    } else {
+        return -1;
+    }
+    seg->argv[seg->argc++] = arg;
+    *sp = cp;
+    return 0;
+}
+
+
+/*
+    Output a C string literal
+ */
+static void printString(char *str)
+{
+    uchar   *cp;
+
+    fputc('"', stdout);
+    for (cp = (uchar*) str; *cp; cp++) {
+        if (*cp == '"' || *cp == '\\') {
+            fprintf(stdout, "\\%c", *cp);
+        } else if (*cp < 0x20 || *cp >= 0x7f) {
+            fprintf(stdout, "\\%03o", *cp);
+        } else {
+            fputc(*cp, stdout);
+        }
+    }
+    fputc('"', stdout);
+}
+
+
+static void freeSegments(Segment *segments, int count)
+{
+    int     i, j;
+
+    for (i = 0; i < count; i++) {
+        free(segments[i].text);
+        for (j = 0; j < segments[i].argc; j++) {
+            free(segments[i].argv[j]);
+        }
+    }
+    free(segments);
+}
+
+
+/*
+    Output a collision free (perfect) hash of the index paths using hash and displace. Paths are first hashed into
+    buckets. Then each bucket, largest first, is assigned a seed that maps its paths to distinct free slots in the
+    table. Lookup then needs two hashes and one string comparison.
+ */
+static int outputHash(RomFile *files, int nFiles)
+{
+    short   *table;
+    ushort  *seeds;
+    uint    *slots;
+    int     *buckets, size, nBuckets, count, maxCount, seed, b, i, j, k, ok;
+
+    for (nBuckets = 1; nBuckets < nFiles / 2; nBuckets *= 2) ;
+    for (size = 16; size < nFiles * 2; size *= 2) ;
+    buckets = malloc(nFiles * sizeof(int));
+    slots = malloc(nFiles * sizeof(uint));
+    seeds = malloc(nBuckets * sizeof(ushort));
+    table = 0;
+    maxCount = 0;
+    for (i = 0; i < nFiles; i++) {
+        buckets[i] = hashPath(files[i].path, 0) & (nBuckets - 1);
+    }
+    for (b = 0; b < nBuckets; b++) {
+        for (count = 0, i = 0; i < nFiles; i++) {
+            count += (buckets[i] == b);
+        }
+        maxCount = max(maxCount, count);
+    }
+    for (;;) {
+        table = realloc(table, size * sizeof(short));
+        for (i = 0; i < size; i++) {
+            table[i] = -1;
+        }
+        memset(seeds, 0, nBuckets * sizeof(ushort));
+        ok = 1;
+        for (count = maxCount; count > 0 && ok; count--) {
+            for (b = 0; b < nBuckets && ok; b++) {
+                for (k = 0, i = 0; i < nFiles; i++) {
+                    k += (buckets[i] == b);
+                }
+                if (k != count) {
+                    continue;
+                }
+                for (seed = 1; seed < 0x10000; seed++) {
+                    for (k = 0, i = 0; i < nFiles; i++) {
+                        if (buckets[i] != b) {
+                            continue;
+                        }
+                        slots[k] = hashPath(files[i].path, seed) & (size - 1);
+                        if (table[slots[k]] >= 0) {
+                            break;
+                        }
+                        for (j = 0; j < k && slots[j] != slots[k]; j++) ;
+                        if (j < k) {
+                            break;
+                        }
+                        k++;
+                    }
+                    if (i >= nFiles) {
+                        break;
+                    }
+                }
+                if (seed >= 0x10000) {
+                    ok = 0;
+                    break;
+                }
+                seeds[b] = (ushort) seed;
+                for (k = 0, i = 0; i < nFiles; i++) {
+                    if (buckets[i] == b) {
+                        table[slots[k++]] = (short) i;
+                    }
+                }
+            }
+        }
+        if (ok) {
+            break;
+        }
+        if (size >= 0x8000) {
+            fprintf(stderr, "Can't create the ROM path hash\n");
+            free(table);
+            free(seeds);
+            free(slots);
+            free(buckets);
+            return -1;
+        }
+        size *= 2;
+    }
+    fprintf(stdout, "int websRomHashSize = %d;\n", size);
+    fprintf(stdout, "int websRomHashBuckets = %d;\n\n", nBuckets);
+    fprintf(stdout, "ushort websRomHashSeeds[] = {");
+    for (i = 0; i < nBuckets; i++) {
+        fprintf(stdout, "%s%d,", (i % 16) == 0 ? "\n\t" : " ", seeds[i]);
+    }
+    fprintf(stdout, "\n};\n\n");
+    fprintf(stdout, "short websRomHash[] = {");
+    for (i = 0; i < size; i++) {
+        fprintf(stdout, "%s%d,", (i % 16) == 0 ? "\n\t" : " ", table[i]);
+    }
+    fprintf(stdout, "\n};\n\n");
+    free(table);
+    free(seeds);
+    free(slots);
+    free(buckets);
+    return 0;
+}
+
+
+/*
+    FNV-1a hash. This must match the hash used by the ROM file system in fs.c
+ */
+static uint hashPath(char *path, uint seed)
+{
+    uint    hash;
+
+    hash = 2166136261U ^ seed;
+    while (*path) {
+        hash ^= (uchar) *path++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+static char *getMimeType(char *path)
+{
+    char    *ext;
+    int     i;
+
+    if ((ext = strrchr(path, '.')) == 0 || strchr(ext, '/')) {
+        return 0;
+    }
+    for (i = 0; mimeTypes[i]; i += 2) {
+        if (strcmp(ext, mimeTypes[i]) == 0) {
+            return mimeTypes[i + 1];
+        }
+    }
     return 0;
 }
 
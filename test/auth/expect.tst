@@ -0,0 +1,36 @@
+/*
+    expect.tst - Expect: 100-continue tests
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+//  Request bodies for accepted requests are received after the interim response
+http.setHeader("Expect", "100-continue")
+http.post(HTTP + "/action/test", "name=Peter&address=Lisbon")
+assert(http.status == 200)
+assert(http.response.contains("name: Peter, address: Lisbon"))
+http.close()
+
+if (App.config.bit_auth) {
+    //  Unauthorized requests are rejected before the body is sent
+    http.setHeader("Expect", "100-continue")
+    http.post(HTTP + "/auth/basic/basic.html", "name=Peter")
+    assert(http.status == 401)
+    //  The body is not read, so the connection is closed
+    assert(http.header("Connection") == "close")
+    http.close()
+
+    http.setHeader("Expect", "100-continue")
+    http.setCredentials("joshua", "pass1")
+    http.post(HTTP + "/auth/basic/basic.html", "name=Peter")
+    assert(http.status == 200)
+    http.close()
+}
+
+//  Unsupported expectations
+http.setHeader("Expect", "200-ok")
+http.post(HTTP + "/action/test", "name=Peter")
+assert(http.status == 417)
+http.close()
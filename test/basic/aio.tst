@@ -0,0 +1,48 @@
+/*
+    aio.tst - Documents read using the I/O thread pool. Routes under /aio use the "aio" option.
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+if (App.config.bit_aio) {
+    //  Static document
+    http.get(HTTP + "/aio/aio.txt")
+    assert(http.status == 200)
+    assert(http.response == "Read by the I/O threads\n")
+
+    http.head(HTTP + "/aio/aio.txt")
+    assert(http.status == 200)
+    assert(http.header("Content-Length") == "24")
+
+    //  Document spanning many I/O thread reads
+    let path = Path("web/aio/large.dat")
+    let file = File(path, "w")
+    for (i in 1000) {
+        file.write("%08d".format(i) + "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcde\n")
+    }
+    file.close()
+    http.get(HTTP + "/aio/large.dat")
+    assert(http.status == 200)
+    assert(http.response.length == path.size)
+    assert(http.response.startsWith("00000000"))
+    assert(http.response.endsWith("abcde\n"))
+    assert(http.response.contains("00000999"))
+    path.remove()
+
+    //  JST page
+    http.get(HTTP + "/aio/aio.jst")
+    assert(http.status == 200)
+    assert(http.response.contains("Hello ASP World"))
+
+    //  Missing documents
+    http.get(HTTP + "/aio/missing.txt")
+    assert(http.status == 404)
+    http.get(HTTP + "/aio/missing.jst")
+    assert(http.status == 404)
+    http.close()
+
+} else {
+    test.skip("Aio not enabled")
+}
@@ -0,0 +1,59 @@
+/*
+    beneath.tst - Documents opened relative to the cached documents directory descriptor
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+//  RESOLVE_BENEATH requires openat2 which was added in Linux 5.6
+function hasOpenat2(): Boolean {
+    if (Config.OS != "linux") {
+        return false
+    }
+    let version = Cmd.run("uname -r").trim().split(".")
+    let major = version[0] cast Number, minor = version[1] cast Number
+    return major > 5 || (major == 5 && minor >= 6)
+}
+
+if (App.config.bit_openat && hasOpenat2()) {
+    let dir = Path("web/beneath")
+    dir.makeDir()
+    dir.join("index.html").write("beneath")
+
+    //  Ordinary documents and index files
+    http.get(HTTP + "/index.html")
+    assert(http.status == 200)
+    http.get(HTTP + "/beneath/")
+    assert(http.status == 200)
+    assert(http.response == "beneath")
+    http.get(HTTP + "/beneath/index.html")
+    assert(http.status == 200)
+    assert(http.response == "beneath")
+
+    //  Relative symbolic link that stays inside the documents directory
+    Path("index.html").link(Path("web/beneath/inside.html"))
+    http.get(HTTP + "/beneath/inside.html")
+    assert(http.status == 200)
+    assert(http.response == "beneath")
+
+    //  Symbolic links that escape the documents directory. These refer to test/test.c.
+    Path("../../test.c").link(Path("web/beneath/escape.txt"))
+    http.get(HTTP + "/beneath/escape.txt")
+    assert(http.status == 404)
+
+    Path("../..").link(Path("web/beneath/escapeDir"))
+    http.get(HTTP + "/beneath/escapeDir/test.c")
+    assert(http.status == 404)
+
+    //  Absolute symbolic links are rejected even when they refer to a document inside the directory
+    dir.join("index.html").absolute.link(Path("web/beneath/absolute.html"))
+    http.get(HTTP + "/beneath/absolute.html")
+    assert(http.status == 404)
+
+    dir.removeAll()
+    http.close()
+
+} else {
+    test.skip("Openat2 not supported")
+}
@@ -0,0 +1,26 @@
+/*
+    cookie.tst - Request cookie parsing tests
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+//  Simple cookie
+http.setHeader("Cookie", "a=1; b=2")
+http.get(HTTP + "/action/cookieTest?name=b")
+assert(http.status == 200)
+assert(http.response.contains("Cookie: 2"))
+http.close()
+
+//  Quoted values and names that contain the requested name
+http.setHeader("Cookie", 'xa=9; a="quoted value"; ab=3')
+http.get(HTTP + "/action/cookieTest?name=a")
+assert(http.response.contains("Cookie: quoted value"))
+http.close()
+
+//  Missing cookie
+http.setHeader("Cookie", "a=1")
+http.get(HTTP + "/action/cookieTest?name=missing")
+assert(http.response.contains("Cookie: null"))
+http.close()
@@ -0,0 +1,14 @@
+/*
+    escape.tst - Escaped output from Javascript templates
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+http.get(HTTP + "/escape.jst")
+assert(http.status == 200)
+let response = http.response
+assert(response.contains("<p>a&lt;b&gt;&amp;&quot;c&#39;dx</p>"))
+assert(response.contains('var s = "q\\"b\\\\n\\t\\u003c/script>";'))
+assert(response.contains("q=a%20b%26c%2F%C3%A9~"))
+http.close()
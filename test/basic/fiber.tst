@@ -0,0 +1,42 @@
+/*
+    fiber.tst - Test actions running in fibers
+ */
+
+const HTTP: Uri = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+if (App.config.bit_fiber) {
+
+    //  Fiber waits for a timer, a pipe and the output to drain before responding
+    http.get(HTTP + "/action/fiberTest")
+    assert(http.status == 200)
+    assert(http.response.contains("Fiber pipe"))
+
+    //  Connection is reused after the fiber completes
+    http.get(HTTP + "/action/fiberTest")
+    assert(http.status == 200)
+    assert(http.response.contains("Fiber pipe"))
+    http.close()
+
+    //  Client disconnects while the fiber waits. The fiber is resumed to close its pipe and the server carries on.
+    let s = new Socket
+    s.connect(HTTP.address)
+    s.write("GET /action/fiberTest?wait=10000 HTTP/1.0\r\n\r\n")
+    App.sleep(200)
+    s.close()
+    App.sleep(200)
+    http.get(HTTP + "/action/fiberTest")
+    assert(http.status == 200)
+    assert(http.response.contains("Fiber pipe"))
+    http.close()
+
+    //  Wait times out and the fiber still responds
+    http.get(HTTP + "/action/fiberTest?wait=100")
+    assert(http.status == 200)
+    assert(http.response.contains("Fiber"))
+    http.close()
+
+} else {
+    test.skip("Fibers not enabled")
+}
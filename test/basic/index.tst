@@ -0,0 +1,38 @@
+/*
+    index.tst - Directory requests served via the index
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+let dir = Path("web/indexTest")
+
+dir.makeDir()
+dir.join("index.html").write("first")
+http.get(HTTP + "/indexTest/")
+assert(http.status == 200)
+assert(http.response == "first")
+
+//  Known index directories are re-checked after a second
+dir.removeAll()
+App.sleep(1100)
+http.get(HTTP + "/indexTest/")
+assert(http.status == 404)
+
+//  Replaced by a document
+dir.write("document")
+App.sleep(1100)
+http.get(HTTP + "/indexTest")
+assert(http.status == 200)
+assert(http.response == "document")
+dir.remove()
+
+//  Recreated
+dir.makeDir()
+dir.join("index.html").write("second")
+App.sleep(1100)
+http.get(HTTP + "/indexTest/")
+assert(http.status == 200)
+assert(http.response == "second")
+dir.removeAll()
+http.close()
@@ -0,0 +1,22 @@
+/*
+    json.tst - Streaming JSON writer
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+http.get(HTTP + "/action/jsonTest?count=3")
+assert(http.status == 200)
+assert(http.header("Content-Type") == "application/json")
+assert(http.response == '[{"id":0,"name":"item \\"0\\"","price":0,"active":false},' +
+    '{"id":1,"name":"item \\"1\\"","price":1.25,"active":true},' +
+    '{"id":2,"name":"item \\"2\\"","price":2.5,"active":false}]')
+
+//  Large chunked response
+http.get(HTTP + "/action/jsonTest?count=10000")
+assert(http.status == 200)
+let items = deserialize(http.response)
+assert(items.length == 10000)
+assert(items[9999].id == 9999)
+assert(items[9999].price == 12498.75)
+http.close()
@@ -0,0 +1,68 @@
+/*
+    jsonparse.tst - JSON request body parsing
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+//  Parsed document
+http.setHeader("Content-Type", "application/json")
+http.post(HTTP + "/action/jsonParseTest", '{"name": "caf\\u00e9", "items": [1, 2, "three"]}')
+assert(http.status == 200)
+assert(http.response.contains("name=café"))
+assert(http.response.contains("items=3"))
+assert(http.response.contains("last=three"))
+http.close()
+
+//  Large body received in many reads
+let items = []
+for (i in 10000) {
+    items.push(i)
+}
+http.setHeader("Content-Type", "application/json")
+http.post(HTTP + "/action/jsonParseTest", serialize({name: "big", items: items}))
+assert(http.status == 200)
+assert(http.response.contains("items=10000"))
+assert(http.response.contains("last=9999"))
+http.close()
+
+//  Events delivered to the action as the body is parsed
+http.setHeader("Content-Type", "application/json")
+http.post(HTTP + "/action/jsonSumTest", '[1, 2, [3, {"a": 40}]]')
+assert(http.status == 200)
+assert(http.response.contains("sum=46"))
+http.close()
+
+//  Invalid bodies
+for each (body in ['{"name":', '[1, 2,]', '{"a" 1}', '01', 'nul']) {
+    http.setHeader("Content-Type", "application/json")
+    http.post(HTTP + "/action/jsonParseTest", body)
+    assert(http.status == 400)
+    http.close()
+}
+
+//  Bodies are not parsed for other handlers
+http.setHeader("Content-Type", "application/json")
+http.post(HTTP + "/index.html", '{"name":')
+assert(http.status == 200)
+http.close()
+
+http.setHeader("Content-Type", "application/json")
+http.put(HTTP + "/tmp/jsonparse.json", '{"name": "put"}')
+assert(http.status == 201 || http.status == 204)
+http.get(HTTP + "/tmp/jsonparse.json")
+assert(http.status == 200)
+assert(http.response == '{"name": "put"}')
+http.dele(HTTP + "/tmp/jsonparse.json")
+assert(http.status == 204)
+http.close()
+
+if (App.config.bit_proxy) {
+    //  Proxied bodies are forwarded unchanged and parsed by the upstream
+    http.setHeader("Content-Type", "application/json")
+    http.post(HTTP + "/proxy/action/jsonParseTest", '{"name": "proxy", "items": [1, 2]}')
+    assert(http.status == 200)
+    assert(http.response.contains("name=proxy"))
+    assert(http.response.contains("items=2"))
+    http.close()
+}
@@ -0,0 +1,71 @@
+/*
+    keepalive.tst - Keep-alive request limit and reaping of idle connections
+ */
+
+const HTTP: Uri = App.config.uris.http || "127.0.0.1:8080"
+
+//  Defaults from main.bit
+const LIMIT_KEEP_ALIVE = 100
+const LIMIT_IDLE = 100
+
+/*
+    Issue a GET on a connection and read the complete response. Returns the response headers or null if the server
+    closed the connection.
+ */
+function get(s: Socket): String {
+    s.write("GET /index.html HTTP/1.1\r\nHost: " + HTTP.address + "\r\n\r\n")
+    let data = new ByteArray
+    while (!data.toString().contains("\r\n\r\n")) {
+        if (s.read(data, -1) == null) {
+            return null
+        }
+    }
+    let response = data.toString()
+    let headers = response.slice(0, response.indexOf("\r\n\r\n"))
+    let length = headers.match(/Content-Length: *([0-9]+)/i)[1] cast Number
+    while (data.length < headers.length + 4 + length) {
+        if (s.read(data, -1) == null) {
+            return null
+        }
+    }
+    return headers
+}
+
+function connect(): Socket {
+    let s = new Socket
+    s.connect(HTTP.address)
+    return s
+}
+
+if (Config.OS != "windows") {
+    //  The last request permitted on a connection is answered with "Connection: close"
+    let s = connect()
+    for (i in LIMIT_KEEP_ALIVE) {
+        let headers = get(s)
+        assert(headers && headers.contains("200 OK"))
+        if (i < LIMIT_KEEP_ALIVE - 1) {
+            assert(headers.contains("Connection: keep-alive"))
+        } else {
+            assert(headers.contains("Connection: close"))
+        }
+    }
+    assert(get(s) == null)
+    s.close()
+
+    //  Idle connections past the limit close the least recently used
+    let idle = []
+    for (i in LIMIT_IDLE + 1) {
+        s = connect()
+        assert(get(s).contains("200 OK"))
+        idle.push(s)
+    }
+    assert(get(idle[0]) == null)
+    assert(get(idle[1]).contains("200 OK"))
+    assert(get(idle[LIMIT_IDLE]).contains("200 OK"))
+    for each (s in idle) {
+        s.close()
+    }
+
+} else {
+    test.skip("Needs more connections than select permits on Windows")
+}
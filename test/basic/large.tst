@@ -0,0 +1,129 @@
+/*
+    large.tst - Bodies and documents larger than 2GB
+ */
+
+const HTTP: Uri = App.config.uris.http || "127.0.0.1:8080"
+const SIZE = 3221225473
+const HUGE = 4294967296 + 64 * 1024 * 1024
+const BLOCK = 1024 * 1024
+
+let http: Http = new Http
+
+//  Sparse file whose length does not fit in a signed 32 bit integer
+function sparse(path: Path, size: Number = SIZE): Path {
+    let file = File(path, "w")
+    file.position = size - 1
+    file.write("x")
+    file.close()
+    return path
+}
+
+/*
+    Send a request with a body of prefix + the sparse file + suffix. The body is only sent if the server accepts the
+    length with "100 Continue", otherwise the server must reject the length without truncating it. Returns the response.
+ */
+function transfer(method: String, uri: String, path: Path, prefix: String = "", suffix: String = "",
+        headers: String = ""): String {
+    let s = new Socket
+    s.connect(HTTP.address)
+    let length = prefix.length + SIZE + suffix.length
+    s.write(method + " " + uri + " HTTP/1.1\r\nHost: " + HTTP.address + "\r\nConnection: close\r\n" + headers +
+        "Content-Length: " + length + "\r\nExpect: 100-continue\r\n\r\n")
+    let response = new ByteArray
+    s.read(response, -1)
+    if (response.toString().contains("100 Continue")) {
+        response = new ByteArray
+        s.write(prefix)
+        let file = File(path, "r")
+        let buf = new ByteArray(BLOCK)
+        while (file.read(buf, 0, BLOCK)) {
+            s.write(buf)
+            buf.reset()
+        }
+        file.close()
+        s.write(suffix)
+    }
+    while (s.read(response, -1) != null) { }
+    s.close()
+    return response.toString()
+}
+
+let path = sparse(Path("web/large.dat"))
+
+//  Document
+http.head(HTTP + "/large.dat")
+assert(http.status == 200)
+assert(http.header("Content-Length") == SIZE.toString())
+http.close()
+
+/*
+    Document past 4GB. The body is counted as it is read rather than held in memory. A length truncated to 32 bits
+    stalls the response once only 4GB remains.
+ */
+let huge = sparse(Path("web/huge.dat"), HUGE)
+let s = new Socket
+s.connect(HTTP.address)
+s.write("GET /huge.dat HTTP/1.1\r\nHost: " + HTTP.address + "\r\nConnection: close\r\n\r\n")
+let buf = new ByteArray(BLOCK)
+let headers = null, received = 0, count
+while ((count = s.read(buf, 0, -1)) != null) {
+    if (headers == null) {
+        headers = buf.toString()
+        received = -(headers.indexOf("\r\n\r\n") + 4)
+    }
+    received += count
+    buf.reset()
+}
+s.close()
+assert(headers.contains("200 OK"))
+assert(headers.contains("Content-Length: " + HUGE))
+assert(received == HUGE)
+huge.remove()
+
+/*
+    Form bodies are held in memory and can't exceed 2GB. A length truncated to 32 bits would be accepted.
+ */
+for each (length in [SIZE, 4294967297]) {
+    let s = new Socket
+    s.connect(HTTP.address)
+    s.write("POST /action/test HTTP/1.1\r\nConnection: close\r\nContent-Length: " + length + "\r\n\r\nx")
+    let data = new ByteArray
+    while (s.read(data, -1) != null) { }
+    s.close()
+    assert(data.toString().contains("413 Request too large"))
+}
+
+//  PUT. The document is only created if the configured PUT limit permits.
+let dir = Path("web/tmp")
+dir.makeDir()
+response = transfer("PUT", "/tmp/large.dat", path)
+if (response.contains("413 Request too large")) {
+    assert(!Path("web/tmp/large.dat").exists)
+} else {
+    assert(response.contains("201 Created") || response.contains("204 No Content"))
+    //  The document is renamed into place as the connection closes
+    for (i in 50) {
+        if (Path("web/tmp/large.dat").exists) {
+            break
+        }
+        App.sleep(100)
+    }
+    assert(Path("web/tmp/large.dat").size == SIZE)
+    Path("web/tmp/large.dat").remove()
+}
+
+//  Upload. The file size is only reported if the configured upload limits permit.
+if (App.config.bit_upload) {
+    let boundary = "--large-boundary"
+    let prefix = "--" + boundary + "\r\nContent-Disposition: form-data; name=\"file\"; filename=\"large.dat\"\r\n" +
+        "Content-Type: application/octet-stream\r\n\r\n"
+    let suffix = "\r\n--" + boundary + "--\r\n"
+    response = transfer("POST", "/action/uploadTest", path, prefix, suffix,
+        "Content-Type: multipart/form-data; boundary=" + boundary + "\r\n")
+    if (!response.contains("413 Request too large")) {
+        assert(response.contains("200 OK"))
+        assert(response.contains("SIZE=" + SIZE))
+        Path("web/tmp/large.dat").remove()
+    }
+}
+path.remove()
@@ -0,0 +1,25 @@
+/*
+    missing.tst - Missing document tests
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+//  Repeated requests for a missing document are answered from the negative cache
+for (i in 3) {
+    http.get(HTTP + "/missing-document.html")
+    assert(http.status == 404)
+    assert(http.response.contains("Cannot open document for: /missing-document.html"))
+}
+http.get(HTTP + "/missing-dir/missing-document.html")
+assert(http.status == 404)
+
+//  Creating the document invalidates the cached entry
+let path = Path("web/missing-document.html")
+path.write("Found")
+App.sleep(1100)
+http.get(HTTP + "/missing-document.html")
+assert(http.status == 200)
+assert(http.response == "Found")
+path.remove()
+http.close()
@@ -17,9 +17,15 @@ http.followRedirects = true
 http.get(HTTP + "/dir")
 assert(http.status == 200)
 
-/*
-http.followRedirects = true
-http.get(HTTP + "/dir/")
-assert(http.status == 200)
-assert(http.response.contains("Hello /dir/index.html"))
-*/
+if (App.config.bit_indexRewrite) {
+    //  Directory without a trailing slash redirects to add the slash
+    http.followRedirects = false
+    http.get(HTTP + "/dir")
+    assert(http.status == 302)
+    assert(http.header("Location").endsWith("/dir/"))
+
+    //  Directory with a trailing slash is served the index without a redirect
+    http.get(HTTP + "/dir/")
+    assert(http.status == 200)
+    assert(http.response.contains("Hello /dir/index.html"))
+}
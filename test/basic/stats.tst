@@ -0,0 +1,39 @@
+/*
+    stats.tst - Statistics published via --stats and read by goahead-stat
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+if (App.config.bit_stats && Config.OS != "windows") {
+    let stat = test.bin.join("goahead-stat").portable + " --json " + test.top.join("test/test.stats").portable
+
+    function read(): Object {
+        let cmd = Cmd(stat)
+        assert(cmd.status == 0)
+        return deserialize(cmd.response)
+    }
+    let before = read()
+    assert(before.pid > 0)
+    assert(before.age < 2000)
+
+    http.get(HTTP + "/index.html")
+    assert(http.status == 200)
+    http.get(HTTP + "/unknown.html")
+    assert(http.status == 404)
+    http.close()
+
+    //  The file is updated at the end of the event loop pass after the response is written
+    App.sleep(200)
+    let after = read()
+    assert(after.pid == before.pid)
+    assert(after.requests >= before.requests + 2)
+    assert(after.errors >= before.errors + 1)
+    assert(after.bytesRead > before.bytesRead)
+    assert(after.bytesWritten > before.bytesWritten)
+    assert(after.updated >= before.updated)
+    assert(after.allocMemory != 0)
+
+} else {
+    test.skip("Stats not enabled")
+}
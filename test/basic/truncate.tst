@@ -0,0 +1,45 @@
+/*
+    truncate.tst - Documents truncated while being served from a memory mapping
+ */
+
+const HTTP: Uri = App.config.uris.http || "127.0.0.1:8080"
+const SIZE = 16 * 1024 * 1024
+
+if (App.config.bit_mmap) {
+    let path = Path("web/truncate.dat")
+    let file = File(path, "w")
+    let block = "A".times(65536)
+    for (i in SIZE / 65536) {
+        file.write(block)
+    }
+    file.close()
+
+    //  Stop reading once the response starts so the server blocks part way through the document
+    let s = new Socket
+    s.connect(HTTP.address)
+    s.write("GET /truncate.dat HTTP/1.0\r\n\r\n")
+    let response = new ByteArray
+    let count = s.read(response, -1)
+    assert(count > 0)
+    assert(response.toString().contains("200 OK"))
+
+    //  Truncate under the mapping. The response is abandoned and the connection closed.
+    path.truncate(0)
+    App.sleep(200)
+    for (let n; (n = s.read(response, -1)) != null; count += n) { }
+    assert(count < SIZE)
+    s.close()
+
+    //  The server survives and serves the truncated document afresh
+    let http: Http = new Http
+    http.get(HTTP + "/index.html")
+    assert(http.status == 200)
+    http.get(HTTP + "/truncate.dat")
+    assert(http.status == 200)
+    assert(http.header("Content-Length") == "0")
+    http.close()
+    path.remove()
+
+} else {
+    test.skip("Memory mapped documents not enabled")
+}
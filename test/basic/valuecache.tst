@@ -0,0 +1,34 @@
+/*
+    valuecache.tst - Values shared by all requests via cacheGet and cacheSet
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+let http: Http = new Http
+
+if (App.config.bit_cache) {
+    //  First request caches the value for two seconds
+    http.get(HTTP + "/cache.jst")
+    assert(http.status == 200)
+    assert(http.response.contains("Value: missing"))
+
+    http.get(HTTP + "/cache.jst")
+    assert(http.status == 200)
+    assert(http.response.contains("Value: cached"))
+
+    //  Expired
+    App.sleep(3000)
+    http.get(HTTP + "/cache.jst")
+    assert(http.status == 200)
+    assert(http.response.contains("Value: missing"))
+
+    //  Values returned by websCacheGet can be set, even when the set evicts them
+    http.get(HTTP + "/action/valueCacheTest")
+    assert(http.status == 200)
+    assert(http.response.contains("Self: self"))
+    assert(http.response.contains("Copy: same"))
+    assert(http.response.contains("Source: evicted"))
+    http.close()
+
+} else {
+    test.skip("Cache not enabled")
+}
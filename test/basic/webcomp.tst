@@ -0,0 +1,30 @@
+/*
+    webcomp.tst - Templates precompiled into ROM by webcomp --jst
+ */
+
+let webcomp = test.bin.join("webcomp").portable
+let cc = Cmd.locate("cc")
+
+if (Config.OS != "windows" && Path(webcomp).exists && cc) {
+    let list = Path("webcomp.files")
+    let output = Path("webcomp-rom.c")
+
+    //  The first page is a template so its segment tables are emitted for page zero
+    list.write("web/aio/aio.jst\nweb/index.html\n")
+    let cmd = Cmd(webcomp + " --jst --prefix / " + list)
+    assert(cmd.status == 0)
+    output.write(cmd.response)
+    assert(cmd.response.contains("WebsJstSegment jst0[]"))
+    assert(cmd.response.contains("jst0Args1[]"))
+    assert(cmd.response.contains("Hello ASP World"))
+
+    //  The generated names must not collide with anything declared by goahead.h and the system headers
+    let inc = test.bin.parent.join("inc").portable
+    cmd = Cmd(cc + " -fsyntax-only -DBIT_ROM=1 -I" + inc + " -I" + test.top.join("src").portable + " " + output)
+    assert(cmd.status == 0)
+    list.remove()
+    output.remove()
+
+} else {
+    test.skip("Webcomp not built")
+}
@@ -0,0 +1,59 @@
+/*
+    cache.tst - Test the route response cache
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+if (App.config.bit_route && App.config.bit_cache) {
+
+    //  Second request is served from the cache
+    http.get(HTTP + "/action/cacheTest")
+    assert(http.status == 200)
+    let first = http.response
+    assert(first.contains("Count"))
+    http.get(HTTP + "/action/cacheTest")
+    assert(http.status == 200)
+    assert(http.response == first)
+
+    //  Different query is a different cache item
+    http.get(HTTP + "/action/cacheTest?a=b")
+    assert(http.status == 200)
+    assert(http.response != first)
+
+    //  HEAD is served from the cached GET response
+    http.head(HTTP + "/action/cacheTest")
+    assert(http.status == 200)
+    assert(http.header("Content-Length") == first.length)
+
+    //  Responses that set cookies are not cached
+    http.get(HTTP + "/action/cacheTest?cookie=1")
+    assert(http.status == 200)
+    let uncached = http.response
+    http.get(HTTP + "/action/cacheTest?cookie=1")
+    assert(http.status == 200)
+    assert(http.response != uncached)
+
+    //  Static documents written directly to the socket are cached with their body
+    http.get(HTTP + "/caching/client.html")
+    assert(http.status == 200)
+    let doc = http.response
+    assert(doc.length > 0)
+    for (i in 2) {
+        http.get(HTTP + "/caching/client.html")
+        assert(http.status == 200)
+        assert(http.response == doc)
+        assert(http.header("Content-Length") == doc.length)
+    }
+
+    //  Refreshed after the lifespan expires
+    App.sleep(3000)
+    http.get(HTTP + "/action/cacheTest")
+    assert(http.status == 200)
+    assert(http.response != first)
+    http.close()
+
+} else {
+    test.skip("Response cache not enabled")
+}
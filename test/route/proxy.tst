@@ -0,0 +1,68 @@
+/*
+    proxy.tst - Test the reverse proxy handler
+ */
+
+const HTTP = App.config.uris.http || "127.0.0.1:8080"
+
+let http: Http = new Http
+
+if (App.config.bit_route && App.config.bit_proxy) {
+
+    //  Forwarded GET. The route prefix is replaced by the upstream path.
+    http.get(HTTP + "/proxy/index.html")
+    assert(http.status == 200)
+    assert(http.response.endsWith("</html>\n"))
+
+    //  Connection reuse to the upstream
+    http.get(HTTP + "/proxy/index.html")
+    assert(http.status == 200)
+    http.get(HTTP + "/proxy/index.html")
+    assert(http.status == 200)
+
+    //  Upstream errors are passed through
+    http.get(HTTP + "/proxy/unknown.html")
+    assert(http.status == 404)
+
+    //  Headers named by the Connection header are not forwarded in either direction
+    http.setHeader("Connection", "keep-alive, X-Hop")
+    http.setHeader("X-Hop", "secret")
+    http.setHeader("X-End", "kept")
+    http.get(HTTP + "/proxy/action/showTest")
+    assert(http.status == 200)
+    assert(http.response.contains("HTTP_X_END=kept"))
+    assert(!http.response.contains("HTTP_X_HOP"))
+    http.reset()
+
+    http.get(HTTP + "/proxy/action/connectionTest")
+    assert(http.status == 200)
+    assert(http.header("X-End") == "kept")
+    assert(http.header("X-Hop") == null)
+
+    //  Forwarded PUT body
+    http.put(HTTP + "/proxy/tmp/proxy.dat", "Hello World")
+    assert(http.status == 201 || http.status == 204)
+    http.get(HTTP + "/tmp/proxy.dat")
+    assert(http.status == 200)
+    assert(http.response == "Hello World")
+    http.dele(HTTP + "/proxy/tmp/proxy.dat")
+    assert(http.status == 204)
+
+    //  Large PUT body is streamed to the upstream
+    let data = "0123456789abcdef".times(256 * 1024)
+    http.put(HTTP + "/proxy/tmp/large.dat", data)
+    assert(http.status == 201 || http.status == 204)
+    http.get(HTTP + "/tmp/large.dat")
+    assert(http.status == 200)
+    assert(http.response.length == data.length)
+    http.dele(HTTP + "/proxy/tmp/large.dat")
+    assert(http.status == 204)
+
+    //  Forwarded form body
+    http.form(HTTP + "/proxy/action/test", {name: "Peter", address: "Nowhere"})
+    assert(http.status == 200)
+    assert(http.response.contains("name: Peter, address: Nowhere"))
+    http.close()
+
+} else {
+    test.skip("Proxy not enabled")
+}
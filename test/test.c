@@ -41,11 +41,28 @@ static int aspTest(int eid, Webs *wp, int argc, char **argv);
 static int bigTest(int eid, Webs *wp, int argc, char **argv);
 #endif
 static void actionTest(Webs *wp, char *path, char *query);
+#if BIT_GOAHEAD_CACHE
+static void cacheTest(Webs *wp, char *path, char *query);
+#endif
+static void connectionTest(Webs *wp, char *path, char *query);
+static void cookieTest(Webs *wp, char *path, char *query);
+#if BIT_GOAHEAD_FIBER
+static void fiberTest(Webs *wp);
+#endif
+static void jsonTest(Webs *wp, char *path, char *query);
+#if BIT_GOAHEAD_JSON
+static void jsonParseTest(Webs *wp, char *path, char *query);
+static void jsonSumTest(Webs *wp, char *path, char *query);
+static int jsonSumEvent(void *data, int event, char *token, ssize len);
+#endif
 static void sessionTest(Webs *wp, char *path, char *query);
 static void showTest(Webs *wp, char *path, char *query);
 #if BIT_GOAHEAD_UPLOAD
 static void uploadTest(Webs *wp, char *path, char *query);
 #endif
+#if BIT_GOAHEAD_CACHE
+static void valueCacheTest(Webs *wp, char *path, char *query);
+#endif
 #if BIT_GOAHEAD_LEGACY
 static int legacyTest(Webs *wp, char *prefix, char *dir, int flags);
 #endif
@@ -57,11 +74,12 @@ static void sigHandler(int signo);
 
 MAIN(goahead, int argc, char **argv, char **envp)
 {
-    char    *argp, *auth, *home, *documents, *endpoints, *endpoint, *route, *tok;
+    char    *argp, *auth, *home, *documents, *endpoints, *endpoint, *route, *stats, *tok;
     int     argind;
 
     route = "route.txt";
     auth = "auth.txt";
+    stats = 0;
 
     for (argind = 1; argind < argc; argind++) {
         argp = argv[argind];
@@ -95,6 +113,10 @@ MAIN(goahead, int argc, char **argv, char **envp)
         } else if (smatch(argp, "--route") || smatch(argp, "-r")) {
             route = argv[++argind];
 
+        } else if (smatch(argp, "--stats")) {
+            if (argind + 1 >= argc) usage();
+            stats = argv[++argind];
+
         } else if (smatch(argp, "--version") || smatch(argp, "-V")) {
             printf("%s: %s-%s\n", BIT_PRODUCT, BIT_VERSION, BIT_BUILD_NUMBER);
             exit(0);
@@ -144,11 +166,27 @@ MAIN(goahead, int argc, char **argv, char **envp)
     websDefineJst("bigTest", bigTest);
 #endif
     websDefineAction("test", actionTest);
+#if BIT_GOAHEAD_CACHE
+    websDefineAction("cacheTest", cacheTest);
+#endif
+    websDefineAction("connectionTest", connectionTest);
+    websDefineAction("cookieTest", cookieTest);
+#if BIT_GOAHEAD_FIBER
+    websDefineFiberAction("fiberTest", fiberTest);
+#endif
+    websDefineAction("jsonTest", jsonTest);
+#if BIT_GOAHEAD_JSON
+    websDefineAction("jsonParseTest", jsonParseTest);
+    websDefineJsonAction("jsonSumTest", jsonSumTest, jsonSumEvent);
+#endif
     websDefineAction("sessionTest", sessionTest);
     websDefineAction("showTest", showTest);
 #if BIT_GOAHEAD_UPLOAD
     websDefineAction("uploadTest", uploadTest);
 #endif
+#if BIT_GOAHEAD_CACHE
+    websDefineAction("valueCacheTest", valueCacheTest);
+#endif
 
 #if BIT_UNIX_LIKE
     /*
@@ -161,6 +199,15 @@ MAIN(goahead, int argc, char **argv, char **envp)
         }
     }
 #endif
+    if (stats) {
+#if BIT_GOAHEAD_STATS
+        if (websOpenStats(stats) < 0) {
+            return -1;
+        }
+#else
+        error("Statistics are not enabled in this build");
+#endif
+    }
     websServiceEvents(&finished);
     trace(1, "Instructed to exit\n");
     websClose();
@@ -198,6 +245,7 @@ static void usage() {
         "    --home directory       # Change to directory to run\n"
         "    --log logFile:level    # Log to file file at verbosity level\n"
         "    --route routeFile      # Route configuration file\n"
+        "    --stats statsFile      # Publish statistics for goahead-stat\n"
         "    --verbose              # Same as --log stderr:2\n"
         "    --version              # Output version information\n\n",
         BIT_TITLE, BIT_PRODUCT);
@@ -296,6 +344,179 @@ static void actionTest(Webs *wp, char *path, char *query)
 }
 
 
+#if BIT_GOAHEAD_CACHE
+/*
+    Return a new count for each request that is not served from the response cache.
+    Setting the "cookie" variable makes the response uncacheable.
+ */
+static void cacheTest(Webs *wp, char *path, char *query)
+{
+    static int  count = 0;
+
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    if (websGetVar(wp, "cookie", 0)) {
+        websWriteHeader(wp, "Set-Cookie", "cacheTest=%d; path=/", count);
+    }
+    websWriteEndHeaders(wp);
+    websWrite(wp, "<html><body><p>Count %d</p></body></html>\n", ++count);
+    websDone(wp);
+}
+#endif
+
+
+/*
+    Name a response header in the Connection header. Proxies must not forward either header.
+ */
+static void connectionTest(Webs *wp, char *path, char *query)
+{
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteHeader(wp, "Connection", "X-Hop");
+    websWriteHeader(wp, "X-Hop", "secret");
+    websWriteHeader(wp, "X-End", "kept");
+    websWriteEndHeaders(wp);
+    websWrite(wp, "<html><body>Connection test</body></html>\n");
+    websDone(wp);
+}
+
+
+/*
+    Write the value of the request cookie named by the "name" variable
+ */
+static void cookieTest(Webs *wp, char *path, char *query)
+{
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteEndHeaders(wp);
+    websWrite(wp, "Cookie: %s\n", websGetCookieValue(wp, websGetVar(wp, "name", "a")));
+    websDone(wp);
+}
+
+
+#if BIT_GOAHEAD_FIBER
+/*
+    Wait in a fiber for a timer, a pipe and the response output to drain. The "sleep" variable sets the timer delay.
+    The "wait" variable leaves the pipe empty and waits that long for it, so a client can disconnect during the wait.
+    The pipe is closed whether or not the wait succeeds.
+ */
+static void fiberTest(Webs *wp)
+{
+    char    buf[16];
+    ssize   nbytes;
+    int     fds[2], wait;
+
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteEndHeaders(wp);
+    if (websSleep(wp, atoi(websGetVar(wp, "sleep", "0"))) < 0 || pipe(fds) < 0) {
+        return;
+    }
+    nbytes = 0;
+    wait = atoi(websGetVar(wp, "wait", "0"));
+    if ((wait || write(fds[1], "pipe", 4) == 4) && websAwaitReadable(wp, fds[0], wait ? wait : 5000) == 1) {
+        nbytes = read(fds[0], buf, sizeof(buf) - 1);
+    }
+    close(fds[0]);
+    close(fds[1]);
+    buf[max(nbytes, 0)] = '\0';
+    if (websAwaitWritable(wp, -1, 0) < 0) {
+        return;
+    }
+    websWrite(wp, "<html><body><p>Fiber %s</p></body></html>\n", buf);
+    websDone(wp);
+}
+#endif
+
+
+/*
+    Write a JSON array of "count" objects with the streaming JSON writer
+ */
+static void jsonTest(Webs *wp, char *path, char *query)
+{
+    WebsJson    json;
+    char        name[32];
+    int         count, i;
+
+    count = atoi(websGetVar(wp, "count", "10"));
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteHeader(wp, "Content-Type", "application/json");
+    websWriteEndHeaders(wp);
+    websJsonOpen(&json, wp);
+    websJsonBeginArray(&json);
+    for (i = 0; i < count; i++) {
+        fmt(name, sizeof(name), "item \"%d\"", i);
+        websJsonBeginObject(&json);
+        websJsonKey(&json, "id");
+        websJsonInt(&json, i);
+        websJsonKey(&json, "name");
+        websJsonString(&json, name);
+        websJsonKey(&json, "price");
+        websJsonDouble(&json, i * 1.25);
+        websJsonKey(&json, "active");
+        websJsonBool(&json, i % 2);
+        websJsonEndObject(&json);
+    }
+    websJsonEndArray(&json);
+    websDone(wp);
+}
+
+
+#if BIT_GOAHEAD_JSON
+/*
+    Report values from a parsed JSON request body
+ */
+static void jsonParseTest(Webs *wp, char *path, char *query)
+{
+    WebsJsonNode    *items, *last;
+
+    items = websJsonGet(websGetJson(wp), "items");
+    last = items ? websJsonGetItem(items, (int) items->len - 1) : 0;
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteHeader(wp, "Content-Type", "text/plain");
+    websWriteEndHeaders(wp);
+    websWrite(wp, "name=%s\n", websGetJsonVar(wp, "name", ""));
+    websWrite(wp, "items=%d\n", items ? (int) items->len : -1);
+    websWrite(wp, "last=%s\n", (last && last->value) ? last->value : "");
+    websDone(wp);
+}
+
+
+/*
+    Sum the numbers in a JSON request body as it is received
+ */
+static int jsonSumEvent(void *data, int event, char *token, ssize len)
+{
+    Webs    *wp;
+    char    num[32];
+
+    wp = data;
+    if (event == WEBS_JSON_NUMBER) {
+        if (len >= (ssize) sizeof(num)) {
+            return -1;
+        }
+        memcpy(num, token, len);
+        num[len] = '\0';
+        websSetVarFmt(wp, "sum", "%Ld", stoi(websGetVar(wp, "sum", "0")) + stoi(num));
+    }
+    return 0;
+}
+
+
+static void jsonSumTest(Webs *wp, char *path, char *query)
+{
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteHeader(wp, "Content-Type", "text/plain");
+    websWriteEndHeaders(wp);
+    websWrite(wp, "sum=%s\n", websGetVar(wp, "sum", "0"));
+    websDone(wp);
+}
+#endif
+
+
 static void sessionTest(Webs *wp, char *path, char *query)
 {
 	char	*number;
@@ -322,6 +543,7 @@ static void showTest(Webs *wp, char *path, char *query)
     websWriteHeaders(wp, -1, 0);
     websWriteEndHeaders(wp);
     websWrite(wp, "<html><body><pre>\n");
+    websParseVars(wp);
     for (s = hashFirst(wp->vars); s; s = hashNext(wp->vars, s)) {
         websWrite(wp, "%s=%s\n", s->name.value.string, s->content.value.string);
     }
@@ -351,12 +573,13 @@ static void uploadTest(Webs *wp, char *path, char *query)
             websWrite(wp, "FILENAME=%s\r\n", up->filename);
             websWrite(wp, "CLIENT=%s\r\n", up->clientFilename);
             websWrite(wp, "TYPE=%s\r\n", up->contentType);
-            websWrite(wp, "SIZE=%d\r\n", up->size);
+            websWrite(wp, "SIZE=%Ld\r\n", up->size);
             upfile = sfmt("%s/tmp/%s", websGetDocuments(), up->clientFilename);
             rename(up->filename, upfile);
             wfree(upfile);
         }
         websWrite(wp, "\r\nVARS:\r\n");
+        websParseVars(wp);
         for (s = hashFirst(wp->vars); s; s = hashNext(wp->vars, s)) {
             websWrite(wp, "%s=%s\r\n", s->name.value.string, s->content.value.string);
         }
@@ -366,6 +589,46 @@ static void uploadTest(Webs *wp, char *path, char *query)
 #endif
 
 
+#if BIT_GOAHEAD_CACHE
+/*
+    Set cached values from values returned by websCacheGet. The source of the copy is removed or evicted by the set.
+ */
+static void valueCacheTest(Webs *wp, char *path, char *query)
+{
+    char    *value, *big;
+    ssize   len, size, i;
+
+    websSetStatus(wp, 200);
+    websWriteHeaders(wp, -1, 0);
+    websWriteHeader(wp, "Content-Type", "text/plain");
+    websWriteEndHeaders(wp);
+
+    /* Set a key to its own value */
+    websCacheSet("valueSelf", "self", -1, 0);
+    value = websCacheGet("valueSelf", &len);
+    websCacheSet("valueSelf", value, len, 0);
+    websWrite(wp, "Self: %s\n", websCacheGet("valueSelf", 0));
+    websCacheRemove("valueSelf");
+
+    /* Copy to another key. Two such values can't both fit so the source is evicted to make room. */
+    size = BIT_GOAHEAD_LIMIT_CACHE_VALUES / 2;
+    big = walloc(size);
+    for (i = 0; i < size; i++) {
+        big[i] = 'a' + (i % 26);
+    }
+    websCacheSet("valueSource", big, size, 0);
+    value = websCacheGet("valueSource", &len);
+    websCacheSet("valueEvictedCopy", value, len, 0);
+    value = websCacheGet("valueEvictedCopy", &len);
+    websWrite(wp, "Copy: %s\n", (value && len == size && memcmp(value, big, size) == 0) ? "same" : "different");
+    websWrite(wp, "Source: %s\n", websCacheGet("valueSource", 0) ? "cached" : "evicted");
+    websCacheRemove("valueEvictedCopy");
+    wfree(big);
+    websDone(wp);
+}
+#endif
+
+
 #if BIT_GOAHEAD_LEGACY
 /*
     Legacy handler with old parameter sequence